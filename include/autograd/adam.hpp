@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include "autograd/grad_mode.hpp"
+#include "ops/adam_update.hpp"
 #include "ops/in_place.hpp"
 #include "tensors/parameter.hpp"
 
@@ -26,20 +28,23 @@ struct AdamState {
 };
 
 /**
- * Adam optimizer
+ * Adam optimizer (with optional L2 or decoupled weight decay)
  */
 struct Adam {
   real1 lr;
   real1 beta1;
   real1 beta2;
   real1 eps;
+  real1 weight_decay;
+  bool decoupled;
   uint64_t t;
 
   std::unordered_map<ParameterPtr, AdamState> state;
 
   Adam(real1 l, real1 b1 = ADAM_BETA1_DEFAULT, real1 b2 = ADAM_BETA2_DEFAULT,
-       real1 e = ADAM_EPSILON_DEFAULT)
-      : lr(l), beta1(b1), beta2(b2), eps(e), t(0U) {}
+       real1 e = ADAM_EPSILON_DEFAULT, real1 wd = ZERO_R1, bool dc = false)
+      : lr(l), beta1(b1), beta2(b2), eps(e), weight_decay(wd), decoupled(dc),
+        t(0U) {}
 
   /**
    * Register a parameter with this optimizer
@@ -67,14 +72,29 @@ struct Adam {
   }
 };
 
-void adam_step(Adam &opt, const std::vector<ParameterPtr> &params) {
+/**
+ * AdamW optimizer: Adam with decoupled weight decay
+ */
+struct AdamW : public Adam {
+  AdamW(real1 l, real1 wd = ADAMW_WEIGHT_DECAY_DEFAULT,
+        real1 b1 = ADAM_BETA1_DEFAULT, real1 b2 = ADAM_BETA2_DEFAULT,
+        real1 e = ADAM_EPSILON_DEFAULT)
+      : Adam(l, b1, b2, e, wd, true) {}
+};
+
+inline void adam_step(Adam &opt, const std::vector<ParameterPtr> &params) {
   opt.t += 1;
 
   const real1 bias_correction1 =
       (real1)(ONE_R1 - std::pow((real1_s)opt.beta1, (real1_s)opt.t));
   const real1 bias_correction2 =
       (real1)(ONE_R1 - std::pow((real1_s)opt.beta2, (real1_s)opt.t));
+  const AdamCoefficients c{opt.lr,           opt.beta1,
+                           opt.beta2,        opt.eps,
+                           bias_correction1, bias_correction2,
+                           opt.weight_decay, opt.decoupled};
 
+  NoGradGuard no_grad;
   for (auto &p : params) {
     const auto it = opt.state.find(p);
     if (it == opt.state.end()) {
@@ -84,6 +104,22 @@ void adam_step(Adam &opt, const std::vector<ParameterPtr> &params) {
     AdamState &s = it->second;
     TensorPtr g = p->grad;
 
+    // Dense real parameters update p, m and v in place, in one pass.
+    if (Weed::can_adam_update(*(p.get()), *(s.m.get()), *(s.v.get()),
+                              *(g.get()))) {
+      Weed::adam_update(*(p.get()), *(s.m.get()), *(s.v.get()), *(g.get()),
+                        c);
+      continue;
+    }
+
+    TensorPtr decay = nullptr;
+    if (opt.weight_decay != ZERO_R1) {
+      decay = opt.weight_decay * std::make_shared<Tensor>(*(p.get()));
+      if (!opt.decoupled) {
+        g = g + decay;
+      }
+    }
+
     // m = beta1 * m + (1 - beta1) * g
     s.m = opt.beta1 * s.m + (ONE_R1 - opt.beta1) * g;
 
@@ -98,6 +134,9 @@ void adam_step(Adam &opt, const std::vector<ParameterPtr> &params) {
     TensorPtr tmp = opt.lr * s.m /
                     (bias_correction1 *
                      (((s.v / bias_correction2) ^ ((real1)0.5)) + opt.eps));
+    if (decay && opt.decoupled) {
+      tmp = tmp + opt.lr * decay;
+    }
 
     p->match_shape(tmp);
     tmp->match_shape(p);
@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include "ops/cross_entropy.hpp"
+#include "modules/linear.hpp"
 #include "ops/embedding.hpp"
 #include "tensors/tensor.hpp"
 
@@ -19,6 +21,11 @@ namespace Weed {
  * Cross-entropy loss (-mean(logsoftmax(logits)[range(T), targets]))
  */
 static TensorPtr cross_entropy_loss(TensorPtr logits, SymbolTensorPtr targets) {
+  // One fused pass over the logits, where supported
+  if (can_cross_entropy(*(logits.get()), *(targets.get()))) {
+    return Tensor::cross_entropy(logits, targets);
+  }
+
   // logits: [1, seq_len, vocab_size]
   const symint T = logits->shape[1];
   const symint V = logits->shape[2];
@@ -32,4 +39,24 @@ static TensorPtr cross_entropy_loss(TensorPtr logits, SymbolTensorPtr targets) {
 
   return Tensor::mean(gathered) * real1(-1.0f);
 }
+
+/**
+ * Cross-entropy loss of a Linear vocabulary head over x, computed a chunk of
+ * the vocabulary at a time, so the [seq_len, vocab_size] logits are never
+ * materialized (falls back to cross_entropy_loss(head->forward(x), targets))
+ */
+inline TensorPtr
+linear_cross_entropy_loss(const LinearPtr &head, TensorPtr x,
+                          SymbolTensorPtr targets,
+                          const tcapint &chunk = CE_VOCAB_CHUNK_DEFAULT) {
+  const TensorPtr b = head->bias;
+  if (can_linear_cross_entropy(*(x.get()), *(head->weight.get()),
+                               *(targets.get())) &&
+      (!b || ((b->storage->dtype == DType::REAL) &&
+              (b->storage->device == DeviceTag::CPU)))) {
+    return Tensor::linear_cross_entropy(x, head->weight, b, targets, chunk);
+  }
+
+  return cross_entropy_loss(head->forward(x), targets);
+}
 } // namespace Weed
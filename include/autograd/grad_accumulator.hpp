@@ -0,0 +1,57 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include "autograd/sgd.hpp"
+#include "autograd/zero_grad.hpp"
+
+namespace Weed {
+/**
+ * Gradient accumulation over micro-batches: accumulate() back-propagates
+ * each micro-batch loss into the same gradient buffers (summing), and one
+ * optimizer step then covers the whole effective batch. reset() zeros the
+ * buffers in place, so they are allocated once rather than per micro-batch.
+ */
+struct GradAccumulator {
+  std::vector<ParameterPtr> params;
+  tcapint micro_batches;
+
+  GradAccumulator(const std::vector<ParameterPtr> &p)
+      : params(p), micro_batches(0U) {}
+
+  /**
+   * Add the gradient of one micro-batch loss
+   */
+  void accumulate(const TensorPtr &loss) {
+    Tensor::backward(loss);
+    ++micro_batches;
+  }
+
+  /**
+   * SGD step on the mean gradient over accumulated micro-batches, then reset
+   */
+  void sgd_step(const real1 &lr) {
+    if (micro_batches) {
+      Weed::sgd_step(params, lr / (real1)micro_batches);
+    }
+    reset();
+  }
+
+  /**
+   * Zero the accumulated gradients (keeping their buffers)
+   */
+  void reset() {
+    zero_grad(params);
+    micro_batches = 0U;
+  }
+};
+} // namespace Weed
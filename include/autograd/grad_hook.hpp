@@ -0,0 +1,50 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include "tensors/tensor.hpp"
+
+#include <functional>
+
+namespace Weed {
+/**
+ * Thread-local autograd hook: while set, Tensor::backward() calls it with
+ * every leaf tensor (such as a Parameter) as soon as that leaf's gradient is
+ * final, so work on it (like gradient communication) can overlap the rest of
+ * back-propagation
+ */
+struct GradReadyHook {
+  typedef std::function<void(Tensor *)> Fn;
+  static const Fn &get() { return fn(); }
+  static void set(const Fn &f) { fn() = f; }
+
+private:
+  static Fn &fn() {
+    static thread_local Fn hook = nullptr;
+    return hook;
+  }
+};
+
+/**
+ * Set the gradient-ready hook on the calling thread for the lifetime of this
+ * guard
+ */
+struct GradReadyHookGuard {
+  const GradReadyHook::Fn prior;
+  GradReadyHookGuard(const GradReadyHook::Fn &f) : prior(GradReadyHook::get()) {
+    GradReadyHook::set(f);
+  }
+  ~GradReadyHookGuard() { GradReadyHook::set(prior); }
+  GradReadyHookGuard(const GradReadyHookGuard &) = delete;
+  GradReadyHookGuard &operator=(const GradReadyHookGuard &) = delete;
+};
+} // namespace Weed
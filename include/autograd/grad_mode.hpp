@@ -0,0 +1,76 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+namespace Weed {
+/**
+ * Thread-local autograd switch: while disabled, operations record no graph
+ * nodes and allocate no gradients, whatever their inputs' requires_grad
+ */
+struct GradMode {
+  static bool is_enabled() { return flag(); }
+  static void set_enabled(const bool &b) { flag() = b; }
+
+private:
+  static bool &flag() {
+    static thread_local bool enabled = true;
+    return enabled;
+  }
+};
+
+/**
+ * Disable autograd on the calling thread for the lifetime of this guard
+ */
+struct NoGradGuard {
+  const bool prior;
+  NoGradGuard() : prior(GradMode::is_enabled()) {
+    GradMode::set_enabled(false);
+  }
+  ~NoGradGuard() { GradMode::set_enabled(prior); }
+  NoGradGuard(const NoGradGuard &) = delete;
+  NoGradGuard &operator=(const NoGradGuard &) = delete;
+};
+
+/**
+ * Re-enable autograd on the calling thread for the lifetime of this guard
+ */
+struct EnableGradGuard {
+  const bool prior;
+  EnableGradGuard() : prior(GradMode::is_enabled()) {
+    GradMode::set_enabled(true);
+  }
+  ~EnableGradGuard() { GradMode::set_enabled(prior); }
+  EnableGradGuard(const EnableGradGuard &) = delete;
+  EnableGradGuard &operator=(const EnableGradGuard &) = delete;
+};
+
+/**
+ * Set autograd on or off on the calling thread for the lifetime of this guard
+ * (as to carry a caller's mode into a worker thread)
+ */
+struct GradModeGuard {
+  const bool prior;
+  GradModeGuard(const bool &b) : prior(GradMode::is_enabled()) {
+    GradMode::set_enabled(b);
+  }
+  ~GradModeGuard() { GradMode::set_enabled(prior); }
+  GradModeGuard(const GradModeGuard &) = delete;
+  GradModeGuard &operator=(const GradModeGuard &) = delete;
+};
+
+/**
+ * Inference mode for serving: persistently disable (or re-enable) autograd
+ * on the calling thread
+ */
+inline void set_inference_mode(const bool &b) { GradMode::set_enabled(!b); }
+inline bool get_inference_mode() { return !GradMode::is_enabled(); }
+} // namespace Weed
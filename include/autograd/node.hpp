@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include "autograd/grad_mode.hpp"
 #include "tensors/tensor.hpp"
 
 #include <functional>
@@ -28,14 +29,28 @@ struct Node {
    * Autograd back-propagation function
    */
   std::function<void()> backward;
+  /**
+   * Does backward() accumulate sparsely into its parents' gradients? (If so,
+   * Tensor::backward() leaves their empty placeholders sparse.)
+   */
+  bool sparse_grad;
+  /**
+   * Does backward() accumulate into its parents' gradients summed over their
+   * broadcast indices? (If so, Tensor::backward() keeps those CPU gradients
+   * at their reduced shapes.)
+   */
+  bool reduce_grad;
 
   /**
    * Used by Weed::Tensor or user code to construct an autograd graph node
+   * (dense parent gradients are only placeholders until Tensor::backward())
    */
   Node(const std::vector<TensorPtr> &p, const std::function<void()> &b)
-      : parents(p), backward(b) {
+      : parents(p), backward(b), sparse_grad(false), reduce_grad(false) {
     for (auto &t : parents) {
-      t->make_gradient();
+      if (t) {
+        t->make_gradient();
+      }
     }
   }
 };
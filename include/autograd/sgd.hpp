@@ -27,6 +27,9 @@ inline void sgd_step(const std::vector<ParameterPtr> &params, real1 lr) {
 
   for (auto &p : params) {
     TensorPtr pg = p->grad;
+    if (!pg) {
+      continue;
+    }
     TensorPtr tmp = lr * pg;
     tmp->match_shape(p);
     const DeviceTag dtag = Tensor::get_dtag_by_presidence({p, tmp});
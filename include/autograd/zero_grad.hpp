@@ -20,7 +20,9 @@ namespace Weed {
  */
 inline void zero_grad(const std::vector<ParameterPtr> &params) {
   for (auto p : params) {
-    p->grad->storage->FillZeros();
+    if (p->grad) {
+      p->grad->storage->FillZeros();
+    }
   }
 }
 } // namespace Weed
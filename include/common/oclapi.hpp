@@ -117,7 +117,8 @@ enum OCLAPI {
   OCL_API_LOGSOFTMAX = 98,
   OCL_API_LOGSOFTMAX_BACKWARD_REAL = 99,
   OCL_API_LOGSOFTMAX_BACKWARD_COMPLEX = 100,
-  OCL_API_LOGSOFTMAX_BACKWARD_MIXED = 101
+  OCL_API_LOGSOFTMAX_BACKWARD_MIXED = 101,
+  OCL_API_ADAM_UPDATE_REAL = 102
 };
 
 } // namespace Weed
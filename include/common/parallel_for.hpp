@@ -20,6 +20,10 @@ namespace Weed {
 // Called once per value between begin and end.
 typedef std::function<void(const tcapint &, const unsigned &cpu)> ParallelFunc;
 typedef std::function<tcapint(const tcapint &)> IncrementFunc;
+// Called once per contiguous block of values, [begin, end).
+typedef std::function<void(const tcapint &, const tcapint &,
+                           const unsigned &cpu)>
+    BlockFunc;
 
 class ParallelFor {
 private:
@@ -64,6 +68,13 @@ public:
    */
   void par_for(const tcapint &begin, const tcapint &end, ParallelFunc fn);
 
+  /**
+   * Call fn once per contiguous block of the values between begin and end,
+   * with one block for each core par_for() would use, so the caller's inner
+   * loop can run over raw pointers.
+   */
+  void par_for_blocks(const tcapint &begin, const tcapint &end, BlockFunc fn);
+
   /**
    * Call fn once for every value in a sparse map.
    */
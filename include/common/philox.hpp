@@ -0,0 +1,54 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace Weed {
+/**
+ * Philox4x32-10 counter-based random number generator (Salmon et al., 2011):
+ * a pure function of a 128-bit counter and a 64-bit key, so any block of
+ * the stream can be generated independently, in parallel, and regenerated
+ * on demand
+ */
+struct Philox4x32 {
+  typedef std::array<uint32_t, 4U> Block;
+
+  static Block generate(Block ctr, uint32_t k0, uint32_t k1) {
+    const uint64_t M0 = 0xD2511F53U;
+    const uint64_t M1 = 0xCD9E8D57U;
+    for (unsigned r = 0U; r < 10U; ++r) {
+      if (r) {
+        k0 += 0x9E3779B9U;
+        k1 += 0xBB67AE85U;
+      }
+      const uint64_t p0 = M0 * ctr[0U];
+      const uint64_t p1 = M1 * ctr[2U];
+      ctr = {(uint32_t)(p1 >> 32U) ^ ctr[1U] ^ k0, (uint32_t)p1,
+             (uint32_t)(p0 >> 32U) ^ ctr[3U] ^ k1, (uint32_t)p0};
+    }
+
+    return ctr;
+  }
+
+  /**
+   * Four random words at block index idx of stream stream, under key seed
+   */
+  static Block generate(const uint64_t &idx, const uint64_t &stream,
+                        const uint64_t &seed) {
+    return generate(Block{(uint32_t)idx, (uint32_t)(idx >> 32U),
+                          (uint32_t)stream, (uint32_t)(stream >> 32U)},
+                    (uint32_t)seed, (uint32_t)(seed >> 32U));
+  }
+};
+} // namespace Weed
@@ -0,0 +1,64 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2017-2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include "weed_types.hpp"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Weed {
+/**
+ * Ring all-reduce (sum) of real buffers among the worker processes on one
+ * machine, over Unix domain sockets: each rank listens at "<prefix>.<rank>"
+ * and connects to the next rank's socket
+ *
+ * A peer that exits or stalls makes every blocking call here throw, after at
+ * most timeout_ms, rather than hang.
+ */
+struct RingAllReduce {
+  tcapint rank;
+  tcapint world_size;
+  int next_fd;
+  int prev_fd;
+
+  RingAllReduce(const std::string &prefix, const tcapint &r, const tcapint &w,
+                const int &timeout_ms = 60000);
+  ~RingAllReduce();
+  RingAllReduce(const RingAllReduce &) = delete;
+  RingAllReduce &operator=(const RingAllReduce &) = delete;
+
+  /**
+   * Sum data[0, n) over all ranks, in place (reduce-scatter, then all-gather)
+   */
+  void allreduce(real1 *data, const size_t &n);
+
+  /**
+   * Fork one isolated worker process per rank to run fn(rank), and wait for
+   * them all: returns each worker's exit status (0 on success, 1 if fn threw,
+   * -1 if it couldn't be forked, or else the signal or code that killed it),
+   * so a crashed worker never takes down the caller
+   *
+   * Call this only while no other thread is running in the process (so not
+   * during par_for() or DataParallel work on another thread): a forked worker
+   * inherits only the calling thread, and any lock another thread held at
+   * the fork stays held in the worker forever.
+   */
+  static std::vector<int> spawn(const tcapint &w,
+                                const std::function<void(tcapint)> &fn);
+
+private:
+  void exchange(const real1 *send, const size_t &send_n, real1 *recv,
+                const size_t &recv_n);
+};
+} // namespace Weed
@@ -47,10 +47,10 @@ struct Serializer {
   static void read_bitLenInt(std::istream &in, bitLenInt &x) {
     in.read(reinterpret_cast<char *>(&x), sizeof(bitLenInt));
   }
-  static void write_int64(std::ostream &out, const symint &x) {
+  static void write_int64(std::ostream &out, const int64_t &x) {
     out.write(reinterpret_cast<const char *>(&x), sizeof(int64_t));
   }
-  static void read_int64(std::istream &in, symint &x) {
+  static void read_int64(std::istream &in, int64_t &x) {
     in.read(reinterpret_cast<char *>(&x), sizeof(int64_t));
   }
   static void write_size_t(std::ostream &out, const size_t &x) {
@@ -59,6 +59,18 @@ struct Serializer {
   static void read_size_t(std::istream &in, size_t &x) {
     in.read(reinterpret_cast<char *>(&x), sizeof(size_t));
   }
+  static void write_uint8(std::ostream &out, const uint8_t &x) {
+    out.write(reinterpret_cast<const char *>(&x), sizeof(uint8_t));
+  }
+  static void read_uint8(std::istream &in, uint8_t &x) {
+    in.read(reinterpret_cast<char *>(&x), sizeof(uint8_t));
+  }
+  static void write_uint16(std::ostream &out, const uint16_t &x) {
+    out.write(reinterpret_cast<const char *>(&x), sizeof(uint16_t));
+  }
+  static void read_uint16(std::istream &in, uint16_t &x) {
+    in.read(reinterpret_cast<char *>(&x), sizeof(uint16_t));
+  }
   static void write_real(std::ostream &out, const real1 &x) {
     out.write(reinterpret_cast<const char *>(&x), sizeof(real1));
   }
@@ -81,6 +93,38 @@ struct Serializer {
     read_real(in, i);
     z = complex(r, i);
   }
+  /**
+   * Write n contiguous elements as one block
+   */
+  template <typename T>
+  static void write_block(std::ostream &out, const T *x, const size_t &n) {
+    out.write(reinterpret_cast<const char *>(x), sizeof(T) * n);
+  }
+  /**
+   * Read n contiguous elements as one block
+   */
+  template <typename T>
+  static void read_block(std::istream &in, T *x, const size_t &n) {
+    in.read(reinterpret_cast<char *>(x), sizeof(T) * n);
+  }
+  /**
+   * Byte order of this host (1 for little-endian, 2 for big-endian)
+   */
+  static uint8_t get_endianness() {
+    const uint16_t x = 1U;
+    return (*reinterpret_cast<const uint8_t *>(&x) == 1U) ? 1U : 2U;
+  }
+  /**
+   * 64-bit FNV-1a checksum of a byte range
+   */
+  static uint64_t checksum(const void *p, const size_t &bytes) {
+    const uint8_t *b = reinterpret_cast<const uint8_t *>(p);
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0U; i < bytes; ++i) {
+      h = (h ^ b[i]) * 1099511628211ULL;
+    }
+    return h;
+  }
   static void write_quantum_fn(std::ostream &out,
                                const QuantumFunctionType &x) {
     out.write(reinterpret_cast<const char *>(&x), sizeof(QuantumFunctionType));
@@ -196,6 +196,9 @@ WEED_CONST real1 REAL1_EPSILON = (real1)7.965459555662261e-59;
 WEED_CONST real1 ADAM_BETA1_DEFAULT = (real1)0.9;
 WEED_CONST real1 ADAM_BETA2_DEFAULT = (real1)0.999;
 WEED_CONST real1 ADAM_EPSILON_DEFAULT = (real1)1e-8;
+WEED_CONST real1 ADAMW_WEIGHT_DECAY_DEFAULT = (real1)0.01;
+WEED_CONST tcapint DDP_BUCKET_DEFAULT = 1U << 16U;
+WEED_CONST tcapint CE_VOCAB_CHUNK_DEFAULT = 1U << 12U;
 #define SineShift M_PI_2
 
 typedef std::unordered_map<tcapint, real1> RealSparseVector;
@@ -26,6 +26,11 @@ enum StorageType {
   INT_CPU_DENSE = 5,
   INT_GPU_DENSE = 6,
   REAL_CPU_SPARSE = 7,
-  COMPLEX_CPU_SPARSE = 8
+  COMPLEX_CPU_SPARSE = 8,
+  REAL_CPU_FP16 = 9,
+  REAL_CPU_BF16 = 10,
+  REAL_CPU_ALIGNED = 11,
+  // Flag bit: the record carries a BlobHeader ahead of its payload
+  STORAGE_HEADER_FLAG = 0x100
 };
 } // namespace Weed
@@ -0,0 +1,48 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include "modules/module.hpp"
+
+namespace Weed {
+/**
+ * Gradient checkpointing wrapper: runs the child module's forward without
+ * recording its graph, then re-runs it (with grad) to rebuild the local graph
+ * during backward
+ *
+ * The child must be deterministic between the two runs (so no active Dropout
+ * or KV cache inside a checkpoint).
+ */
+struct Checkpoint : public Module {
+  ModulePtr child;
+
+  Checkpoint(const ModulePtr &c) : Module(CHECKPOINT_T), child(c) {}
+
+  void train() override { child->train(); }
+  void eval() override { child->eval(); }
+  void migrate_cpu() override { child->migrate_cpu(); }
+  void migrate_gpu() override { child->migrate_gpu(); }
+  void set_max_kv_seq_len(tcapint m) override { child->set_max_kv_seq_len(m); }
+  void reset_cache() override { child->reset_cache(); }
+  bool is_capturable() override { return child->is_capturable(); }
+
+  TensorPtr forward(const TensorPtr x) override;
+  TensorPtr forward(const SymbolTensorPtr x) override;
+
+  std::vector<ParameterPtr> parameters() override {
+    return child->parameters();
+  }
+
+  void save(std::ostream &) const override;
+};
+typedef std::shared_ptr<Checkpoint> CheckpointPtr;
+} // namespace Weed
@@ -0,0 +1,57 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include "modules/module.hpp"
+
+#include <functional>
+
+namespace Weed {
+/**
+ * Data-parallel training over model replicas: each replica is a clone of the
+ * master module that shares its parameter storage, runs forward and backward
+ * on its own batch shard in its own thread, and the replicas' gradients are
+ * then summed into the master parameters' gradients, for any optimizer step
+ * on the master parameters
+ *
+ * (Replicas read parameters concurrently, so they should live on CPU.)
+ *
+ * Every shard runs with the caller's autograd mode and gradient-ready hook
+ * (which may then be called from several shard threads at once), and with no
+ * CpuArena or MemoryPlan bound, since gradients must outlive those.
+ */
+struct DataParallel {
+  /**
+   * Build the (scalar) loss of one batch shard on a replica
+   */
+  typedef std::function<TensorPtr(const ModulePtr &, const tcapint &)> LossFn;
+
+  ModulePtr master;
+  std::vector<ModulePtr> replicas;
+
+  DataParallel(const ModulePtr &m, const tcapint &n);
+
+  /**
+   * Point every replica parameter back at the master's storage (as after
+   * migrating or reloading master parameters)
+   */
+  void sync();
+
+  /**
+   * Back-propagate loss(replica, i) for every shard i in parallel, each scaled
+   * by 1/n (so equal shards average to the full-batch gradient), and
+   * all-reduce the replica gradients into the master gradients
+   */
+  void backward(const LossFn &loss);
+};
+typedef std::shared_ptr<DataParallel> DataParallelPtr;
+} // namespace Weed
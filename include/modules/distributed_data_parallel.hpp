@@ -0,0 +1,50 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2017-2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include "common/ring_allreduce.hpp"
+#include "modules/module.hpp"
+
+namespace Weed {
+typedef std::shared_ptr<RingAllReduce> RingAllReducePtr;
+
+/**
+ * Process-level data parallelism: every worker process holds its own copy of
+ * the module and back-propagates its own batch shard, while parameter
+ * gradients are averaged over all workers by ring all-reduce
+ *
+ * Gradients are gathered into buckets as back-propagation finalizes them, and
+ * each full bucket is communicated in the background while backward()
+ * continues. (Every worker must run the same graph, so buckets match.)
+ */
+struct DistributedDataParallel {
+  ModulePtr module;
+  RingAllReducePtr ring;
+  tcapint bucket_size;
+
+  DistributedDataParallel(const ModulePtr &m, const RingAllReducePtr &r,
+                          const tcapint &b = DDP_BUCKET_DEFAULT)
+      : module(m), ring(r), bucket_size(b) {
+    module->train();
+  }
+
+  /**
+   * Back-propagate this worker's loss, leaving the mean gradient over all
+   * workers on every module parameter
+   */
+  void backward(const TensorPtr &loss);
+
+private:
+  void reduce(const std::vector<ParameterPtr> &bucket);
+};
+typedef std::shared_ptr<DistributedDataParallel> DistributedDataParallelPtr;
+} // namespace Weed
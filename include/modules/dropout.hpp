@@ -12,6 +12,7 @@
 #pragma once
 
 #include "modules/module.hpp"
+#include "ops/dropout.hpp"
 
 namespace Weed {
 /**
@@ -20,11 +21,13 @@ namespace Weed {
 struct Dropout : public Module {
   real1 p;
   bool training;
-  TensorPtr mask;
+  // Philox key, and the count of masks drawn (as the Philox stream)
+  uint64_t seed;
+  uint64_t stream;
 
-  Dropout() : Module(DROPOUT_T) {}
-  Dropout(real1 prob)
-      : Module(DROPOUT_T), p(prob), training(true), mask(nullptr) {
+  Dropout() : Module(DROPOUT_T), seed(random_seed()), stream(0U) {}
+  Dropout(real1 prob, const uint64_t &s = random_seed())
+      : Module(DROPOUT_T), p(prob), training(true), seed(s), stream(0U) {
     if ((p < ZERO_R1) || (p >= ONE_R1)) {
       throw std::invalid_argument(
           "Dropout probability must be at least 0.0 and cannot be greater than "
@@ -41,6 +44,19 @@ struct Dropout : public Module {
     training = false;
   }
 
+  /**
+   * Restart the mask sequence from seed s (for reproducibility)
+   */
+  void set_seed(const uint64_t &s) {
+    seed = s;
+    stream = 0U;
+  }
+  /**
+   * A nondeterministic seed, for the default
+   */
+  static uint64_t random_seed();
+
+  bool is_capturable() override { return !training || (p == ZERO_R1); }
   TensorPtr forward(const TensorPtr x) override;
 
   void save(std::ostream &) const override;
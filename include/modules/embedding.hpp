@@ -22,15 +22,22 @@ struct Embedding : public Module {
   tcapint num_embeddings;
   tcapint embedding_dim;
   ParameterPtr weight;
+  /**
+   * Keep the (CPU) weight gradient sparse, touching only the rows of seen
+   * tokens, for lazy sparse optimizer updates (not serialized)
+   */
+  bool sparse_grad;
 
-  Embedding() : Module(EMBEDDING_T) {}
+  Embedding() : Module(EMBEDDING_T), sparse_grad(false) {}
   Embedding(const tcapint &vocab, const tcapint &dim,
             const DType &dtype = DType::REAL,
-            const DeviceTag &dtag = DeviceTag::DEFAULT_DEVICE, int64_t did = -1)
+            const DeviceTag &dtag = DeviceTag::DEFAULT_DEVICE, int64_t did = -1,
+            const bool &sg = false)
       : Module(EMBEDDING_T), num_embeddings(vocab), embedding_dim(dim),
         weight(std::make_shared<Parameter>(std::vector<tcapint>{vocab, dim},
                                            std::vector<tcapint>{1, vocab}, true,
-                                           dtype, dtag, did)) {}
+                                           dtype, dtag, did)),
+        sparse_grad(sg) {}
   TensorPtr forward(const TensorPtr) override {
     throw std::domain_error(
         "Embedding::forward(x) takes a SymbolTensor, not a Tensor!");
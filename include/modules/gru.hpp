@@ -60,6 +60,7 @@ struct GRU : public Module {
     W_h->migrate_gpu();
   }
 
+  bool is_capturable() override { return false; }
   TensorPtr forward(const TensorPtr) override;
 
   void save(std::ostream &) const override;
@@ -72,6 +72,7 @@ struct LSTM : public Module {
     W_h->migrate_gpu();
   }
 
+  bool is_capturable() override { return false; }
   TensorPtr forward(const TensorPtr) override;
 
   void save(std::ostream &) const override;
@@ -20,6 +20,7 @@ namespace Weed {
  */
 struct MigrateCpu : public Module {
   MigrateCpu() : Module(MIGRATE_CPU_T) {}
+  bool is_capturable() override { return false; }
   TensorPtr forward(const TensorPtr x) override;
   ParameterPtr pforward(const ParameterPtr x);
 };
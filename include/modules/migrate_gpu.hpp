@@ -22,6 +22,7 @@ struct MigrateGpu : public Module {
   symint device_id;
   MigrateGpu(const symint device_id_ = -1)
       : Module(MIGRATE_GPU_T), device_id(-1) {}
+  bool is_capturable() override { return false; }
   TensorPtr forward(const TensorPtr x) override;
   ParameterPtr pforward(const ParameterPtr x);
 };
@@ -12,6 +12,8 @@
 #pragma once
 
 #include "enums/module_type.hpp"
+#include "storage/memory_plan.hpp"
+#include "tensors/graph_capture.hpp"
 #include "tensors/parameter.hpp"
 #include "tensors/symbol_tensor.hpp"
 
@@ -106,6 +108,12 @@ struct Module {
    */
   virtual void migrate_gpu(){};
 
+  /**
+   * Re-encode all dense CPU real-value parameters as REAL_CPU_FP16,
+   * REAL_CPU_BF16, or (back to) REAL_CPU_DENSE
+   */
+  void cast_parameters(const StorageType &st);
+
   /**
    * Set max KV sequence length
    */
@@ -116,14 +124,57 @@ struct Module {
    */
   virtual void reset_cache() {}
 
+  /**
+   * Is forward() made only of launches that capture() can record (with no
+   * state or randomness)?
+   */
+  virtual bool is_capturable() { return true; }
+
+  /**
+   * Record the kernel launches of one (no-grad) forward() at the shape of x,
+   * for CapturedGraph::replay() on new inputs of that shape
+   */
+  CapturedGraphPtr capture(const TensorPtr &x);
+  /**
+   * Record the kernel launches of one (no-grad) forward() at the shape of x,
+   * for CapturedGraph::replay() on new inputs of that shape
+   */
+  CapturedGraphPtr capture(const SymbolTensorPtr &x);
+
+  /**
+   * Trace one (no-grad) forward() at this input shape, and plan every dense
+   * CPU intermediate into one reusable slab (with get_peak() known up front)
+   */
+  MemoryPlanPtr plan_memory(const std::vector<tcapint> &shape,
+                            const DType &dtype = DType::REAL);
+  /**
+   * Run one (no-grad) forward() with its intermediates placed by the plan
+   */
+  TensorPtr forward_planned(MemoryPlan &plan, const TensorPtr &x);
+
   /**
    * Serialize storage to ostream
    */
   virtual void save(std::ostream &) const;
+  /**
+   * Serialize to ostream, with dense real CPU parameters as aligned blobs
+   * (that load_mapped() can alias without copying)
+   */
+  void save_aligned(std::ostream &) const;
+  /**
+   * Serialize to ostream, with a checksummed BlobHeader on every parameter
+   * payload
+   */
+  void save_checked(std::ostream &) const;
   /**
    * Load serialized storage from istream
    */
   static ModulePtr load(std::istream &);
+  /**
+   * Load from a file, memory-mapping aligned parameter blobs (copy-on-write)
+   * instead of reading them
+   */
+  static ModulePtr load_mapped(const std::string &path);
   /**
    * Static helper function for module serialization to ostream
    */
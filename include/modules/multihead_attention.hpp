@@ -167,6 +167,7 @@ struct MultiHeadAttention : public Module {
     }
   }
 
+  bool is_capturable() override { return false; }
   TensorPtr forward(const TensorPtr x) override;
 
   void save(std::ostream &) const override;
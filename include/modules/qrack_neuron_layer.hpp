@@ -90,6 +90,7 @@ struct QrackNeuronLayer : public Module {
     requires_grad = false;
   }
 
+  bool is_capturable() override { return false; }
   TensorPtr forward(const TensorPtr x) override;
   void save(std::ostream &) const override;
 
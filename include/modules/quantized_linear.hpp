@@ -0,0 +1,48 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include "modules/linear.hpp"
+#include "ops/quantized_matmul.hpp"
+
+namespace Weed {
+/**
+ * Linear module with weight-only int8 or int4 quantization
+ *
+ * Weights are frozen and stay on CPU; only the (optional) bias is trainable.
+ * Gradients still flow back to the input.
+ */
+struct QuantizedLinear : public Module {
+  tcapint in_features;
+  tcapint out_features;
+
+  QuantizedWeightPtr weight; // (in_features, out_features)
+  ParameterPtr bias;         // (out_features) or null
+
+  QuantizedLinear() : Module(QUANTIZED_LINEAR_T) {}
+  /**
+   * Quantize a trained Linear (with per-channel scales if group_size is 0)
+   */
+  QuantizedLinear(const Linear &l, const tcapint &bits = 8U,
+                  const tcapint &group_size = 0U);
+
+  void migrate_cpu() override;
+
+  TensorPtr forward(const TensorPtr x) override;
+  std::vector<ParameterPtr> parameters() override;
+  /**
+   * Serialize storage to ostream
+   */
+  void save(std::ostream &) const override;
+};
+typedef std::shared_ptr<QuantizedLinear> QuantizedLinearPtr;
+} // namespace Weed
@@ -101,6 +101,7 @@ struct QwenDecoderLayer : public Module {
 
   std::vector<ParameterPtr> parameters() override { return param_vector; }
 
+  bool is_capturable() override { return false; }
   TensorPtr forward(const TensorPtr x) override {
     // Pre-norm + attention + residual
     TensorPtr residual = x;
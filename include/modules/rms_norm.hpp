@@ -13,6 +13,8 @@
 
 #include "common/serializer.hpp"
 #include "modules/module.hpp"
+#include "ops/norm.hpp"
+#include "tensors/lazy_expr.hpp"
 
 namespace Weed {
 /**
@@ -32,6 +34,20 @@ struct RMSNorm : public Module {
   }
   std::vector<ParameterPtr> parameters() override { return {weight}; }
   TensorPtr forward(const TensorPtr x) override {
+    // One read and one write of x, where supported
+    const symint nd = (symint)x->shape.size();
+    if ((((axis < 0) ? (axis + nd) : axis) == (nd - 1)) &&
+        can_fused_norm(*(x.get()), *(weight.get()))) {
+      return Tensor::rms_norm(x, weight, FP_NORM_EPSILON);
+    }
+    if (LazyMode::is_enabled()) {
+      // Only the reduction runs separately; the rest is one fused kernel
+      const LazyExprPtr ms =
+          LazyExpr::leaf(Tensor::mean(x * x, axis)) + real1_f(FP_NORM_EPSILON);
+      return (LazyExpr::leaf(x) / (ms ^ real1_f(0.5f)) *
+              LazyExpr::leaf(weight))
+          ->materialize();
+    }
     return (x / ((Tensor::mean(x * x, axis) + real1_f(FP_NORM_EPSILON)) ^
                  real1_f(0.5f))) *
            weight;
@@ -12,6 +12,7 @@
 #pragma once
 
 #include "modules/module.hpp"
+#include "ops/rope.hpp"
 
 namespace Weed {
 /**
@@ -34,7 +35,13 @@ struct RoPE : public Module {
 
   void _build_tables();
   TensorPtr _rotate_half(const TensorPtr x);
-  TensorPtr forward(const TensorPtr x) override;
+  bool is_capturable() override { return false; }
+  TensorPtr forward(const TensorPtr x) override { return forward(x, 0U); }
+  /**
+   * Rotate x [B, H, T, head_dim] for positions pos to pos + T (where pos is
+   * the count of tokens already in a KV cache)
+   */
+  TensorPtr forward(const TensorPtr x, const tcapint &pos);
   void save(std::ostream &os) const override;
 };
 typedef std::shared_ptr<RoPE> RoPEPtr;
@@ -63,6 +63,16 @@ struct Sequential : public Module {
     }
   }
 
+  bool is_capturable() override {
+    for (const ModulePtr &m : layers) {
+      if (!m->is_capturable()) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
   TensorPtr forward(const TensorPtr x) override {
     TensorPtr tmp = x;
     for (size_t i = 0U; i < layers.size(); ++i) {
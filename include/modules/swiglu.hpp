@@ -12,6 +12,7 @@
 #pragma once
 
 #include "modules/linear.hpp"
+#include "ops/swiglu.hpp"
 
 namespace Weed {
 /**
@@ -69,6 +70,14 @@ struct SwiGLU : public Module {
   }
 
   TensorPtr forward(const TensorPtr x) override {
+    // Both projections and the gating, as one op, where supported
+    if (!gate_proj->bias && !up_proj->bias &&
+        can_swiglu(*(x.get()), *(gate_proj->weight.get()),
+                   *(up_proj->weight.get()))) {
+      return down_proj->forward(
+          Tensor::swiglu(x, gate_proj->weight, up_proj->weight));
+    }
+
     TensorPtr gate = gate_proj->forward(x);
     TensorPtr up = up_proj->forward(x);
     // SiLU(gate) * up
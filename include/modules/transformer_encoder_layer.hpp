@@ -88,6 +88,7 @@ struct TransformerEncoderLayer : public Module {
 
   void reset_cache() override { self_attn->reset_cache(); }
 
+  bool is_capturable() override { return false; }
   TensorPtr forward(const TensorPtr x) override;
 
   void save(std::ostream &) const override;
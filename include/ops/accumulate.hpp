@@ -0,0 +1,48 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include "tensors/tensor.hpp"
+
+namespace Weed {
+/*
+ * Each of these accumulates into "din" in place. Where "din" has extent 1 on
+ * an index along which the operands don't, the accumulation is summed over
+ * that index (as for the gradient of a broadcast operand).
+ */
+
+/**
+ * Fused gradient accumulation: din += s * a * b
+ */
+void mul_acc(Tensor &din, const Tensor &a, const Tensor &b,
+             const real1 &s = ONE_R1);
+/**
+ * Fused gradient accumulation: din += s * a / b
+ */
+void div_acc(Tensor &din, const Tensor &a, const Tensor &b,
+             const real1 &s = ONE_R1);
+/**
+ * Fused gradient accumulation: din += s * a * b / c
+ */
+void mul_div_acc(Tensor &din, const Tensor &a, const Tensor &b,
+                 const Tensor &c, const real1 &s = ONE_R1);
+/**
+ * Fused divisor gradient accumulation: din -= dout * a / (b * b)
+ */
+void div_grad_acc(Tensor &din, const Tensor &a, const Tensor &b,
+                  const Tensor &dout);
+/**
+ * Fused broadcast reduction: din += s * dout
+ */
+void reduce_broadcast_acc(Tensor &din, const Tensor &dout,
+                          const real1 &s = ONE_R1);
+} // namespace Weed
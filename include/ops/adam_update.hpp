@@ -0,0 +1,53 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include "tensors/tensor.hpp"
+
+namespace Weed {
+/**
+ * Scalar coefficients of one Adam(W) step
+ */
+struct AdamCoefficients {
+  real1 lr;
+  real1 beta1;
+  real1 beta2;
+  real1 eps;
+  real1 bias_correction1;
+  real1 bias_correction2;
+  real1 weight_decay;
+  // AdamW (decoupled) weight decay, or else L2 penalty folded into g
+  bool decoupled;
+};
+
+/**
+ * Can adam_update() run on this parameter, moments and gradient?
+ */
+bool can_adam_update(const Tensor &p, const Tensor &m, const Tensor &v,
+                     const Tensor &g);
+
+/**
+ * Fused in-place Adam(W) step, in one pass over the parameter:
+ *
+ * m = beta1 * m + (1 - beta1) * g
+ * v = beta2 * v + (1 - beta2) * g * g
+ * p -= lr * (m / bc1) / (sqrt(v / bc2) + eps)
+ *
+ * (The parameter, moments and gradient must be dense real storage, on the CPU
+ * or all on one GPU.) If g has
+ * sparse CPU storage, this is "lazy" Adam: only the elements present in g
+ * (such as the rows of seen tokens in an embedding) are updated, so the step
+ * costs O(nonzero gradient) instead of O(parameter).
+ */
+void adam_update(Tensor &p, Tensor &m, Tensor &v, const Tensor &g,
+                 const AdamCoefficients &c);
+} // namespace Weed
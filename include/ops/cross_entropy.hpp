@@ -0,0 +1,62 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include "tensors/symbol_tensor.hpp"
+#include "tensors/tensor.hpp"
+
+namespace Weed {
+/**
+ * Can cross_entropy() fuse this loss? (CPU real logits, CPU targets, with one
+ * target per logits row over the last axis)
+ */
+bool can_cross_entropy(const Tensor &logits, const SymbolTensor &targets);
+/**
+ * Fused cross-entropy forward, in one read of the logits: per row r,
+ * lse[r] = log(sum(exp(logits[r, :]))), and returns
+ * mean(lse[r] - logits[r, targets[r]])
+ */
+real1 cross_entropy(const Tensor &logits, const SymbolTensor &targets,
+                    std::vector<real1> &lse);
+/**
+ * Fused cross-entropy backward: dlogits += scale * (softmax - onehot), with
+ * softmax recomputed from the forward log-sum-exp
+ */
+void cross_entropy_grad(Tensor &dlogits, const Tensor &logits,
+                        const SymbolTensor &targets,
+                        const std::vector<real1> &lse, const real1 &scale);
+
+/**
+ * Can linear_cross_entropy() fuse this loss? (x as dense CPU real rows of
+ * width w.shape[0], CPU real weight [in, V], and one target per row)
+ */
+bool can_linear_cross_entropy(const Tensor &x, const Tensor &w,
+                              const SymbolTensor &targets);
+/**
+ * Fused vocabulary projection and cross-entropy, over [R, in] rows x: the
+ * logits x * w + b are formed chunk columns at a time, with an online
+ * log-sum-exp per row, so no [R, V] tensor is ever held (b may be null)
+ */
+real1 linear_cross_entropy(const Tensor &x, const Tensor &w, const Tensor *b,
+                           const SymbolTensor &targets, const tcapint &chunk,
+                           std::vector<real1> &lse);
+/**
+ * Fused linear cross-entropy backward, chunk by chunk from recomputed
+ * logits: dx += g * w^T, dw += x^T * g, and db += sum(g), where
+ * g = scale * (softmax - onehot) (any output may be null)
+ */
+void linear_cross_entropy_grad(Tensor *dx, Tensor *dw, std::vector<real1> *db,
+                               const Tensor &x, const Tensor &w,
+                               const Tensor *b, const SymbolTensor &targets,
+                               const std::vector<real1> &lse,
+                               const real1 &scale, const tcapint &chunk);
+} // namespace Weed
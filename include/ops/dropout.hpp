@@ -0,0 +1,41 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include "tensors/tensor.hpp"
+
+namespace Weed {
+/**
+ * Can dropout() run on x? (dense contiguous CPU real)
+ */
+bool can_dropout(const Tensor &x);
+/**
+ * Dropout keep-mask of n elements as a dense bitmask (bit i of word i / 64
+ * is set if element i is kept, with probability 1 - p), from the Philox
+ * stream (seed, stream)
+ */
+std::vector<uint64_t> dropout_mask(const tcapint &n, const real1 &p,
+                                   const uint64_t &seed,
+                                   const uint64_t &stream);
+/**
+ * Fused dropout: y = x * mask / (1 - p), for the dropout_mask() of the same
+ * seed and stream, generated on the fly (y may be x itself)
+ */
+void dropout(Tensor &y, const Tensor &x, const real1 &p, const uint64_t &seed,
+             const uint64_t &stream);
+/**
+ * Fused dropout backward: dx += dy * mask / (1 - p), with the mask
+ * regenerated from the seed and stream
+ */
+void dropout_grad(Tensor &dx, const Tensor &dy, const real1 &p,
+                  const uint64_t &seed, const uint64_t &stream);
+} // namespace Weed
@@ -18,4 +18,12 @@ namespace Weed {
  * Matrix multiplication (on 2 indices)
  */
 void matmul(const Tensor &a, const Tensor &b, Tensor &out);
+/**
+ * Accumulating matrix multiplication: out += a * b (as for gradients)
+ */
+void matmul_acc(const Tensor &a, const Tensor &b, Tensor &out);
+/**
+ * Columns [c, c + n) of a [rows, cols] matrix, as a view (sharing storage)
+ */
+Tensor column_view(const Tensor &m, const tcapint &c, const tcapint &n);
 } // namespace Weed
@@ -0,0 +1,54 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include "tensors/tensor.hpp"
+
+namespace Weed {
+/**
+ * Can the fused norm kernels run on x, normalized over its last axis, with
+ * this per-feature parameter? (dense CPU real x; CPU real w, varying only
+ * along its last axis, of width x.shape.back())
+ */
+bool can_fused_norm(const Tensor &x, const Tensor &w);
+/**
+ * Fused RMSNorm forward, in one read of x: per row r,
+ * rstd[r] = 1 / sqrt(mean(x[r, :]^2) + eps), and y = x * rstd * w
+ */
+void rms_norm(const Tensor &x, const Tensor &w, const real1 &eps, Tensor &y,
+              std::vector<real1> &rstd);
+/**
+ * Fused RMSNorm backward: dx += rstd * (g - xhat * mean(g * xhat)), for
+ * g = dy * w and xhat = x * rstd, and dw = sum(dy * xhat) over rows (either
+ * output may be null)
+ */
+void rms_norm_grad(Tensor *dx, std::vector<real1> *dw, const Tensor &dy,
+                   const Tensor &x, const Tensor &w,
+                   const std::vector<real1> &rstd);
+/**
+ * Fused LayerNorm forward, in one read of x: per row statistics by Welford's
+ * method, and y = (x - mean) * rstd * gamma + beta
+ */
+void layer_norm(const Tensor &x, const Tensor &gamma, const Tensor &beta,
+                const real1 &eps, Tensor &y, std::vector<real1> &mean,
+                std::vector<real1> &rstd);
+/**
+ * Fused LayerNorm backward: dx += rstd * (g - mean(g) - xhat * mean(g * xhat)),
+ * for g = dy * gamma, dgamma = sum(dy * xhat) and dbeta = sum(dy) over rows
+ * (any output may be null)
+ */
+void layer_norm_grad(Tensor *dx, std::vector<real1> *dgamma,
+                     std::vector<real1> *dbeta, const Tensor &dy,
+                     const Tensor &x, const Tensor &gamma,
+                     const std::vector<real1> &mean,
+                     const std::vector<real1> &rstd);
+} // namespace Weed
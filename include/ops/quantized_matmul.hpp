@@ -0,0 +1,73 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include "tensors/tensor.hpp"
+
+namespace Weed {
+/**
+ * Weight-only quantized (in_features, out_features) matrix
+ *
+ * Each output column is split into groups of group_size input rows, and each
+ * group gets one symmetric scale. Values are int8 (bits = 8) or two int4
+ * nibbles per byte (bits = 4, offset by 8). Every column starts on a byte
+ * boundary.
+ */
+struct QuantizedWeight {
+  tcapint rows;
+  tcapint cols;
+  tcapint bits;
+  tcapint group_size;
+  std::vector<uint8_t> q;
+  std::vector<real1> scales; // (cols, groups)
+
+  QuantizedWeight() : rows(0U), cols(0U), bits(8U), group_size(0U) {}
+
+  /**
+   * Quantize a real-valued 2-index tensor (on any device)
+   */
+  QuantizedWeight(const Tensor &w, const tcapint &b, const tcapint &gs = 0U);
+
+  /**
+   * Number of scale groups per column
+   */
+  tcapint get_groups() const {
+    return (rows + group_size - 1U) / group_size;
+  }
+
+  /**
+   * Bytes per packed column
+   */
+  tcapint get_col_bytes() const {
+    return (bits == 4U) ? ((rows + 1U) >> 1U) : rows;
+  }
+
+  /**
+   * Dequantize one column into a buffer of length rows
+   */
+  void decode_column(const tcapint &j, real1_f *out) const;
+
+  /**
+   * Dequantize the full matrix into a (rows, cols) real-valued tensor
+   */
+  TensorPtr dequantize(const DeviceTag &dtag = DeviceTag::CPU) const;
+
+  void validate() const;
+};
+typedef std::shared_ptr<QuantizedWeight> QuantizedWeightPtr;
+
+/**
+ * Matrix multiplication of a real-valued (M, K) tensor with a quantized
+ * (K, N) weight, dequantizing on the fly, into a contiguous (M, N) CPU tensor
+ */
+void quantized_matmul(const Tensor &a, const QuantizedWeight &w, Tensor &out);
+} // namespace Weed
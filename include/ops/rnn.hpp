@@ -0,0 +1,62 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include "tensors/tensor.hpp"
+
+namespace Weed {
+/**
+ * Can the sequence kernels run this recurrence? (dense CPU real x [B, T, in];
+ * CPU real wx [in, G * H], wh [H, G * H], and optional biases of width G * H,
+ * for G gates)
+ */
+bool can_rnn_sequence(const Tensor &x, const Tensor &wx, const Tensor *bx,
+                      const Tensor &wh, const Tensor *bh, const tcapint &G);
+/**
+ * Fused LSTM over a whole sequence, for x [N, in] with rows b + t * B: one
+ * GEMM for every step's input projection, then per step one recurrent GEMM
+ * and one pass of gate math. Saves the activated gates (f, i, g, o) in z
+ * [N, 4H], and the cell states in cs [N, H], for the backward. Outputs hs
+ * [N, H], and the last h and c [B, H].
+ */
+void lstm_sequence(const Tensor &x, const Tensor &wx, const Tensor *bx,
+                   const Tensor &wh, const Tensor *bh, const Tensor &h0,
+                   const Tensor &c0, Tensor &z, Tensor &hs, Tensor &cs,
+                   Tensor &h_last, Tensor &c_last);
+/**
+ * Fused LSTM backward through time, from dhs [N, H]: accumulates dx, dwx and
+ * dwh, and writes the (shared) bias gradient db, each in one GEMM or pass
+ * over the sequence (any output may be null)
+ */
+void lstm_sequence_grad(Tensor *dx, Tensor *dwx, Tensor *dwh,
+                        std::vector<real1> *db, const Tensor &dhs,
+                        const Tensor &x, const Tensor &wx, const Tensor &wh,
+                        const Tensor &h0, const Tensor &c0, const Tensor &z,
+                        const Tensor &hs, const Tensor &cs);
+/**
+ * Fused GRU over a whole sequence, as for lstm_sequence(), with
+ * h = (1 - z) * h_prev + z * tanh(x * wx_n + (r * h_prev) * wh_n + b_n).
+ * Saves the activated gates (z, r, n) in z [N, 3H], and r * h_prev in rh
+ * [N, H].
+ */
+void gru_sequence(const Tensor &x, const Tensor &wx, const Tensor *bx,
+                  const Tensor &wh, const Tensor *bh, const Tensor &h0,
+                  Tensor &z, Tensor &hs, Tensor &rh, Tensor &h_last);
+/**
+ * Fused GRU backward through time (any output may be null)
+ */
+void gru_sequence_grad(Tensor *dx, Tensor *dwx, Tensor *dwh,
+                       std::vector<real1> *db, const Tensor &dhs,
+                       const Tensor &x, const Tensor &wx, const Tensor &wh,
+                       const Tensor &h0, const Tensor &z, const Tensor &hs,
+                       const Tensor &rh);
+} // namespace Weed
@@ -0,0 +1,36 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include "tensors/tensor.hpp"
+
+namespace Weed {
+/**
+ * Can rope() rotate x? (dense CPU real x [B, H, T, head_dim], dense CPU real
+ * [max_seq_len, head_dim] tables, and positions pos to pos + T in range)
+ */
+bool can_rope(const Tensor &x, const Tensor &cos_table,
+              const Tensor &sin_table, const tcapint &pos);
+/**
+ * Fused rotary embedding, at positions pos + t: for each pair (j, j + half),
+ * y[j] = x[j] * cos[j] - x[j + half] * sin[j] and
+ * y[j + half] = x[j + half] * cos[j + half] + x[j] * sin[j + half]
+ * (y may be x itself, to rotate in place)
+ */
+void rope(Tensor &y, const Tensor &x, const Tensor &cos_table,
+          const Tensor &sin_table, const tcapint &pos);
+/**
+ * Fused rotary embedding backward: dx += R^T * dy, for the rope() rotation R
+ */
+void rope_grad(Tensor &dx, const Tensor &dy, const Tensor &cos_table,
+               const Tensor &sin_table, const tcapint &pos);
+} // namespace Weed
@@ -0,0 +1,37 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include "tensors/tensor.hpp"
+
+namespace Weed {
+/**
+ * Can swiglu() fuse this MLP input? (x as dense CPU real rows of width
+ * wg.shape[0], and CPU real gate and up weights [in, I] of equal shape)
+ */
+bool can_swiglu(const Tensor &x, const Tensor &wg, const Tensor &wu);
+/**
+ * Fused SwiGLU forward, for x [R, in]: the gate and up projections land in
+ * adjacent column blocks of one [R, 2 * I] buffer gu, and the epilogue writes
+ * a = silu(gate) * up, [R, I], in one pass over gu
+ */
+void swiglu(const Tensor &x, const Tensor &wg, const Tensor &wu, Tensor &gu,
+            Tensor &a);
+/**
+ * Fused SwiGLU backward, from the forward gu: one elementwise pass for the
+ * gate and up gradients, then dx += [dgate, dup] * [wg, wu]^T,
+ * dwg += x^T * dgate and dwu += x^T * dup (any output may be null)
+ */
+void swiglu_grad(Tensor *dx, Tensor *dwg, Tensor *dwu, const Tensor &da,
+                 const Tensor &x, const Tensor &wg, const Tensor &wu,
+                 const Tensor &gu);
+} // namespace Weed
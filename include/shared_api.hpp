@@ -36,6 +36,8 @@ extern "C" {
 MICROSOFT_QUANTUM_DECL int get_error(_In_ const uintw mid);
 MICROSOFT_QUANTUM_DECL uintw load_module(_In_ const char *f);
 MICROSOFT_QUANTUM_DECL void save_module(_In_ uintw mid, _In_ const char *f);
+MICROSOFT_QUANTUM_DECL void save_module_aligned(_In_ uintw mid,
+                                                _In_ const char *f);
 MICROSOFT_QUANTUM_DECL void free_module(_In_ uintw mid);
 MICROSOFT_QUANTUM_DECL void forward(_In_ uintw mid, _In_ uintw dtype,
                                     _In_ uintw n, _In_reads_(n) uintw *shape,
@@ -55,6 +57,12 @@ MICROSOFT_QUANTUM_DECL void
 train_step(_In_ uintw mid, _In_ uintw n, _In_reads_(n) uintw *shape,
            _In_ intw *input_ids, _In_ uintw n_target,
            _In_reads_(n_target) intw *target_ids, _In_ double learning_rate);
+MICROSOFT_QUANTUM_DECL void
+train_accumulate(_In_ uintw mid, _In_ uintw n, _In_reads_(n) uintw *shape,
+                 _In_ intw *input_ids, _In_ uintw n_target,
+                 _In_reads_(n_target) intw *target_ids);
+MICROSOFT_QUANTUM_DECL void train_apply(_In_ uintw mid,
+                                        _In_ double learning_rate);
 MICROSOFT_QUANTUM_DECL void reset_kv_cache(_In_ uintw mid);
 MICROSOFT_QUANTUM_DECL void set_max_kv_seq_len(_In_ uintw mid, _In_ uintw m);
 }
@@ -13,6 +13,7 @@
 
 #include "common/weed_types.hpp"
 #include "storage/cpu_complex_storage.hpp"
+#include "storage/cpu_half_storage.hpp"
 #include "storage/cpu_real_storage.hpp"
 #include "storage/sparse_cpu_complex_storage.hpp"
 #include "storage/sparse_cpu_real_storage.hpp"
@@ -0,0 +1,143 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include "common/weed_types.hpp"
+
+#include <memory>
+#include <vector>
+
+#define WEED_ARENA_BLOCK_BYTES (1U << 20U)
+
+namespace Weed {
+struct Tensor;
+typedef std::shared_ptr<Tensor> TensorPtr;
+struct SymbolTensor;
+typedef std::shared_ptr<SymbolTensor> SymbolTensorPtr;
+struct MemoryPlan;
+
+/**
+ * Bump-pointer region for short-lived CPU activations
+ *
+ * While an ArenaGuard is bound to it on the current thread, every dense
+ * CpuStorage allocation is carved out of this region instead of the heap.
+ * Individual buffers are never freed; the whole region is rewound at once
+ * when the guard goes out of scope. After the first pass, the region is
+ * coalesced into a single block sized to the observed peak, so subsequent
+ * passes of the same shape allocate nothing from the heap.
+ *
+ * This is for eval() inference only: any tensor that must outlive the guard
+ * has to be copied out with persist() before the scope ends.
+ */
+struct CpuArena {
+protected:
+  struct Block {
+    std::unique_ptr<unsigned char[], void (*)(unsigned char *)> mem;
+    size_t capacity;
+    size_t top;
+    Block(const size_t &cap);
+  };
+
+  std::vector<Block> blocks;
+  size_t block_bytes;
+  size_t current_block;
+  size_t used;
+  size_t peak;
+  bool bound;
+
+  friend struct ArenaGuard;
+
+public:
+  CpuArena(const size_t &blk = WEED_ARENA_BLOCK_BYTES)
+      : blocks(), block_bytes(blk), current_block(0U), used(0U), peak(0U),
+        bound(false) {}
+
+  CpuArena(const CpuArena &) = delete;
+  CpuArena &operator=(const CpuArena &) = delete;
+
+  /**
+   * Bump-allocate (WEED_ALIGN_SIZE-aligned) bytes from the region
+   */
+  void *allocate(size_t bytes);
+
+  /**
+   * Rewind the whole region, (invalidating every buffer handed out)
+   */
+  void release();
+
+  /**
+   * Is this pointer inside the region?
+   */
+  bool owns(const void *p) const;
+
+  /**
+   * Bytes currently handed out
+   */
+  size_t get_used() const { return used; }
+
+  /**
+   * High-water mark of bytes handed out over all passes
+   */
+  size_t get_peak() const { return peak; }
+
+  /**
+   * Total bytes reserved from the heap
+   */
+  size_t get_capacity() const;
+
+  /**
+   * The arena bound on the calling thread, (or nullptr)
+   */
+  static CpuArena *current();
+
+  /**
+   * If the tensor's storage lives in the currently-bound arena, return a
+   * detached heap copy; otherwise, return the tensor unchanged
+   */
+  static TensorPtr persist(const TensorPtr &t);
+  /**
+   * If the symbol tensor's storage lives in the currently-bound arena, return
+   * a detached heap copy; otherwise, return the tensor unchanged
+   */
+  static SymbolTensorPtr persist(const SymbolTensorPtr &t);
+};
+
+/**
+ * RAII scope that binds a CpuArena to the calling thread and rewinds it on
+ * exit
+ */
+struct ArenaGuard {
+  CpuArena &arena;
+  CpuArena *prior;
+
+  ArenaGuard(CpuArena &a);
+  ~ArenaGuard();
+
+  ArenaGuard(const ArenaGuard &) = delete;
+  ArenaGuard &operator=(const ArenaGuard &) = delete;
+};
+
+/**
+ * RAII scope that temporarily unbinds any arena (or MemoryPlan) on the calling
+ * thread, for allocations that must outlive the forward pass (like KV caches)
+ */
+struct ArenaSuspend {
+  CpuArena *prior;
+  MemoryPlan *prior_plan;
+
+  ArenaSuspend();
+  ~ArenaSuspend();
+
+  ArenaSuspend(const ArenaSuspend &) = delete;
+  ArenaSuspend &operator=(const ArenaSuspend &) = delete;
+};
+} // namespace Weed
@@ -0,0 +1,200 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include "common/serializer.hpp"
+#include "storage/typed_storage.hpp"
+
+#include <cstring>
+#include <vector>
+
+namespace Weed {
+/**
+ * IEEE 754 binary16 encoding (round-to-nearest-even)
+ */
+struct Fp16Codec {
+  static StorageType get_stype() { return REAL_CPU_FP16; }
+
+  static uint16_t encode(const float &f) {
+    uint32_t x;
+    std::memcpy(&x, &f, sizeof(float));
+    const uint32_t sign = (x >> 16U) & 0x8000U;
+    const uint32_t absx = x & 0x7FFFFFFFU;
+
+    if (absx >= 0x7F800000U) {
+      // Inf or NaN
+      return (uint16_t)(sign | 0x7C00U | ((absx > 0x7F800000U) ? 0x200U : 0U));
+    }
+    if (absx >= 0x477FF000U) {
+      // Overflow rounds to Inf
+      return (uint16_t)(sign | 0x7C00U);
+    }
+    if (absx < 0x38800000U) {
+      // Subnormal (or zero) in binary16
+      if (absx < 0x33000000U) {
+        return (uint16_t)sign;
+      }
+      const uint32_t shift = 126U - (absx >> 23U);
+      const uint32_t m = (absx & 0x7FFFFFU) | 0x800000U;
+      uint32_t h = m >> shift;
+      const uint32_t rem = m & ((1U << shift) - 1U);
+      const uint32_t halfway = 1U << (shift - 1U);
+      if ((rem > halfway) || ((rem == halfway) && (h & 1U))) {
+        ++h;
+      }
+
+      return (uint16_t)(sign | h);
+    }
+
+    // Re-bias exponent from 127 to 15; mantissa carry into exponent is fine.
+    uint32_t h = (absx >> 13U) - (112U << 10U);
+    const uint32_t rem = absx & 0x1FFFU;
+    if ((rem > 0x1000U) || ((rem == 0x1000U) && (h & 1U))) {
+      ++h;
+    }
+
+    return (uint16_t)(sign | h);
+  }
+
+  static float decode(const uint16_t &h) {
+    const uint32_t sign = ((uint32_t)h & 0x8000U) << 16U;
+    const uint32_t e = ((uint32_t)h >> 10U) & 0x1FU;
+    const uint32_t m = (uint32_t)h & 0x3FFU;
+
+    if (!e) {
+      const float f = (float)m * 5.9604644775390625e-8f; // 2^-24
+      return sign ? -f : f;
+    }
+
+    const uint32_t x = sign | (m << 13U) |
+                       ((e == 0x1FU) ? 0x7F800000U : ((e + 112U) << 23U));
+    float f;
+    std::memcpy(&f, &x, sizeof(float));
+
+    return f;
+  }
+};
+
+/**
+ * bfloat16 encoding (upper half of binary32, round-to-nearest-even)
+ */
+struct Bf16Codec {
+  static StorageType get_stype() { return REAL_CPU_BF16; }
+
+  static uint16_t encode(const float &f) {
+    uint32_t x;
+    std::memcpy(&x, &f, sizeof(float));
+    if ((x & 0x7FFFFFFFU) > 0x7F800000U) {
+      // Keep NaN quiet (and a NaN)
+      return (uint16_t)((x >> 16U) | 0x40U);
+    }
+
+    return (uint16_t)((x + 0x7FFFU + ((x >> 16U) & 1U)) >> 16U);
+  }
+
+  static float decode(const uint16_t &h) {
+    const uint32_t x = ((uint32_t)h) << 16U;
+    float f;
+    std::memcpy(&f, &x, sizeof(float));
+
+    return f;
+  }
+};
+
+/**
+ * CPU-accessible storage that holds real-value elements at 2 bytes each
+ *
+ * Elements are converted to and from fp32 on every access, so all arithmetic
+ * (and accumulation) happens at single precision; only the resident weights
+ * and memory traffic are halved.
+ */
+template <typename Codec> struct CpuHalfStorage : TypedStorage<real1> {
+  std::unique_ptr<uint16_t[], void (*)(uint16_t *)> data;
+
+  CpuHalfStorage(const tcapint &n)
+      : TypedStorage<real1>(Codec::get_stype(), DeviceTag::CPU, n),
+        data(TypedStorage<uint16_t>::Alloc(n)) {}
+  CpuHalfStorage(const std::vector<uint16_t> &i)
+      : TypedStorage<real1>(Codec::get_stype(), DeviceTag::CPU, i.size()),
+        data(TypedStorage<uint16_t>::Alloc(i.size())) {
+    std::copy(i.begin(), i.end(), data.get());
+  }
+  CpuHalfStorage(const RealStorage &orig)
+      : TypedStorage<real1>(Codec::get_stype(), DeviceTag::CPU, orig.size),
+        data(TypedStorage<uint16_t>::Alloc(orig.size)) {
+    for (tcapint i = 0U; i < size; ++i) {
+      data[i] = Codec::encode((float)orig[i]);
+    }
+  }
+
+  /**
+   * Decode the element at the position to fp32
+   */
+  float get(const tcapint &idx) const {
+    return Codec::decode(data.get()[(size_t)idx]);
+  }
+
+  real1 operator[](const tcapint &idx) const override {
+    if (idx >= size) {
+      throw std::invalid_argument(
+          "CpuHalfStorage::operator[] argument out-of-bounds!");
+    }
+
+    return (real1)get(idx);
+  }
+
+  void write(const tcapint &idx, const real1 &val) override {
+    if (idx >= size) {
+      throw std::invalid_argument(
+          "CpuHalfStorage::write(i, v) index out-of-bounds!");
+    }
+
+    data.get()[(size_t)idx] = Codec::encode((float)val);
+  }
+
+  void add(const tcapint &idx, const real1 &val) override {
+    if (idx >= size) {
+      throw std::invalid_argument(
+          "CpuHalfStorage::add(i, v) index out-of-bounds!");
+    }
+
+    data.get()[(size_t)idx] = Codec::encode(get(idx) + (float)val);
+  }
+
+  void FillValue(const real1 &v) override {
+    std::fill(data.get(), data.get() + size, Codec::encode((float)v));
+  }
+
+  StoragePtr Upcast(const DType &dt) override;
+
+  bool is_gpu() override { return false; }
+
+  StoragePtr cpu() override { return get_ptr(); }
+
+  StoragePtr gpu(const int64_t &did = -1) override;
+
+  void save(std::ostream &os) const override {
+    Storage::save(os);
+    write_payload(os, data.get(), sizeof(uint16_t), size);
+  }
+};
+typedef CpuHalfStorage<Fp16Codec> CpuFp16Storage;
+typedef CpuHalfStorage<Bf16Codec> CpuBf16Storage;
+typedef std::shared_ptr<CpuFp16Storage> CpuFp16StoragePtr;
+typedef std::shared_ptr<CpuBf16Storage> CpuBf16StoragePtr;
+
+/**
+ * Re-encode a CPU real-value storage as REAL_CPU_DENSE, REAL_CPU_FP16, or
+ * REAL_CPU_BF16
+ */
+StoragePtr cast_cpu_real_storage(const StoragePtr &s, const StorageType &st);
+} // namespace Weed
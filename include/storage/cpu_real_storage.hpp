@@ -24,6 +24,8 @@ struct CpuRealStorage : CpuStorage<real1> {
   CpuRealStorage(const tcapint &n) : CpuStorage<real1>(REAL_CPU_DENSE, n) {}
   CpuRealStorage(const std::vector<real1> &i)
       : CpuStorage<real1>(REAL_CPU_DENSE, i) {}
+  CpuRealStorage(const tcapint &n, real1 *external)
+      : CpuStorage<real1>(REAL_CPU_DENSE, n, external) {}
   StoragePtr Upcast(const DType &dt) override;
   StoragePtr gpu(const int64_t &did = -1) override;
   void save(std::ostream &) const override;
@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include "storage/cpu_arena.hpp"
+#include "storage/memory_plan.hpp"
 #include "storage/typed_storage.hpp"
 
 #include <vector>
@@ -23,13 +25,45 @@ template <typename T> struct CpuStorage : TypedStorage<T> {
   std::unique_ptr<T[], void (*)(T *)> data;
   CpuStorage(const StorageType &stp, const tcapint &n)
       : TypedStorage<T>(stp, DeviceTag::CPU, n),
-        data(TypedStorage<T>::Alloc(n)) {}
+        data(ArenaAlloc(n)) {}
   CpuStorage(const StorageType &stp, const std::vector<T> &i)
       : TypedStorage<T>(stp, DeviceTag::CPU, i.size()),
-        data(TypedStorage<T>::Alloc(i.size())) {
+        data(ArenaAlloc(i.size())) {
     std::copy(i.begin(), i.end(), data.get());
   }
 
+  /**
+   * Wrap memory owned elsewhere (like an arena or a file mapping)
+   */
+  CpuStorage(const StorageType &stp, const tcapint &n, T *external)
+      : TypedStorage<T>(stp, DeviceTag::CPU, n), data(external, null_deleter) {}
+
+  static void null_deleter(T *c) {}
+  static void plan_deleter(T *c) { MemoryPlan::notify_free(c); }
+
+  /**
+   * Allocate from the MemoryPlan or CpuArena bound on this thread, if any,
+   * else the heap
+   */
+  static std::unique_ptr<T[], void (*)(T *)> ArenaAlloc(tcapint elemCount) {
+    MemoryPlan *plan = MemoryPlan::current();
+    if (plan) {
+      T *p = (T *)plan->allocate(sizeof(T) * elemCount);
+      if (p) {
+        return std::unique_ptr<T[], void (*)(T *)>(
+            p, plan->is_recording() ? plan_deleter : null_deleter);
+      }
+    }
+
+    CpuArena *arena = CpuArena::current();
+    if (!arena) {
+      return TypedStorage<T>::Alloc(elemCount);
+    }
+
+    return std::unique_ptr<T[], void (*)(T *)>(
+        (T *)arena->allocate(sizeof(T) * elemCount), null_deleter);
+  }
+
   T operator[](const tcapint &idx) const override {
     if (idx >= TypedStorage<T>::size) {
       throw std::invalid_argument(
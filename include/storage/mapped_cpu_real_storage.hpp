@@ -0,0 +1,70 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include "storage/cpu_real_storage.hpp"
+
+#include <string>
+
+namespace Weed {
+struct MappedFile;
+typedef std::shared_ptr<MappedFile> MappedFilePtr;
+
+/**
+ * Whole-file private memory mapping
+ *
+ * Pages are shared with the page cache (and other processes mapping the same
+ * file) until written, at which point they become private copies; the file
+ * itself is never modified.
+ */
+struct MappedFile {
+  unsigned char *base;
+  size_t length;
+
+  MappedFile(const std::string &path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  /**
+   * The mapping that Storage::load() may alias on the calling thread, (or
+   * nullptr)
+   */
+  static MappedFilePtr current();
+};
+
+/**
+ * RAII scope that lets Storage::load() alias REAL_CPU_ALIGNED blobs from a
+ * MappedFile on the calling thread (instead of copying them)
+ */
+struct MappedLoadScope {
+  MappedFilePtr prior;
+
+  MappedLoadScope(const MappedFilePtr &m);
+  ~MappedLoadScope();
+
+  MappedLoadScope(const MappedLoadScope &) = delete;
+  MappedLoadScope &operator=(const MappedLoadScope &) = delete;
+};
+
+/**
+ * CpuRealStorage that aliases a region of a MappedFile (and keeps it alive)
+ */
+struct MappedCpuRealStorage : CpuRealStorage {
+  MappedFilePtr file;
+
+  MappedCpuRealStorage(const MappedFilePtr &f, real1 *p, const tcapint &n)
+      : CpuRealStorage(n, p), file(f) {}
+};
+typedef std::shared_ptr<MappedCpuRealStorage> MappedCpuRealStoragePtr;
+} // namespace Weed
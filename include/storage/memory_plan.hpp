@@ -0,0 +1,172 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include "common/weed_types.hpp"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace Weed {
+struct Tensor;
+typedef std::shared_ptr<Tensor> TensorPtr;
+struct SymbolTensor;
+typedef std::shared_ptr<SymbolTensor> SymbolTensorPtr;
+struct MemoryPlan;
+typedef std::shared_ptr<MemoryPlan> MemoryPlanPtr;
+
+/**
+ * Static placement of every dense CPU intermediate of a fixed-shape forward
+ * pass in one reusable slab
+ *
+ * A plan is built in two phases. While recording, every CpuStorage
+ * allocation on the bound thread is logged with its size and lifetime (in
+ * allocation/free events). finalize() then assigns each buffer an offset in
+ * one slab, (greedily, largest first,) so that buffers with disjoint
+ * lifetimes share memory. Afterwards, each bound pass hands out the n-th
+ * allocation at the n-th planned offset, without touching the heap.
+ *
+ * As with CpuArena, this is for eval() inference only: any tensor that must
+ * outlive the pass has to be copied out with persist() before unbinding.
+ */
+struct MemoryPlan {
+  /**
+   * One planned buffer: size, lifetime (as event clock ticks), and offset
+   */
+  struct Interval {
+    size_t bytes;
+    size_t start;
+    size_t end;
+    size_t offset;
+  };
+
+  /**
+   * Input shape the plan was traced at
+   */
+  std::vector<tcapint> shape;
+  /**
+   * Planned buffers, in allocation order
+   */
+  std::vector<Interval> intervals;
+
+protected:
+  bool recording;
+  bool bound;
+  size_t clock;
+  size_t cursor;
+  size_t misses;
+  size_t slab_bytes;
+  size_t live_peak_bytes;
+  std::map<const void *, size_t> live;
+  std::vector<std::unique_ptr<unsigned char[], void (*)(unsigned char *)>>
+      scratch;
+  std::unique_ptr<unsigned char[], void (*)(unsigned char *)> slab;
+
+  friend struct MemoryPlanGuard;
+
+public:
+  MemoryPlan(const std::vector<tcapint> &shp);
+
+  MemoryPlan(const MemoryPlan &) = delete;
+  MemoryPlan &operator=(const MemoryPlan &) = delete;
+
+  /**
+   * Allocate (WEED_ALIGN_SIZE-aligned) bytes, or return nullptr if a
+   * finalized plan has no slot for this request
+   */
+  void *allocate(size_t bytes);
+
+  /**
+   * Log the release of a buffer handed out while recording
+   */
+  void deallocate(const void *p);
+
+  /**
+   * Stop recording, and assign every logged buffer to a slab offset
+   */
+  void finalize();
+
+  /**
+   * Is the plan still logging allocations (i.e., not yet finalized)?
+   */
+  bool is_recording() const { return recording; }
+
+  /**
+   * Is this pointer inside the slab?
+   */
+  bool owns(const void *p) const;
+
+  /**
+   * Slab size: the peak bytes the planned forward pass will use
+   */
+  size_t get_peak() const { return slab_bytes; }
+
+  /**
+   * Lower bound on the peak: the most bytes simultaneously live
+   */
+  size_t get_live_peak() const { return live_peak_bytes; }
+
+  /**
+   * Bytes the same pass would allocate with no buffer reuse
+   */
+  size_t get_unplanned_bytes() const;
+
+  /**
+   * Allocations of planned passes that didn't match the plan (and so went
+   * to the heap)
+   */
+  size_t get_misses() const { return misses; }
+
+  /**
+   * The plan bound on the calling thread, (or nullptr)
+   */
+  static MemoryPlan *current();
+
+  /**
+   * Bind (or, with nullptr, unbind) a plan on the calling thread, without
+   * resetting it
+   */
+  static void set_current(MemoryPlan *p);
+
+  /**
+   * Deleter hook for buffers handed out while recording
+   */
+  static void notify_free(const void *p);
+
+  /**
+   * If the tensor's storage lives in the currently-bound plan's slab, return
+   * a detached heap copy; otherwise, return the tensor unchanged
+   */
+  static TensorPtr persist(const TensorPtr &t);
+  /**
+   * If the symbol tensor's storage lives in the currently-bound plan's slab,
+   * return a detached heap copy; otherwise, return the tensor unchanged
+   */
+  static SymbolTensorPtr persist(const SymbolTensorPtr &t);
+};
+
+/**
+ * RAII scope that binds a MemoryPlan to the calling thread, from the start of
+ * its allocation sequence
+ */
+struct MemoryPlanGuard {
+  MemoryPlan &plan;
+  MemoryPlan *prior;
+
+  MemoryPlanGuard(MemoryPlan &p);
+  ~MemoryPlanGuard();
+
+  MemoryPlanGuard(const MemoryPlanGuard &) = delete;
+  MemoryPlanGuard &operator=(const MemoryPlanGuard &) = delete;
+};
+} // namespace Weed
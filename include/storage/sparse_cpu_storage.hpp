@@ -11,8 +11,13 @@
 
 #pragma once
 
+#include "common/serializer.hpp"
 #include "storage/typed_storage.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 namespace Weed {
 /**
  * CPU-accessible sparse storage for real-value data type elements
@@ -29,6 +34,53 @@ template <typename T> struct SparseCpuStorage : TypedStorage<T> {
 
   bool is_sparse() const override { return default_value == T(); }
 
+  /**
+   * Serialize entries as one block of key-sorted (key, value) pairs; a
+   * non-default fill value is kept as a trailing pair with key == size
+   */
+  void save_entries(std::ostream &os) const {
+    const size_t entry = sizeof(tcapint) + sizeof(T);
+    std::vector<std::pair<tcapint, T>> v(data.begin(), data.end());
+    std::sort(v.begin(), v.end(),
+              [](const std::pair<tcapint, T> &a,
+                 const std::pair<tcapint, T> &b) { return a.first < b.first; });
+    if (!(default_value == T())) {
+      v.emplace_back(this->size, default_value);
+    }
+    std::vector<char> buf(entry * v.size());
+    for (size_t i = 0U; i < v.size(); ++i) {
+      char *b = buf.data() + i * entry;
+      std::memcpy(b, &(v[i].first), sizeof(tcapint));
+      std::memcpy(b + sizeof(tcapint), &(v[i].second), sizeof(T));
+    }
+    Serializer::write_tcapint(os, (tcapint)v.size());
+    Storage::write_payload(os, buf.data(), entry, v.size());
+  }
+
+  /**
+   * Load entries written by save_entries() (or by older per-entry saves)
+   */
+  void load_entries(std::istream &is, const bool &has_header) {
+    const size_t entry = sizeof(tcapint) + sizeof(T);
+    tcapint ksize;
+    Serializer::read_tcapint(is, ksize);
+    std::vector<char> buf(entry * ksize);
+    Storage::read_payload(is, buf.data(), entry, ksize, has_header);
+    data.reserve(ksize);
+    tcapint k;
+    T val;
+    for (tcapint i = 0U; i < ksize; ++i) {
+      const char *b = buf.data() + i * entry;
+      std::memcpy(&k, b, sizeof(tcapint));
+      std::memcpy(&val, b + sizeof(tcapint), sizeof(T));
+      if (k < this->size) {
+        data[k] = val;
+      } else {
+        default_value = val;
+      }
+    }
+  }
+
   bool is_gpu() override { return false; }
 
   /**
@@ -19,6 +19,15 @@
 namespace Weed {
 struct Storage;
 
+/**
+ * Optional per-payload header: element size, byte order, and checksum
+ */
+struct BlobHeader {
+  uint8_t elem_size;
+  uint8_t endianness;
+  uint64_t checksum;
+};
+
 typedef std::shared_ptr<Storage> StoragePtr;
 
 /**
@@ -112,6 +121,59 @@ struct Storage : public std::enable_shared_from_this<Storage> {
    */
   static StoragePtr load(std::istream &);
 
+  /**
+   * While set (on the calling thread), dense real CPU storage serializes as
+   * a contiguous REAL_CPU_ALIGNED blob that can be memory-mapped on load
+   */
+  static void set_aligned_blobs(const bool &b);
+
+  /**
+   * Is aligned blob serialization set on the calling thread?
+   */
+  static bool get_aligned_blobs();
+
+  /**
+   * While set (on the calling thread), every serialized payload is preceded
+   * by a BlobHeader that is validated on load
+   */
+  static void set_blob_headers(const bool &b);
+
+  /**
+   * Are blob headers set on the calling thread?
+   */
+  static bool get_blob_headers();
+
+  /**
+   * Write a BlobHeader for a payload of bytes at p
+   */
+  static void write_blob_header(std::ostream &out, const size_t &elem_size,
+                                const void *p, const size_t &bytes);
+
+  /**
+   * Read a BlobHeader, checking element size and byte order
+   */
+  static BlobHeader read_blob_header(std::istream &in,
+                                     const size_t &elem_size);
+
+  /**
+   * Throw if the payload of bytes at p does not match the header checksum
+   */
+  static void check_blob(const BlobHeader &h, const void *p,
+                         const size_t &bytes);
+
+  /**
+   * Write n elements of elem_size bytes as one block (with header, if set)
+   */
+  static void write_payload(std::ostream &out, const void *p,
+                            const size_t &elem_size, const size_t &n);
+
+  /**
+   * Read n elements of elem_size bytes as one block (checking the header,
+   * if present)
+   */
+  static void read_payload(std::istream &in, void *p, const size_t &elem_size,
+                           const size_t &n, const bool &has_header);
+
   /**
    * Static helper function for storage serialization to ostream
    */
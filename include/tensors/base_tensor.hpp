@@ -99,6 +99,28 @@ struct BaseTensor {
    */
   bool is_contiguous() const { return !offset && is_contiguous(shape, stride); }
 
+  /**
+   * Does this Tensor broadcast (i.e., have a zero stride on any index of
+   * extent greater than 1)?
+   */
+  bool is_broadcast() const {
+    for (size_t i = 0U; i < shape.size(); ++i) {
+      if ((shape[i] > 1U) && !stride[i]) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /**
+   * Does each index address its own storage element, densely packed from the
+   * offset (i.e., is this Tensor contiguous and not broadcast)?
+   */
+  bool is_packed() const {
+    return is_contiguous(shape, stride) && !is_broadcast();
+  }
+
   /**
    * Is this Tensor a Scalar (i.e., has only a single storage element that's
    * broadcast)?
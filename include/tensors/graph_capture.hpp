@@ -0,0 +1,79 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include "tensors/tensor.hpp"
+
+#include <functional>
+
+/**
+ * Run a kernel launch, and also record it if a graph capture is active
+ */
+#define WEED_LAUNCH(...)                                                       \
+  __VA_ARGS__;                                                                 \
+  if (Weed::GraphRecorder::is_active()) {                                      \
+    Weed::GraphRecorder::record([=]() { __VA_ARGS__; });                       \
+  }
+
+namespace Weed {
+struct CapturedGraph;
+typedef std::shared_ptr<CapturedGraph> CapturedGraphPtr;
+
+/**
+ * Thread-local recorder of kernel launches, active during Module::capture()
+ */
+struct GraphRecorder {
+  static bool is_active() { return slot(); }
+  static void record(const std::function<void()> &f) { slot()->push_back(f); }
+
+  /**
+   * Record launches into l (or stop recording, if l is null)
+   */
+  static void set(std::vector<std::function<void()>> *l) { slot() = l; }
+
+private:
+  static std::vector<std::function<void()>> *&slot() {
+    static thread_local std::vector<std::function<void()>> *launches = nullptr;
+    return launches;
+  }
+};
+
+/**
+ * The kernel launches of one forward() at a fixed input shape, replayable on
+ * new inputs of that shape with the same (preplanned) buffers
+ */
+struct CapturedGraph {
+  /**
+   * Dense, contiguous CPU input buffer that replay() copies new inputs into
+   */
+  BaseTensorPtr input;
+  /**
+   * Output buffer (overwritten by every replay)
+   */
+  TensorPtr output;
+  /**
+   * Kernel launches, in order
+   */
+  std::vector<std::function<void()>> launches;
+
+  /**
+   * Copy x (with the captured shape and storage type) into the input buffer
+   */
+  void set_input(const BaseTensorPtr &x);
+
+  /**
+   * Run the captured launches on x, which must have the captured shape and
+   * dtype. The returned output is reused by the next replay.
+   */
+  TensorPtr replay(const BaseTensorPtr &x);
+};
+} // namespace Weed
@@ -0,0 +1,168 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#pragma once
+
+#include "tensors/tensor.hpp"
+
+namespace Weed {
+/**
+ * Thread-local switch for lazy evaluation: while enabled, composite
+ * elementwise ops (gelu, RMSNorm, LayerNorm) build a LazyExpr and run it as a
+ * single fused kernel, instead of one kernel and one buffer per primitive
+ */
+struct LazyMode {
+  static bool is_enabled() { return flag(); }
+  static void set_enabled(const bool &b) { flag() = b; }
+
+private:
+  static bool &flag() {
+    static thread_local bool enabled = false;
+    return enabled;
+  }
+};
+
+/**
+ * Enable lazy evaluation on the calling thread for the lifetime of this guard
+ */
+struct LazyModeGuard {
+  const bool prior;
+  LazyModeGuard() : prior(LazyMode::is_enabled()) {
+    LazyMode::set_enabled(true);
+  }
+  ~LazyModeGuard() { LazyMode::set_enabled(prior); }
+  LazyModeGuard(const LazyModeGuard &) = delete;
+  LazyModeGuard &operator=(const LazyModeGuard &) = delete;
+};
+
+enum LazyOp {
+  LAZY_LEAF = 0,
+  LAZY_CONST = 1,
+  LAZY_ADD = 2,
+  LAZY_SUB = 3,
+  LAZY_MUL = 4,
+  LAZY_DIV = 5,
+  LAZY_POW = 6,
+  LAZY_TANH = 7,
+  LAZY_EXP = 8,
+  LAZY_SIGMOID = 9,
+  LAZY_RELU = 10
+};
+
+struct LazyExpr;
+typedef std::shared_ptr<LazyExpr> LazyExprPtr;
+
+/**
+ * Node of a deferred DAG of elementwise and broadcast ops over real-valued
+ * tensors
+ *
+ * Nothing is computed until materialize(), which compiles the whole DAG into
+ * one loop over the broadcast output shape. Constant operands are folded as
+ * the graph is built.
+ */
+struct LazyExpr {
+  LazyOp op;
+  /**
+   * Input tensor (LAZY_LEAF only)
+   */
+  TensorPtr tensor;
+  /**
+   * Constant value (LAZY_CONST), or exponent (LAZY_POW)
+   */
+  real1 value;
+  std::vector<LazyExprPtr> args;
+
+  LazyExpr(const LazyOp &o, const std::vector<LazyExprPtr> &a,
+           const real1 &v = ZERO_R1)
+      : op(o), value(v), args(a) {}
+
+  static LazyExprPtr leaf(const TensorPtr t) {
+    LazyExprPtr e = std::make_shared<LazyExpr>(LAZY_LEAF,
+                                               std::vector<LazyExprPtr>());
+    e->tensor = t;
+    return e;
+  }
+  static LazyExprPtr constant(const real1 &v) {
+    return std::make_shared<LazyExpr>(LAZY_CONST, std::vector<LazyExprPtr>(),
+                                      v);
+  }
+
+  static LazyExprPtr binary(const LazyOp &o, const LazyExprPtr l,
+                            const LazyExprPtr r);
+  static LazyExprPtr unary(const LazyOp &o, const LazyExprPtr a,
+                           const real1 &v = ZERO_R1);
+
+  static LazyExprPtr pow(const LazyExprPtr a, const real1 &p) {
+    return unary(LAZY_POW, a, p);
+  }
+  static LazyExprPtr tanh(const LazyExprPtr a) { return unary(LAZY_TANH, a); }
+  static LazyExprPtr exp(const LazyExprPtr a) { return unary(LAZY_EXP, a); }
+  static LazyExprPtr sigmoid(const LazyExprPtr a) {
+    return unary(LAZY_SIGMOID, a);
+  }
+  static LazyExprPtr relu(const LazyExprPtr a) { return unary(LAZY_RELU, a); }
+
+  /**
+   * Evaluate the DAG into a new tensor
+   *
+   * If every leaf is a real-valued CPU tensor and no leaf needs autograd, this
+   * launches a single fused kernel into one dense output buffer. Otherwise,
+   * the DAG is evaluated op-by-op with the regular (autograd-aware) Tensor
+   * operations.
+   */
+  TensorPtr materialize() const;
+
+  /**
+   * Evaluate op-by-op with the regular Tensor operations
+   */
+  TensorPtr eager() const;
+};
+
+inline LazyExprPtr operator+(LazyExprPtr l, LazyExprPtr r) {
+  return LazyExpr::binary(LAZY_ADD, l, r);
+}
+inline LazyExprPtr operator+(real1 l, LazyExprPtr r) {
+  return LazyExpr::binary(LAZY_ADD, LazyExpr::constant(l), r);
+}
+inline LazyExprPtr operator+(LazyExprPtr l, real1 r) {
+  return LazyExpr::binary(LAZY_ADD, l, LazyExpr::constant(r));
+}
+inline LazyExprPtr operator-(LazyExprPtr l, LazyExprPtr r) {
+  return LazyExpr::binary(LAZY_SUB, l, r);
+}
+inline LazyExprPtr operator-(real1 l, LazyExprPtr r) {
+  return LazyExpr::binary(LAZY_SUB, LazyExpr::constant(l), r);
+}
+inline LazyExprPtr operator-(LazyExprPtr l, real1 r) {
+  return LazyExpr::binary(LAZY_SUB, l, LazyExpr::constant(r));
+}
+inline LazyExprPtr operator*(LazyExprPtr l, LazyExprPtr r) {
+  return LazyExpr::binary(LAZY_MUL, l, r);
+}
+inline LazyExprPtr operator*(real1 l, LazyExprPtr r) {
+  return LazyExpr::binary(LAZY_MUL, LazyExpr::constant(l), r);
+}
+inline LazyExprPtr operator*(LazyExprPtr l, real1 r) {
+  return LazyExpr::binary(LAZY_MUL, l, LazyExpr::constant(r));
+}
+inline LazyExprPtr operator/(LazyExprPtr l, LazyExprPtr r) {
+  return LazyExpr::binary(LAZY_DIV, l, r);
+}
+inline LazyExprPtr operator/(real1 l, LazyExprPtr r) {
+  return LazyExpr::binary(LAZY_DIV, LazyExpr::constant(l), r);
+}
+inline LazyExprPtr operator/(LazyExprPtr l, real1 r) {
+  return LazyExpr::binary(LAZY_DIV, l, LazyExpr::constant(r));
+}
+inline LazyExprPtr operator^(LazyExprPtr base, real1 power) {
+  return LazyExpr::pow(base, power);
+}
+} // namespace Weed
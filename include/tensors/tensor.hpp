@@ -92,8 +92,30 @@ struct Tensor : public BaseTensor {
     return add(z, a);
   }
 
+  /**
+   * Attach a gradient to this tensor (if it requires one). Dense gradients
+   * are deferred until materialize_gradient(), at first accumulation.
+   */
   void make_gradient(const bool &force_sparse = false);
 
+  /**
+   * Allocate the buffer of a deferred gradient (for internal use by autograd)
+   *
+   * If "reduced," a CPU gradient is kept (or allocated) summed over this
+   * tensor's broadcast indices, for nodes that accumulate into it that way.
+   */
+  void materialize_gradient(const bool &reduced = false);
+
+  /**
+   * Is the gradient already summed over this tensor's broadcast indices?
+   */
+  bool is_grad_reduced() const;
+
+  /**
+   * Device for this tensor's gradient buffer (by the GSTRIDE rule)
+   */
+  DeviceTag gradient_dtag() const;
+
   /**
    * For broadcast, make this scalar match the shape of a target Tensor
    */
@@ -230,6 +252,71 @@ struct Tensor : public BaseTensor {
   static TensorPtr one_hot(const SymbolTensorPtr targets,
                            const tcapint vocab_size);
 
+  /**
+   * Fused cross-entropy loss, -mean(logsoftmax(logits)[row, targets[row]])
+   * over the last axis (dense CPU real logits only, per can_cross_entropy())
+   */
+  static TensorPtr cross_entropy(const TensorPtr logits,
+                                 const SymbolTensorPtr targets);
+  /**
+   * Fused cross-entropy loss of the logits x * w + b (b may be null), over
+   * vocabulary chunks, so that the full logits are never held (CPU only, per
+   * can_linear_cross_entropy())
+   */
+  static TensorPtr linear_cross_entropy(const TensorPtr x, const TensorPtr w,
+                                        const TensorPtr b,
+                                        const SymbolTensorPtr targets,
+                                        const tcapint &chunk);
+  /**
+   * Fused RMSNorm over the last axis, x * rsqrt(mean(x^2) + eps) * w, with an
+   * analytic backward (CPU only, per can_fused_norm())
+   */
+  static TensorPtr rms_norm(const TensorPtr x, const TensorPtr w,
+                            const real1 &eps);
+  /**
+   * Fused LayerNorm over the last axis, (x - mean) * rsqrt(var + eps) * gamma
+   * + beta, with an analytic backward (CPU only, per can_fused_norm())
+   */
+  static TensorPtr layer_norm(const TensorPtr x, const TensorPtr gamma,
+                              const TensorPtr beta, const real1 &eps);
+  /**
+   * Fused SwiGLU activation of x, silu(x * wg) * (x * wu), with an analytic
+   * backward (CPU only, per can_swiglu())
+   */
+  static TensorPtr swiglu(const TensorPtr x, const TensorPtr wg,
+                          const TensorPtr wu);
+  /**
+   * Fused rotary position embedding of x [B, H, T, head_dim], at positions
+   * pos to pos + T of the tables, with an analytic backward (CPU only, per
+   * can_rope())
+   */
+  static TensorPtr rope(const TensorPtr x, const TensorPtr cos_table,
+                        const TensorPtr sin_table, const tcapint &pos);
+  /**
+   * Fused dropout, x * mask / (1 - p), with the mask drawn from (and, for
+   * backward, regenerated from) the Philox stream (seed, stream) (CPU only,
+   * per can_dropout())
+   */
+  static TensorPtr dropout(const TensorPtr x, const real1 &p,
+                           const uint64_t &seed, const uint64_t &stream);
+  /**
+   * Fused LSTM over x [B, T, in] from state (h0, c0) [B, H], treated as
+   * constant, with backward through time in one node (CPU only, per
+   * can_rnn_sequence()). Returns {h [B, T, H], h_T, c_T}, the last two
+   * without gradient.
+   */
+  static std::vector<TensorPtr>
+  lstm_sequence(const TensorPtr x, const TensorPtr wx, const TensorPtr bx,
+                const TensorPtr wh, const TensorPtr bh, const TensorPtr h0,
+                const TensorPtr c0);
+  /**
+   * Fused GRU over x [B, T, in] from state h0 [B, H], as for lstm_sequence().
+   * Returns {h [B, T, H], h_T}.
+   */
+  static std::vector<TensorPtr>
+  gru_sequence(const TensorPtr x, const TensorPtr wx, const TensorPtr bx,
+               const TensorPtr wh, const TensorPtr bh, const TensorPtr h0);
+
   /**
    * Make a gradient tensor (static)
    */
@@ -161,7 +161,8 @@ const std::vector<OCLKernelHandle> OCLEngine::kernelHandles{
     OCLKernelHandle(OCL_API_LOGSOFTMAX, "logsoftmax"),
     OCLKernelHandle(OCL_API_LOGSOFTMAX_BACKWARD_REAL, "logsoftmax_backward_real"),
     OCLKernelHandle(OCL_API_LOGSOFTMAX_BACKWARD_COMPLEX, "logsoftmax_backward_complex"),
-    OCLKernelHandle(OCL_API_LOGSOFTMAX_BACKWARD_MIXED, "logsoftmax_backward_mixed")
+    OCLKernelHandle(OCL_API_LOGSOFTMAX_BACKWARD_MIXED, "logsoftmax_backward_mixed"),
+    OCLKernelHandle(OCL_API_ADAM_UPDATE_REAL, "adam_update_real")
 };
 // clang-format on
 
@@ -131,6 +131,35 @@ void ParallelFor::par_for_inc(const tcapint &begin, const tcapint &itemCount,
     future.get();
   }
 }
+
+void ParallelFor::par_for_blocks(const tcapint &begin, const tcapint &end,
+                                 BlockFunc fn) {
+  const tcapint itemCount = end - begin;
+  unsigned threads = (unsigned)(itemCount / pStride);
+  if (threads > numCores) {
+    threads = numCores;
+  }
+
+  if (threads <= 1U) {
+    fn(begin, end, 0U);
+
+    return;
+  }
+
+  const tcapint block = (itemCount + threads - 1U) / threads;
+  std::vector<std::future<void>> futures;
+  futures.reserve(threads);
+  for (unsigned cpu = 0U; cpu != threads; ++cpu) {
+    const tcapint b = begin + cpu * block;
+    const tcapint e = ((b + block) < end) ? (b + block) : end;
+    futures.emplace_back(std::async(std::launch::async,
+                                    [b, e, cpu, &fn]() { fn(b, e, cpu); }));
+  }
+
+  for (std::future<void> &future : futures) {
+    future.get();
+  }
+}
 #else
 /*
  * Iterate through the permutations a maximum of end-begin times, allowing the
@@ -143,6 +172,11 @@ void ParallelFor::par_for_inc(const tcapint &begin, const tcapint &itemCount,
     fn(inc(j), 0U);
   }
 }
+
+void ParallelFor::par_for_blocks(const tcapint &begin, const tcapint &end,
+                                 BlockFunc fn) {
+  fn(begin, end, 0U);
+}
 #endif
 
 ParallelFor pfControl;
@@ -1249,3 +1249,15 @@ kernel void logsoftmax_backward_mixed(global cmplx *dx, global const real1 *out,
             exp(out[out_base + i * out_stride]) * sum_dy;
     }
 }
+
+// Fused Adam(W) step: c holds beta1, beta2, 1 - beta1, 1 - beta2, lr / bc1, 1 / bc2, eps, L2 decay, decoupled shrink.
+void kernel adam_update_real(global real1* p, global real1* m, global real1* v, global const real1* g, global const real1* c, constant tcapint* vecCapIntArgs)
+{
+    const tcapint i = i_X;
+    const real1 gi = g[O_A + i] + c[7] * p[i];
+    const real1 mi = c[0] * m[i] + c[2] * gi;
+    const real1 vi = c[1] * v[i] + c[3] * gi * gi;
+    m[i] = mi;
+    v[i] = vi;
+    p[i] = c[8] * p[i] - c[4] * mi / ((real1)sqrt((real1_f)(vi * c[5])) + c[6]);
+}
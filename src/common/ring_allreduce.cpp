@@ -0,0 +1,251 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2017-2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#include "common/ring_allreduce.hpp"
+
+#include <stdexcept>
+
+#if (defined(_WIN32) && !defined(__CYGWIN__)) || defined(__EMSCRIPTEN__)
+#define IS_RING_SUPPORTED 0
+#else
+#define IS_RING_SUPPORTED 1
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace Weed {
+#if IS_RING_SUPPORTED
+static sockaddr_un ring_address(const std::string &prefix, const tcapint &r) {
+  const std::string path = prefix + "." + std::to_string(r);
+  sockaddr_un addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    throw std::invalid_argument("RingAllReduce socket path is too long!");
+  }
+  std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1U);
+
+  return addr;
+}
+
+static void set_timeout(const int &fd, const int &timeout_ms) {
+  timeval tv;
+  tv.tv_sec = timeout_ms / 1000;
+  tv.tv_usec = (timeout_ms % 1000) * 1000;
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+static void send_all(const int &fd, const char *buf, size_t len) {
+  while (len) {
+    const ssize_t s = send(fd, buf, len, MSG_NOSIGNAL);
+    if (s <= 0) {
+      throw std::domain_error("RingAllReduce peer closed or timed out!");
+    }
+    buf += s;
+    len -= (size_t)s;
+  }
+}
+
+static void recv_all(const int &fd, char *buf, size_t len) {
+  while (len) {
+    const ssize_t r = recv(fd, buf, len, 0);
+    if (r <= 0) {
+      throw std::domain_error("RingAllReduce peer closed or timed out!");
+    }
+    buf += r;
+    len -= (size_t)r;
+  }
+}
+
+RingAllReduce::RingAllReduce(const std::string &prefix, const tcapint &r,
+                             const tcapint &w, const int &timeout_ms)
+    : rank(r), world_size(w), next_fd(-1), prev_fd(-1) {
+  if (!w || (r >= w)) {
+    throw std::invalid_argument("RingAllReduce rank out of range!");
+  }
+  if (w == 1U) {
+    return;
+  }
+
+  // Listen first, so the previous rank's connect() can complete before we
+  // accept() it.
+  const sockaddr_un self = ring_address(prefix, r);
+  unlink(self.sun_path);
+  const int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if ((listen_fd < 0) ||
+      bind(listen_fd, (const sockaddr *)&self, sizeof(self)) ||
+      listen(listen_fd, 1)) {
+    if (listen_fd >= 0) {
+      close(listen_fd);
+    }
+    throw std::domain_error("RingAllReduce failed to listen at " +
+                            std::string(self.sun_path));
+  }
+  set_timeout(listen_fd, timeout_ms);
+
+  // The next rank might not be listening yet.
+  const sockaddr_un next = ring_address(prefix, (r + 1U) % w);
+  const auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(timeout_ms);
+  for (;;) {
+    next_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if ((next_fd >= 0) &&
+        !connect(next_fd, (const sockaddr *)&next, sizeof(next))) {
+      break;
+    }
+    if (next_fd >= 0) {
+      close(next_fd);
+      next_fd = -1;
+    }
+    if (std::chrono::steady_clock::now() > deadline) {
+      close(listen_fd);
+      unlink(self.sun_path);
+      throw std::domain_error("RingAllReduce failed to connect to " +
+                              std::string(next.sun_path));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  prev_fd = accept(listen_fd, nullptr, nullptr);
+  close(listen_fd);
+  unlink(self.sun_path);
+  if (prev_fd < 0) {
+    close(next_fd);
+    next_fd = -1;
+    throw std::domain_error("RingAllReduce timed out waiting for rank " +
+                            std::to_string((r + w - 1U) % w));
+  }
+
+  set_timeout(next_fd, timeout_ms);
+  set_timeout(prev_fd, timeout_ms);
+}
+
+RingAllReduce::~RingAllReduce() {
+  if (next_fd >= 0) {
+    close(next_fd);
+  }
+  if (prev_fd >= 0) {
+    close(prev_fd);
+  }
+}
+
+void RingAllReduce::exchange(const real1 *send, const size_t &send_n,
+                             real1 *recv, const size_t &recv_n) {
+  // Send concurrently, or every rank could block on a full socket buffer.
+  const int fd = next_fd;
+  std::future<void> sent = std::async(std::launch::async, [fd, send, send_n] {
+    send_all(fd, (const char *)send, send_n * sizeof(real1));
+  });
+  try {
+    recv_all(prev_fd, (char *)recv, recv_n * sizeof(real1));
+  } catch (...) {
+    shutdown(next_fd, SHUT_RDWR);
+    sent.wait();
+    throw;
+  }
+  sent.get();
+}
+
+void RingAllReduce::allreduce(real1 *data, const size_t &n) {
+  const tcapint w = world_size;
+  if ((w == 1U) || !n) {
+    return;
+  }
+
+  const auto begin = [&](const tcapint &c) { return (c % w) * n / w; };
+  const auto size = [&](const tcapint &c) {
+    return ((c % w) + 1U) * n / w - begin(c);
+  };
+  std::vector<real1> buf(n / w + 1U);
+
+  // Reduce-scatter: after w - 1 steps, rank r holds the sum of chunk r + 1.
+  for (tcapint s = 0U; s < (w - 1U); ++s) {
+    const tcapint out = rank + w - s;
+    const tcapint in = rank + w - s - 1U;
+    exchange(data + begin(out), size(out), buf.data(), size(in));
+    real1 *d = data + begin(in);
+    const size_t m = size(in);
+    for (size_t i = 0U; i < m; ++i) {
+      d[i] += buf[i];
+    }
+  }
+
+  // All-gather: pass the summed chunks around the ring.
+  for (tcapint s = 0U; s < (w - 1U); ++s) {
+    const tcapint out = rank + w + 1U - s;
+    const tcapint in = rank + w - s;
+    exchange(data + begin(out), size(out), data + begin(in), size(in));
+  }
+}
+
+std::vector<int> RingAllReduce::spawn(const tcapint &w,
+                                      const std::function<void(tcapint)> &fn) {
+  std::vector<pid_t> pids(w, -1);
+  for (tcapint r = 0U; r < w; ++r) {
+    const pid_t pid = fork();
+    if (!pid) {
+      int status = 0;
+      try {
+        fn(r);
+      } catch (...) {
+        status = 1;
+      }
+      std::cout.flush();
+      _exit(status);
+    }
+    pids[r] = pid;
+  }
+
+  std::vector<int> codes(w, -1);
+  for (tcapint r = 0U; r < w; ++r) {
+    if (pids[r] < 0) {
+      continue;
+    }
+    int status = 0;
+    waitpid(pids[r], &status, 0);
+    if (WIFEXITED(status)) {
+      codes[r] = WEXITSTATUS(status);
+    } else if (WIFSIGNALED(status)) {
+      codes[r] = 128 + WTERMSIG(status);
+    }
+  }
+
+  return codes;
+}
+#else
+RingAllReduce::RingAllReduce(const std::string &prefix, const tcapint &r,
+                             const tcapint &w, const int &timeout_ms)
+    : rank(r), world_size(w), next_fd(-1), prev_fd(-1) {
+  if (w > 1U) {
+    throw std::domain_error(
+        "RingAllReduce requires POSIX sockets and processes!");
+  }
+}
+RingAllReduce::~RingAllReduce() {}
+void RingAllReduce::exchange(const real1 *send, const size_t &send_n,
+                             real1 *recv, const size_t &recv_n) {}
+void RingAllReduce::allreduce(real1 *data, const size_t &n) {}
+std::vector<int> RingAllReduce::spawn(const tcapint &w,
+                                      const std::function<void(tcapint)> &fn) {
+  throw std::domain_error("RingAllReduce::spawn() requires POSIX processes!");
+}
+#endif
+} // namespace Weed
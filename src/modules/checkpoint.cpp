@@ -0,0 +1,105 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#include "modules/checkpoint.hpp"
+#include "autograd/grad_hook.hpp"
+#include "autograd/node.hpp"
+#include "common/serializer.hpp"
+#include "ops/in_place.hpp"
+
+namespace Weed {
+/**
+ * Run f(x) without a graph, and attach a node that re-runs it with a graph
+ * and back-propagates through that local graph (x is optional)
+ */
+static TensorPtr
+checkpoint(const TensorPtr &x, const std::vector<ParameterPtr> &params,
+           const std::function<TensorPtr(const TensorPtr &)> &f) {
+  std::vector<TensorPtr> parents;
+  if (x && x->requires_grad) {
+    parents.push_back(x);
+  }
+  for (const ParameterPtr &p : params) {
+    if (p->requires_grad) {
+      parents.push_back(p);
+    }
+  }
+
+  if (!GradMode::is_enabled() || parents.empty()) {
+    return f(x);
+  }
+
+  TensorPtr y;
+  {
+    NoGradGuard no_grad;
+    y = f(x);
+  }
+
+  // Shallow copy, in case f() returned a view of its input
+  TensorPtr out = std::make_shared<Tensor>(*(y.get()));
+  out->grad_node = nullptr;
+  out->grad = nullptr;
+  out->requires_grad = true;
+  out->make_gradient();
+  out->grad_node = std::make_shared<Node>(parents, [x, f, out]() {
+    EnableGradGuard enable_grad;
+
+    // Rebuild the local graph from a detached copy of the input.
+    TensorPtr _x;
+    if (x) {
+      _x = std::make_shared<Tensor>(*(x.get()));
+      _x->grad_node = nullptr;
+      _x->grad = nullptr;
+    }
+    TensorPtr _y = f(_x);
+
+    // Seed the local graph with the upstream gradient: d(sum(y * dy))/dy = dy
+    TensorPtr dy = std::make_shared<Tensor>(*(out->grad.get()));
+    {
+      // Parameter gradients are only final once the outer graph (which
+      // counts this node as one of their consumers) is done with them.
+      GradReadyHookGuard no_hook(nullptr);
+      Tensor::backward(Tensor::sum(Tensor::mul(_y, dy)));
+    }
+
+    if (_x && _x->requires_grad && _x->grad) {
+      const DeviceTag dtag =
+          Tensor::get_dtag_by_presidence({x->grad, _x->grad});
+      TensorPtr x_grad = x->grad->cast(dtag);
+      TensorPtr _x_grad = _x->grad->cast(dtag);
+      x_grad->upcast(_x_grad->storage->dtype);
+      Weed::add_in_place(*(x_grad.get()), *(_x_grad.get()));
+      x->grad = x_grad;
+    }
+  });
+
+  return out;
+}
+
+TensorPtr Checkpoint::forward(const TensorPtr x) {
+  const ModulePtr c = child;
+
+  return checkpoint(x, child->parameters(),
+                    [c](const TensorPtr &_x) { return c->forward(_x); });
+}
+
+TensorPtr Checkpoint::forward(const SymbolTensorPtr x) {
+  const ModulePtr c = child;
+
+  return checkpoint(nullptr, child->parameters(),
+                    [c, x](const TensorPtr &) { return c->forward(x); });
+}
+
+void Checkpoint::save(std::ostream &os) const {
+  Module::save(os);
+  child->save(os);
+}
+} // namespace Weed
@@ -0,0 +1,123 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#include "modules/data_parallel.hpp"
+#include "autograd/grad_hook.hpp"
+#include "autograd/grad_mode.hpp"
+#include "ops/accumulate.hpp"
+#include "storage/cpu_arena.hpp"
+
+#include <sstream>
+
+#if WEED_ENABLE_PTHREAD
+#include <future>
+#endif
+
+namespace Weed {
+DataParallel::DataParallel(const ModulePtr &m, const tcapint &n) : master(m) {
+  if (!n) {
+    throw std::invalid_argument(
+        "DataParallel requires at least one replica!");
+  }
+
+  master->train();
+
+  std::stringstream ss;
+  master->save(ss);
+  const std::string blob = ss.str();
+  replicas.reserve(n);
+  for (tcapint i = 0U; i < n; ++i) {
+    std::istringstream is(blob);
+    replicas.push_back(Module::load(is));
+    replicas.back()->train();
+  }
+
+  sync();
+}
+
+void DataParallel::sync() {
+  const std::vector<ParameterPtr> mp = master->parameters();
+  for (const ModulePtr &r : replicas) {
+    const std::vector<ParameterPtr> rp = r->parameters();
+    if (rp.size() != mp.size()) {
+      throw std::domain_error(
+          "DataParallel replica parameters don't match master!");
+    }
+    for (size_t j = 0U; j < mp.size(); ++j) {
+      rp[j]->storage = mp[j]->storage;
+      rp[j]->shape = mp[j]->shape;
+      rp[j]->stride = mp[j]->stride;
+      rp[j]->offset = mp[j]->offset;
+    }
+  }
+}
+
+void DataParallel::backward(const LossFn &loss) {
+  // Gradients outlive any arena (or memory plan) the caller has bound.
+  ArenaSuspend suspend;
+
+  sync();
+
+  const tcapint n = replicas.size();
+  const real1 scale = ONE_R1 / (real1)n;
+  // Every shard, on whichever thread, runs under the caller's thread-local
+  // autograd state.
+  const bool grad_mode = GradMode::is_enabled();
+  const GradReadyHook::Fn hook = GradReadyHook::get();
+  const auto shard = [&](const tcapint &i) {
+    ArenaSuspend shard_suspend;
+    GradModeGuard mode_guard(grad_mode);
+    GradReadyHookGuard hook_guard(hook);
+    Tensor::backward(scale * loss(replicas[i], i));
+  };
+
+#if WEED_ENABLE_PTHREAD
+  // Shard 0 runs on the calling thread.
+  std::vector<std::future<void>> futures;
+  futures.reserve(n - 1U);
+  for (tcapint i = 1U; i < n; ++i) {
+    futures.emplace_back(std::async(std::launch::async, shard, i));
+  }
+  shard(0U);
+  for (std::future<void> &f : futures) {
+    f.get();
+  }
+#else
+  for (tcapint i = 0U; i < n; ++i) {
+    shard(i);
+  }
+#endif
+
+  // All-reduce, into gradient buffers that persist between steps
+  const std::vector<ParameterPtr> mp = master->parameters();
+  std::vector<std::vector<ParameterPtr>> rps;
+  rps.reserve(n);
+  for (const ModulePtr &r : replicas) {
+    rps.push_back(r->parameters());
+  }
+  for (size_t j = 0U; j < mp.size(); ++j) {
+    const ParameterPtr &p = mp[j];
+    p->make_gradient();
+    p->materialize_gradient(true);
+    p->grad->storage->FillZeros();
+    for (tcapint i = 0U; i < n; ++i) {
+      const TensorPtr &g = rps[i][j]->grad;
+      if (!g) {
+        continue;
+      }
+      // (A broadcast parameter's gradient sums over its broadcast indices.)
+      reduce_broadcast_acc(*(p->grad.get()),
+                           *(g->cast(p->grad->storage->device).get()));
+      g->storage->FillZeros();
+    }
+  }
+}
+} // namespace Weed
@@ -0,0 +1,139 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2017-2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#include "modules/distributed_data_parallel.hpp"
+#include "autograd/grad_hook.hpp"
+#include "storage/all_storage.hpp"
+
+#include <future>
+#include <unordered_map>
+
+namespace Weed {
+void DistributedDataParallel::reduce(const std::vector<ParameterPtr> &bucket) {
+  size_t n = 0U;
+  for (const ParameterPtr &p : bucket) {
+    if (p->grad->storage->dtype != DType::REAL) {
+      throw std::domain_error(
+          "DistributedDataParallel supports only real gradients!");
+    }
+    n += p->grad->get_size();
+  }
+
+  // Pack, all-reduce, and unpack the mean (in place, for dense CPU gradients)
+  std::vector<real1> flat(n);
+  size_t pos = 0U;
+  for (const ParameterPtr &p : bucket) {
+    const TensorPtr g = Tensor::contiguous(p->grad);
+    const tcapint sz = g->get_size();
+    if (g->storage->stype == StorageType::REAL_CPU_DENSE) {
+      const real1 *d =
+          static_cast<CpuRealStorage *>(g->storage.get())->data.get() +
+          g->offset;
+      std::copy(d, d + sz, flat.begin() + pos);
+    } else {
+      const RealStorage &s = *static_cast<RealStorage *>(g->storage.get());
+      for (tcapint i = 0U; i < sz; ++i) {
+        flat[pos + i] = s[g->offset + i];
+      }
+    }
+    pos += sz;
+  }
+
+  ring->allreduce(flat.data(), n);
+
+  const real1 scale = ONE_R1 / (real1)ring->world_size;
+  pos = 0U;
+  for (const ParameterPtr &p : bucket) {
+    TensorPtr &g = p->grad;
+    const tcapint sz = g->get_size();
+    if ((g->storage->stype == StorageType::REAL_CPU_DENSE) &&
+        Tensor::is_contiguous(g->shape, g->stride)) {
+      real1 *d = static_cast<CpuRealStorage *>(g->storage.get())->data.get() +
+                 g->offset;
+      for (tcapint i = 0U; i < sz; ++i) {
+        d[i] = scale * flat[pos + i];
+      }
+    } else {
+      std::vector<real1> v(flat.begin() + pos, flat.begin() + pos + sz);
+      for (real1 &x : v) {
+        x *= scale;
+      }
+      g = std::make_shared<Tensor>(v, g->shape, false, DeviceTag::CPU);
+    }
+    pos += sz;
+  }
+}
+
+void DistributedDataParallel::backward(const TensorPtr &loss) {
+  const std::vector<ParameterPtr> params = module->parameters();
+  std::unordered_map<Tensor *, size_t> index;
+  for (size_t i = 0U; i < params.size(); ++i) {
+    index[params[i].get()] = i;
+  }
+  std::vector<bool> is_done(params.size(), false);
+
+  // Buckets all-reduce in order, on a chain of background tasks.
+  std::shared_future<void> last;
+  std::vector<ParameterPtr> bucket;
+  tcapint bucket_elems = 0U;
+  const auto flush = [&]() {
+    if (bucket.empty()) {
+      return;
+    }
+    const std::shared_future<void> prior = last;
+    const std::vector<ParameterPtr> b = bucket;
+    last = std::async(std::launch::async, [this, prior, b]() {
+             if (prior.valid()) {
+               prior.get();
+             }
+             reduce(b);
+           }).share();
+    bucket.clear();
+    bucket_elems = 0U;
+  };
+  const auto add = [&](const size_t &i) {
+    is_done[i] = true;
+    bucket.push_back(params[i]);
+    bucket_elems += params[i]->get_size();
+    if (bucket_elems >= bucket_size) {
+      flush();
+    }
+  };
+
+  {
+    GradReadyHookGuard guard([&](Tensor *t) {
+      const auto it = index.find(t);
+      if ((it != index.end()) && !is_done[it->second] && t->grad) {
+        add(it->second);
+      }
+    });
+    Tensor::backward(loss);
+  }
+
+  // Parameters this loss didn't reach still join (with zero gradient).
+  for (size_t i = 0U; i < params.size(); ++i) {
+    if (is_done[i]) {
+      continue;
+    }
+    const ParameterPtr &p = params[i];
+    p->materialize_gradient();
+    if (!p->grad) {
+      continue;
+    }
+    add(i);
+  }
+  flush();
+
+  if (last.valid()) {
+    last.get();
+  }
+}
+} // namespace Weed
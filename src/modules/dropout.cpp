@@ -15,32 +15,40 @@
 #include <random>
 
 namespace Weed {
+uint64_t Dropout::random_seed() {
+  std::random_device rd;
+
+  return (((uint64_t)rd()) << 32U) | (uint64_t)rd();
+}
+
 TensorPtr Dropout::forward(const TensorPtr x) {
   if (!training || p == ZERO_R1) {
     return x;
   }
 
-  std::uniform_real_distribution<real1_s> dis((real1_s)ZERO_R1,
-                                              (real1_s)ONE_R1);
-  std::random_device rd;
-  std::mt19937 gen(rd());
+  // Each call draws the next mask of the counter-based stream.
+  const uint64_t s = stream++;
 
-  // Fill mask with Bernoulli(1 - p)
-  // mask[i] = 1 with prob (1 - p), else 0
-  const tcapint sz = x->get_broadcast_size();
-  RealSparseVector m;
-  for (tcapint n = 0; n < sz; ++n) {
-    if (dis(gen) > p) {
-      m[n] = ONE_R1;
-    }
+  // One fused pass, with the mask regenerated (not stored) for backward
+  if (can_dropout(*(x.get()))) {
+    return Tensor::dropout(x, p, seed, s);
   }
 
-  // Allocate mask like x (real-valued)
-  mask = std::make_shared<Tensor>(m, x->shape);
+  // Elsewhere, expand the same bitmask into a dense mask like x
+  const tcapint sz = x->get_broadcast_size();
+  const std::vector<uint64_t> bits = dropout_mask(sz, p, seed, s);
+  std::vector<real1> m(sz);
+  for (tcapint n = 0U; n < sz; ++n) {
+    m[n] = ((bits[n >> 6U] >> (n & 63U)) & 1U) ? ONE_R1 : ZERO_R1;
+  }
+  TensorPtr mask = std::make_shared<Tensor>(m, x->shape, false,
+                                            x->storage->device,
+                                            x->storage->get_device_id());
 
   // y = x * mask / (1 - p)
   return (x * mask) / real1(ONE_R1 - p);
 }
+
 void Dropout::save(std::ostream &os) const {
   Module::save(os);
   Serializer::write_real(os, p);
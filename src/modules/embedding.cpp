@@ -31,14 +31,16 @@ TensorPtr Embedding::forward(const SymbolTensorPtr indices) {
   out_shape.push_back(embedding_dim);
   std::vector<tcapint> out_stride = Tensor::full_contiguous_stride(out_shape);
 
-  TensorPtr out = Tensor::allocate_like(
-      out_shape, out_stride, *(weight.get()), weight->storage->dtype,
-      weight->requires_grad, weight->storage->is_sparse());
+  const bool rg = GradMode::is_enabled() && weight->requires_grad;
+  TensorPtr out = Tensor::allocate_like(out_shape, out_stride, *(weight.get()),
+                                        weight->storage->dtype, rg,
+                                        weight->storage->is_sparse());
 
-  Weed::embedding_gather(*(indices.get()), *(weight.get()), *(out.get()));
+  const ParameterPtr w = weight;
+  WEED_LAUNCH(Weed::embedding_gather(*(indices.get()), *(w.get()),
+                                     *(out.get())));
 
-  if (weight->requires_grad) {
-    ParameterPtr w = weight;
+  if (rg) {
     out->make_gradient();
     out->grad_node =
         std::make_shared<Node>(std::vector<TensorPtr>{w}, [indices, w, out]() {
@@ -59,6 +61,8 @@ TensorPtr Embedding::forward(const SymbolTensorPtr indices) {
           w->grad = dW;
           w->reduce_grad_broadcast();
         });
+    out->grad_node->sparse_grad =
+        sparse_grad && (w->storage->device == DeviceTag::CPU);
   }
 
   return out;
@@ -11,34 +11,50 @@
 
 #include "modules/gru.hpp"
 #include "common/serializer.hpp"
+#include "ops/rnn.hpp"
+#include "storage/cpu_arena.hpp"
 
 namespace Weed {
 TensorPtr GRU::forward(const TensorPtr x) {
-  if (state->shape.size() == 1U) {
-    state->shape.insert(state->shape.begin(), x->shape[0U]);
-    state->stride.insert(state->stride.begin(), 0U);
-    state->materialize_broadcast();
+  {
+    // Recurrent state outlives this call, so it must not come from an arena.
+    ArenaSuspend suspend;
+    if (state->shape.size() == 1U) {
+      state->shape.insert(state->shape.begin(), x->shape[0U]);
+      state->stride.insert(state->stride.begin(), 0U);
+      state->materialize_broadcast();
+    }
   }
 
-  // z = W_x(x) + W_h(h)
-  TensorPtr z = W_x->forward(x) + W_h->forward(state);
+  // A whole [B, T, in] sequence, in one node, where supported
+  if (can_rnn_sequence(*(x.get()), *(W_x->weight.get()), W_x->bias.get(),
+                       *(W_h->weight.get()), W_h->bias.get(), 3U)) {
+    const std::vector<TensorPtr> r = Tensor::gru_sequence(
+        x, W_x->weight, W_x->bias, W_h->weight, W_h->bias, state);
+    state = CpuArena::persist(r[1U]);
 
-  // Split into 3 chunks
-  const std::vector<TensorPtr> zc = Tensor::chunk(z, 3, /*axis=*/-1);
+    return r[0U];
+  }
+
+  // Split both projections into 3 chunks: update, reset, candidate
+  const std::vector<TensorPtr> xc = Tensor::chunk(W_x->forward(x), 3, -1);
+  const std::vector<TensorPtr> hc = Tensor::chunk(W_h->forward(state), 3, -1);
 
-  TensorPtr z_t = Tensor::sigmoid(zc[0U]);
-  TensorPtr r_t = Tensor::sigmoid(zc[1U]);
+  TensorPtr z_t = Tensor::sigmoid(xc[0U] + hc[0U]);
+  TensorPtr r_t = Tensor::sigmoid(xc[1U] + hc[1U]);
 
-  // Candidate
-  TensorPtr h_tilde = Tensor::tanh(zc[2U] + W_h->forward(r_t * state));
+  // Candidate, from the candidate block of W_h(r * h)
+  TensorPtr h_tilde = Tensor::tanh(
+      xc[2U] + Tensor::chunk(W_h->forward(r_t * state), 3, -1)[2U]);
 
   // Final hidden state
   TensorPtr h = (Tensor::ones_like(z_t->shape) - z_t) * state + z_t * h_tilde;
 
+  state = CpuArena::persist(h);
+
   h_tilde = nullptr;
   r_t = nullptr;
   z_t = nullptr;
-  z = nullptr;
 
   return h;
 }
@@ -13,6 +13,8 @@
 #include "common/serializer.hpp"
 #include "modules/migrate_cpu.hpp"
 #include "modules/migrate_gpu.hpp"
+#include "ops/norm.hpp"
+#include "tensors/lazy_expr.hpp"
 
 namespace Weed {
 void LayerNorm::migrate_cpu() {
@@ -27,6 +29,25 @@ void LayerNorm::migrate_gpu() {
 }
 
 TensorPtr LayerNorm::forward(const TensorPtr x) {
+  // One read and one write of x, where supported
+  if (can_fused_norm(*(x.get()), *(gamma.get())) &&
+      can_fused_norm(*(x.get()), *(beta.get()))) {
+    return Tensor::layer_norm(x, gamma, beta, eps);
+  }
+
+  if (LazyMode::is_enabled()) {
+    // Fuse the centering and the affine normalization tail
+    const LazyExprPtr lx = LazyExpr::leaf(x);
+    const LazyExprPtr lm = LazyExpr::leaf(Tensor::mean(x, -1));
+    TensorPtr xc = (lx - lm)->materialize();
+    const LazyExprPtr lv = LazyExpr::leaf(Tensor::mean(xc * xc, -1));
+    xc = nullptr;
+
+    return ((lx - lm) / ((lv + eps) ^ real1(0.5f)) * LazyExpr::leaf(gamma) +
+            LazyExpr::leaf(beta))
+        ->materialize();
+  }
+
   // x − μ
   TensorPtr xc = x - Tensor::mean(x, -1);
 
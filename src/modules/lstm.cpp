@@ -11,18 +11,36 @@
 
 #include "modules/lstm.hpp"
 #include "common/serializer.hpp"
+#include "ops/rnn.hpp"
+#include "storage/cpu_arena.hpp"
 
 namespace Weed {
 TensorPtr LSTM::forward(const TensorPtr x) {
-  if (state.h->shape.size() == 1U) {
-    state.h->shape.insert(state.h->shape.begin(), x->shape[0U]);
-    state.h->stride.insert(state.h->stride.begin(), 0U);
-    state.h->materialize_broadcast();
+  {
+    // Recurrent state outlives this call, so it must not come from an arena.
+    ArenaSuspend suspend;
+    if (state.h->shape.size() == 1U) {
+      state.h->shape.insert(state.h->shape.begin(), x->shape[0U]);
+      state.h->stride.insert(state.h->stride.begin(), 0U);
+      state.h->materialize_broadcast();
+    }
+    if (state.c->shape.size() == 1U) {
+      state.c->shape.insert(state.c->shape.begin(), x->shape[0U]);
+      state.c->stride.insert(state.c->stride.begin(), 0U);
+      state.c->materialize_broadcast();
+    }
   }
-  if (state.c->shape.size() == 1U) {
-    state.c->shape.insert(state.c->shape.begin(), x->shape[0U]);
-    state.c->stride.insert(state.c->stride.begin(), 0U);
-    state.c->materialize_broadcast();
+
+  // A whole [B, T, in] sequence, in one node, where supported
+  if (can_rnn_sequence(*(x.get()), *(W_x->weight.get()), W_x->bias.get(),
+                       *(W_h->weight.get()), W_h->bias.get(), 4U)) {
+    const std::vector<TensorPtr> r =
+        Tensor::lstm_sequence(x, W_x->weight, W_x->bias, W_h->weight,
+                              W_h->bias, state.h, state.c);
+    state.h = CpuArena::persist(r[1U]);
+    state.c = CpuArena::persist(r[2U]);
+
+    return r[0U];
   }
 
   // z = W_x(x) + W_h(h_{t-1})
@@ -39,8 +57,8 @@ TensorPtr LSTM::forward(const TensorPtr x) {
   TensorPtr c = f * state.c + i * g;
   TensorPtr h = o * Tensor::tanh(c);
 
-  state.h = h;
-  state.c = c;
+  state.h = CpuArena::persist(h);
+  state.c = CpuArena::persist(c);
 
   c = nullptr;
   o = nullptr;
@@ -21,7 +21,7 @@ TensorPtr MigrateGpu::forward(const TensorPtr x) {
 
   TensorPtr out = std::make_shared<Tensor>(*(x.get()));
   out->storage = out->storage->gpu(device_id);
-  if (x->requires_grad) {
+  if (x->requires_grad && GradMode::is_enabled()) {
     out->make_gradient();
     out->grad_node =
         std::make_shared<Node>(std::vector<TensorPtr>{x}, [x, out] {
@@ -10,8 +10,10 @@
 // https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
 
 #include "modules/module.hpp"
+#include "autograd/grad_mode.hpp"
 #include "common/serializer.hpp"
 
+#include "modules/checkpoint.hpp"
 #include "modules/dropout.hpp"
 #include "modules/embedding.hpp"
 #include "modules/flatten.hpp"
@@ -30,6 +32,7 @@
 #include "modules/min.hpp"
 #include "modules/multihead_attention.hpp"
 #include "modules/positional_encoding.hpp"
+#include "modules/quantized_linear.hpp"
 #include "modules/qwen_decoder_layer.hpp"
 #include "modules/relu.hpp"
 #include "modules/reshape.hpp"
@@ -43,6 +46,10 @@
 #include "modules/tanh.hpp"
 #include "modules/transformer_encoder_layer.hpp"
 #include "modules/variance.hpp"
+#include "storage/cpu_half_storage.hpp"
+#include "storage/mapped_cpu_real_storage.hpp"
+
+#include <fstream>
 
 #if QRACK_AVAILABLE
 #include "modules/qrack_neuron_layer.hpp"
@@ -55,6 +62,127 @@ void Module::save(std::ostream &os) const {
   // Needs the inheriting struct to do the rest
 }
 
+void Module::cast_parameters(const StorageType &st) {
+  std::vector<ParameterPtr> params = parameters();
+  for (const auto &p : params) {
+    const StoragePtr &s = p->storage;
+    if ((s->device != DeviceTag::CPU) || (s->dtype != DType::REAL) ||
+        s->is_sparse()) {
+      continue;
+    }
+    p->storage = cast_cpu_real_storage(s, st);
+  }
+}
+
+void Module::save_aligned(std::ostream &os) const {
+  struct AlignedBlobScope {
+    const bool prior;
+    AlignedBlobScope() : prior(Storage::get_aligned_blobs()) {
+      Storage::set_aligned_blobs(true);
+    }
+    ~AlignedBlobScope() { Storage::set_aligned_blobs(prior); }
+  } scope;
+
+  save(os);
+}
+
+void Module::save_checked(std::ostream &os) const {
+  struct BlobHeaderScope {
+    const bool prior;
+    BlobHeaderScope() : prior(Storage::get_blob_headers()) {
+      Storage::set_blob_headers(true);
+    }
+    ~BlobHeaderScope() { Storage::set_blob_headers(prior); }
+  } scope;
+
+  save(os);
+}
+
+/**
+ * Stops recording even if forward() throws
+ */
+struct GraphRecordScope {
+  GraphRecordScope(std::vector<std::function<void()>> *l) {
+    GraphRecorder::set(l);
+  }
+  ~GraphRecordScope() { GraphRecorder::set(nullptr); }
+};
+
+CapturedGraphPtr Module::capture(const TensorPtr &x) {
+  if (!is_capturable()) {
+    throw std::domain_error("Module::capture() can't record this module!");
+  }
+
+  CapturedGraphPtr g = std::make_shared<CapturedGraph>();
+  TensorPtr in = Tensor::zeros(x->shape, false, false, x->storage->dtype,
+                               DeviceTag::CPU);
+  g->input = in;
+  g->set_input(x);
+
+  NoGradGuard no_grad;
+  GraphRecordScope scope(&(g->launches));
+  g->output = forward(in);
+
+  return g;
+}
+
+CapturedGraphPtr Module::capture(const SymbolTensorPtr &x) {
+  if (!is_capturable()) {
+    throw std::domain_error("Module::capture() can't record this module!");
+  }
+
+  CapturedGraphPtr g = std::make_shared<CapturedGraph>();
+  SymbolTensorPtr in = std::make_shared<SymbolTensor>(
+      std::vector<symint>(x->get_size()), x->shape, false, DeviceTag::CPU);
+  g->input = in;
+  g->set_input(x);
+
+  NoGradGuard no_grad;
+  GraphRecordScope scope(&(g->launches));
+  g->output = forward(in);
+
+  return g;
+}
+
+MemoryPlanPtr Module::plan_memory(const std::vector<tcapint> &shape,
+                                  const DType &dtype) {
+  MemoryPlanPtr plan = std::make_shared<MemoryPlan>(shape);
+  TensorPtr in = Tensor::zeros(shape, false, false, dtype, DeviceTag::CPU);
+
+  NoGradGuard no_grad;
+  {
+    MemoryPlanGuard guard(*(plan.get()));
+    TensorPtr out = forward(in);
+  }
+  plan->finalize();
+
+  return plan;
+}
+
+TensorPtr Module::forward_planned(MemoryPlan &plan, const TensorPtr &x) {
+  if (x->shape != plan.shape) {
+    throw std::invalid_argument(
+        "Module::forward_planned() input shape doesn't match the plan!");
+  }
+  if (plan.is_recording()) {
+    throw std::invalid_argument(
+        "Module::forward_planned() plan must be finalized!");
+  }
+
+  NoGradGuard no_grad;
+  MemoryPlanGuard guard(plan);
+
+  return MemoryPlan::persist(forward(x));
+}
+
+ModulePtr Module::load_mapped(const std::string &path) {
+  const MappedFilePtr mf = std::make_shared<MappedFile>(path);
+  std::ifstream is(path, std::ios::binary);
+  MappedLoadScope scope(mf);
+
+  return load(is);
+}
+
 ModulePtr Module::load(std::istream &is) {
   ModuleType mtype;
   read_module_type(is, mtype);
@@ -70,6 +198,8 @@ ModulePtr Module::load(std::istream &is) {
     }
     return std::make_shared<Sequential>(mv);
   }
+  case ModuleType::CHECKPOINT_T:
+    return std::make_shared<Checkpoint>(load(is));
   case ModuleType::LINEAR_T: {
     LinearPtr l = std::make_shared<Linear>();
     Serializer::read_tcapint(is, l->in_features);
@@ -83,6 +213,36 @@ ModulePtr Module::load(std::istream &is) {
 
     return l;
   }
+  case ModuleType::QUANTIZED_LINEAR_T: {
+    QuantizedLinearPtr l = std::make_shared<QuantizedLinear>();
+    Serializer::read_tcapint(is, l->in_features);
+    Serializer::read_tcapint(is, l->out_features);
+    l->weight = std::make_shared<QuantizedWeight>();
+    QuantizedWeight &w = *(l->weight.get());
+    w.rows = l->in_features;
+    w.cols = l->out_features;
+    Serializer::read_tcapint(is, w.bits);
+    Serializer::read_tcapint(is, w.group_size);
+    if (!w.group_size) {
+      throw std::domain_error("QuantizedLinear group_size can't be 0!");
+    }
+    w.scales.resize(w.cols * w.get_groups());
+    for (real1 &s : w.scales) {
+      Serializer::read_real(is, s);
+    }
+    w.q.resize(w.cols * w.get_col_bytes());
+    for (uint8_t &b : w.q) {
+      Serializer::read_uint8(is, b);
+    }
+    w.validate();
+    bool is_bias;
+    Serializer::read_bool(is, is_bias);
+    if (is_bias) {
+      l->bias = Parameter::load(is);
+    }
+
+    return l;
+  }
   case ModuleType::GELU_T: {
     return std::make_shared<GeLU>();
   }
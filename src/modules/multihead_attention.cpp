@@ -17,6 +17,7 @@
 #include "common/serializer.hpp"
 #include "ops/in_place.hpp"
 #include "ops/triu_fill.hpp"
+#include "storage/cpu_arena.hpp"
 #include "tensors/real_tensor.hpp"
 
 #include <cmath>
@@ -160,16 +161,19 @@ TensorPtr MultiHeadAttention::forward(const TensorPtr x) {
   K = Tensor::transpose(K, 1, 2); // [B, kv_heads,   T, head_dim]
   V = Tensor::transpose(V, 1, 2); // [B, kv_heads,   T, head_dim]
 
-  // optional RoPE (like for Qwen)
+  // optional RoPE (like for Qwen), continuing from any cached positions
   if (rope) {
-    Q = rope->forward(Q);
-    K = rope->forward(K);
+    const tcapint pos = use_kv_cache ? cache_len : 0U;
+    Q = rope->forward(Q, pos);
+    K = rope->forward(K, pos);
   }
 
   if (use_kv_cache) {
     const tcapint T_new = (tcapint)T;
 
     if (!k_cache && !k_qcache.d) {
+      // The cache outlives this call, so it must not come from an arena.
+      ArenaSuspend suspend;
       max_seq_len = rope ? rope->max_seq_len : 2048U;
       cache_len = 0U;
 
@@ -63,9 +63,10 @@ TensorPtr QrackNeuron::forward() {
       std::max(std::sqrt(std::max(ONE_R1 - post_prob * post_prob, real1_f(0))),
                real1_f(FP_NORM_EPSILON));
 
-  TensorPtr out = std::make_shared<Tensor>(real1(delta), angles->requires_grad);
+  const bool rg = GradMode::is_enabled() && angles->requires_grad;
+  TensorPtr out = std::make_shared<Tensor>(real1(delta), rg);
 
-  if (angles->requires_grad) {
+  if (rg) {
     out->make_gradient();
     out->grad_node = std::make_shared<Node>(
         std::vector<TensorPtr>{angles}, [this, denom, out]() {
@@ -0,0 +1,133 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#include "modules/quantized_linear.hpp"
+#include "autograd/node.hpp"
+#include "common/serializer.hpp"
+#include "modules/migrate_cpu.hpp"
+#include "ops/in_place.hpp"
+#include "ops/matmul.hpp"
+
+namespace Weed {
+QuantizedLinear::QuantizedLinear(const Linear &l, const tcapint &bits,
+                                 const tcapint &group_size)
+    : Module(QUANTIZED_LINEAR_T), in_features(l.in_features),
+      out_features(l.out_features),
+      weight(std::make_shared<QuantizedWeight>(*(l.weight.get()), bits,
+                                               group_size)),
+      bias(l.bias) {}
+
+void QuantizedLinear::migrate_cpu() {
+  if (bias) {
+    MigrateCpuPtr mc = std::make_shared<MigrateCpu>();
+    bias = mc->pforward(bias);
+  }
+}
+
+TensorPtr QuantizedLinear::forward(const TensorPtr x) {
+  if ((x->shape.size() < 2U) || (x->shape.back() != in_features)) {
+    throw std::invalid_argument(
+        "QuantizedLinear::forward() input shape doesn't match in_features!");
+  }
+
+  tcapint rows = 1U;
+  for (size_t i = 0U; i < (x->shape.size() - 1U); ++i) {
+    rows *= x->shape[i];
+  }
+
+  const bool needs_flatten = (x->shape.size() > 2U);
+  TensorPtr x2 = needs_flatten
+                     ? Tensor::reshape(x, {(symint)rows, (symint)in_features})
+                     : x;
+  x2 = x2->cast(DeviceTag::CPU);
+
+  const bool rg = GradMode::is_enabled() && x->requires_grad;
+  const std::vector<tcapint> shp{rows, out_features};
+  TensorPtr y = Tensor::allocate_like(shp, Tensor::full_contiguous_stride(shp),
+                                      *(x2.get()), DType::REAL, rg, false);
+
+  const QuantizedWeightPtr qw = weight;
+  WEED_LAUNCH(Weed::quantized_matmul(*(x2.get()), *(qw.get()), *(y.get())));
+
+  if (needs_flatten) {
+    std::vector<symint> final_shape;
+    for (size_t i = 0U; i < (x->shape.size() - 1U); ++i) {
+      final_shape.push_back((symint)x->shape[i]);
+    }
+    final_shape.push_back((symint)out_features);
+    y = Tensor::reshape(y, final_shape);
+  }
+
+  if (rg) {
+    // Weights are frozen, so only the input needs a gradient:
+    // dx = dy @ dequantize(W)^T
+    const QuantizedWeightPtr w = weight;
+    const tcapint K = in_features;
+    const tcapint N = out_features;
+    y->make_gradient();
+    y->grad_node = std::make_shared<Node>(
+        std::vector<TensorPtr>{x}, [x, w, y, rows, K, N]() {
+          const DeviceTag dtag =
+              Tensor::get_dtag_by_presidence({x->grad, y->grad});
+          TensorPtr dy = Tensor::reshape(y->grad->cast(dtag),
+                                         {(symint)rows, (symint)N});
+          TensorPtr wt = Tensor::transpose(w->dequantize(dtag));
+          TensorPtr tmp = Tensor::allocate_like(
+              std::vector<tcapint>{rows, K}, std::vector<tcapint>{1U, rows},
+              *(dy.get()), DType::REAL, false, false);
+
+          Weed::matmul(*(dy.get()), *(wt.get()), *(tmp.get()));
+
+          std::vector<symint> x_shape(x->shape.size());
+          for (size_t i = 0U; i < x_shape.size(); ++i) {
+            x_shape[i] = (symint)(x->shape[i]);
+          }
+          tmp = Tensor::reshape(tmp, x_shape);
+
+          TensorPtr x_grad = x->grad->cast(dtag);
+          Weed::add_in_place(*(x_grad.get()), *(tmp.get()));
+          x->grad = x_grad;
+        });
+  }
+
+  if (bias) {
+    y = y + bias;
+  }
+
+  return y;
+}
+
+std::vector<ParameterPtr> QuantizedLinear::parameters() {
+  if (bias) {
+    return {bias};
+  }
+
+  return {};
+}
+
+void QuantizedLinear::save(std::ostream &os) const {
+  Module::save(os);
+  Serializer::write_tcapint(os, in_features);
+  Serializer::write_tcapint(os, out_features);
+  Serializer::write_tcapint(os, weight->bits);
+  Serializer::write_tcapint(os, weight->group_size);
+  for (const real1 &s : weight->scales) {
+    Serializer::write_real(os, s);
+  }
+  for (const uint8_t &b : weight->q) {
+    Serializer::write_uint8(os, b);
+  }
+  Serializer::write_bool(os, !!bias);
+  if (bias) {
+    bias->save(os);
+  }
+}
+} // namespace Weed
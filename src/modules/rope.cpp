@@ -10,6 +10,7 @@
 // https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
 
 #include "modules/rope.hpp"
+#include "autograd/grad_mode.hpp"
 #include "common/serializer.hpp"
 #include "ops/in_place.hpp"
 
@@ -58,8 +59,9 @@ TensorPtr RoPE::_rotate_half(const TensorPtr x) {
   const symint half = (symint)(head_dim >> 1U);
 
   // Allocate output container — same shape as x
+  const bool rg = GradMode::is_enabled() && x->requires_grad;
   TensorPtr out = Tensor::zeros(
-      {(tcapint)B, (tcapint)H, (tcapint)T, (tcapint)D}, x->requires_grad, false,
+      {(tcapint)B, (tcapint)H, (tcapint)T, (tcapint)D}, rg, false,
       x->storage->dtype, x->storage->device, x->storage->get_device_id());
 
   // Slice x into first and second halves along last dim
@@ -77,11 +79,20 @@ TensorPtr RoPE::_rotate_half(const TensorPtr x) {
   return out;
 }
 
-TensorPtr RoPE::forward(const TensorPtr x) {
+TensorPtr RoPE::forward(const TensorPtr x, const tcapint &pos) {
   const symint T = (symint)x->shape[2U];
+  if ((pos + (tcapint)T) > max_seq_len) {
+    throw std::invalid_argument(
+        "RoPE::forward() positions exceed max_seq_len!");
+  }
+
+  // One pass over the pairs, where supported
+  if (can_rope(*(x.get()), *(cos_table.get()), *(sin_table.get()), pos)) {
+    return Tensor::rope(x, cos_table, sin_table, pos);
+  }
 
-  TensorPtr c = Tensor::slice(cos_table, 0, 0U, (tcapint)T);
-  TensorPtr s = Tensor::slice(sin_table, 0, 0U, (tcapint)T);
+  TensorPtr c = Tensor::slice(cos_table, 0, pos, (tcapint)T);
+  TensorPtr s = Tensor::slice(sin_table, 0, pos, (tcapint)T);
 
   // Broadcast cos/sin to [1, 1, T, head_dim]
   TensorPtr cos_b = Tensor::reshape(c, {1, 1, T, (symint)head_dim});
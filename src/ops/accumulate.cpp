@@ -0,0 +1,310 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#include "ops/accumulate.hpp"
+#include "common/parallel_for.hpp"
+#include "ops/util.hpp"
+#include "tensors/flat_tensors.hpp"
+
+#if ENABLE_GPU
+#include "ops/commuting.hpp"
+#include "ops/div.hpp"
+#include "ops/in_place.hpp"
+#endif
+
+namespace Weed {
+template <typename V> static inline V read(const Tensor &t, const tcapint &i);
+template <> inline real1 read<real1>(const Tensor &t, const tcapint &i) {
+  return (*static_cast<const RealTensor *>(&t))[i];
+}
+template <> inline complex read<complex>(const Tensor &t, const tcapint &i) {
+  if (t.storage->dtype == DType::COMPLEX) {
+    return (*static_cast<const ComplexTensor *>(&t))[i];
+  }
+
+  return complex((*static_cast<const RealTensor *>(&t))[i], ZERO_R1);
+}
+
+static void validate_acc(const Tensor &din,
+                         const std::vector<const Tensor *> &t,
+                         const std::string cls) {
+  std::vector<const BaseTensor *> all{&din};
+  const Tensor &ref = *(t[0U]);
+  const tcapint n = ref.get_broadcast_size();
+  for (const Tensor *p : t) {
+    all.push_back(p);
+    if (p->get_broadcast_size() != n) {
+      throw std::invalid_argument("In " + cls +
+                                  ", operand sizes do not match!");
+    }
+    if ((p->storage->dtype == DType::COMPLEX) &&
+        (din.storage->dtype != DType::COMPLEX)) {
+      throw std::invalid_argument(
+          "Cannot combine complex tensors into real1 tensor!");
+    }
+  }
+  validate_all_same_device(all, cls);
+
+  if (din.get_broadcast_size() == n) {
+    return;
+  }
+  if (din.shape.size() != ref.shape.size()) {
+    throw std::invalid_argument("In " + cls +
+                                ", 'din' rank does not match operand rank!");
+  }
+  for (size_t d = 0U; d < din.shape.size(); ++d) {
+    if ((din.shape[d] != 1U) && (din.shape[d] != ref.shape[d])) {
+      throw std::invalid_argument(
+          "In " + cls + ", 'din' shape doesn't broadcast to operand shape!");
+    }
+  }
+  for (const Tensor *p : t) {
+    if (p->shape != ref.shape) {
+      throw std::invalid_argument("In " + cls +
+                                  ", operand shapes do not match!");
+    }
+  }
+}
+
+// Runs fn over only the stored indices of a sparse, densely indexed factor t,
+// outside of which the accumulated term vanishes
+static bool par_for_keys(const Tensor &t, const ParallelFunc &fn) {
+  if (!t.storage->is_sparse() || !t.is_contiguous() || t.is_broadcast()) {
+    return false;
+  }
+
+  if (t.storage->dtype == DType::COMPLEX) {
+    GET_STORAGE(SparseCpuComplexStorage, t, st);
+    pfControl.par_for(st->data, fn);
+  } else {
+    GET_STORAGE(SparseCpuRealStorage, t, st);
+    pfControl.par_for(st->data, fn);
+  }
+
+  return true;
+}
+
+// din += f(i), over every flat index i of the operands (shaped as "ref"),
+// summed over the indices along which din has extent 1
+template <typename TD, typename V, typename Fn>
+static void cpu_acc(Tensor &din, const Tensor &ref,
+                    const std::vector<const Tensor *> &factors, const Fn &f) {
+  GET_FLAT_TENSOR(TD, din, pdi);
+  const tcapint n = ref.get_broadcast_size();
+  if (din.get_broadcast_size() == n) {
+    const ParallelFunc fn = [&](const tcapint &i, const unsigned &cpu) {
+      pdi->add(i, f(i));
+    };
+    for (const Tensor *t : factors) {
+      if (par_for_keys(*t, fn)) {
+        return;
+      }
+    }
+    pfControl.par_for(0, n, fn);
+
+    return;
+  }
+
+  const size_t rank = ref.shape.size();
+  // Column-major flat index multipliers of the operands, split into the
+  // indices kept in din and the indices summed over
+  std::vector<tcapint> keep_shp, keep_mul, red_shp, red_mul;
+  tcapint m = 1U;
+  for (size_t d = 0U; d < rank; ++d) {
+    if ((din.shape[d] == 1U) && (ref.shape[d] != 1U)) {
+      red_shp.push_back(ref.shape[d]);
+      red_mul.push_back(m);
+    } else {
+      keep_shp.push_back(ref.shape[d]);
+      keep_mul.push_back(m);
+    }
+    m *= ref.shape[d];
+  }
+  tcapint n_red = 1U;
+  for (const tcapint &s : red_shp) {
+    n_red *= s;
+  }
+
+  // Each output index owns its sum, so no two threads add to one element.
+  pfControl.par_for(
+      0, din.get_broadcast_size(), [&](const tcapint &o, const unsigned &cpu) {
+        tcapint base = 0U;
+        tcapint tmp = o;
+        for (size_t d = 0U; d < keep_shp.size(); ++d) {
+          base += (tmp % keep_shp[d]) * keep_mul[d];
+          tmp /= keep_shp[d];
+        }
+        V sum = ZERO_R1;
+        for (tcapint r = 0U; r < n_red; ++r) {
+          tcapint i = base;
+          tmp = r;
+          for (size_t d = 0U; d < red_shp.size(); ++d) {
+            i += (tmp % red_shp[d]) * red_mul[d];
+            tmp /= red_shp[d];
+          }
+          sum += f(i);
+        }
+        pdi->add(o, sum);
+      });
+}
+
+template <typename TD, typename V>
+static void cpu_mul_acc(Tensor &din, const Tensor &a, const Tensor &b,
+                        const real1 &s) {
+  cpu_acc<TD, V>(din, a, {&a, &b}, [&](const tcapint &i) {
+    return V(s) * read<V>(a, i) * read<V>(b, i);
+  });
+}
+
+template <typename TD, typename V>
+static void cpu_div_acc(Tensor &din, const Tensor &a, const Tensor &b,
+                        const real1 &s) {
+  cpu_acc<TD, V>(din, a, {&a}, [&](const tcapint &i) {
+    return V(s) * read<V>(a, i) / read<V>(b, i);
+  });
+}
+
+template <typename TD, typename V>
+static void cpu_mul_div_acc(Tensor &din, const Tensor &a, const Tensor &b,
+                            const Tensor &c, const real1 &s) {
+  cpu_acc<TD, V>(din, a, {&a, &b}, [&](const tcapint &i) {
+    return V(s) * read<V>(a, i) * read<V>(b, i) / read<V>(c, i);
+  });
+}
+
+template <typename TD, typename V>
+static void cpu_div_grad_acc(Tensor &din, const Tensor &a, const Tensor &b,
+                             const Tensor &dout) {
+  cpu_acc<TD, V>(din, a, {&dout, &a}, [&](const tcapint &i) {
+    const V bi = read<V>(b, i);
+    return -read<V>(dout, i) * read<V>(a, i) / (bi * bi);
+  });
+}
+
+template <typename TD, typename V>
+static void cpu_reduce_broadcast_acc(Tensor &din, const Tensor &dout,
+                                     const real1 &s) {
+  cpu_acc<TD, V>(din, dout, {&dout},
+                 [&](const tcapint &i) { return V(s) * read<V>(dout, i); });
+}
+
+#if ENABLE_GPU
+// Scales the operand-shaped GPU term t by s, sums it over the indices along
+// which din has extent 1, and adds it into din
+static void gpu_acc(Tensor &din, TensorPtr t, const real1 &s) {
+  if (s != ONE_R1) {
+    t = s * t;
+  }
+  if (din.get_broadcast_size() != t->get_broadcast_size()) {
+    for (symint d = (symint)din.shape.size() - 1; d >= 0; --d) {
+      if ((din.shape[d] == 1U) && (t->shape[d] != 1U)) {
+        t = Tensor::sum(t, d);
+      }
+    }
+  }
+  add_in_place(din, *(t.get()));
+}
+#endif
+
+void mul_acc(Tensor &din, const Tensor &a, const Tensor &b, const real1 &s) {
+  validate_acc(din, {&a, &b}, "mul_acc");
+#if ENABLE_GPU
+  if (din.storage->device == DeviceTag::GPU) {
+    TensorPtr tmp =
+        Tensor::allocate_like(a.shape, din, din.storage->dtype, false, false);
+    mul(a, b, *(tmp.get()));
+    gpu_acc(din, tmp, s);
+    return;
+  }
+#endif
+  if (din.storage->dtype == DType::COMPLEX) {
+    cpu_mul_acc<ComplexTensor, complex>(din, a, b, s);
+  } else {
+    cpu_mul_acc<RealTensor, real1>(din, a, b, s);
+  }
+}
+
+void div_acc(Tensor &din, const Tensor &a, const Tensor &b, const real1 &s) {
+  validate_acc(din, {&a, &b}, "div_acc");
+#if ENABLE_GPU
+  if (din.storage->device == DeviceTag::GPU) {
+    TensorPtr tmp =
+        Tensor::allocate_like(a.shape, din, din.storage->dtype, false, false);
+    div(a, b, *(tmp.get()));
+    gpu_acc(din, tmp, s);
+    return;
+  }
+#endif
+  if (din.storage->dtype == DType::COMPLEX) {
+    cpu_div_acc<ComplexTensor, complex>(din, a, b, s);
+  } else {
+    cpu_div_acc<RealTensor, real1>(din, a, b, s);
+  }
+}
+
+void mul_div_acc(Tensor &din, const Tensor &a, const Tensor &b,
+                 const Tensor &c, const real1 &s) {
+  validate_acc(din, {&a, &b, &c}, "mul_div_acc");
+#if ENABLE_GPU
+  if (din.storage->device == DeviceTag::GPU) {
+    const DType &dt = din.storage->dtype;
+    TensorPtr ab = Tensor::allocate_like(a.shape, din, dt, false, false);
+    mul(a, b, *(ab.get()));
+    TensorPtr q = Tensor::allocate_like(a.shape, din, dt, false, false);
+    div(*(ab.get()), c, *(q.get()));
+    gpu_acc(din, q, s);
+    return;
+  }
+#endif
+  if (din.storage->dtype == DType::COMPLEX) {
+    cpu_mul_div_acc<ComplexTensor, complex>(din, a, b, c, s);
+  } else {
+    cpu_mul_div_acc<RealTensor, real1>(din, a, b, c, s);
+  }
+}
+
+void div_grad_acc(Tensor &din, const Tensor &a, const Tensor &b,
+                  const Tensor &dout) {
+  validate_acc(din, {&a, &b, &dout}, "div_grad_acc");
+#if ENABLE_GPU
+  if (din.storage->device == DeviceTag::GPU) {
+    const DType &dt = din.storage->dtype;
+    TensorPtr b_sqr = Tensor::allocate_like(a.shape, din, dt, false, false);
+    mul(b, b, *(b_sqr.get()));
+    TensorPtr q = Tensor::allocate_like(a.shape, din, dt, false, false);
+    div(a, *(b_sqr.get()), *(q.get()));
+    mul(dout, *(q.get()), *(b_sqr.get()));
+    gpu_acc(din, b_sqr, -ONE_R1);
+    return;
+  }
+#endif
+  if (din.storage->dtype == DType::COMPLEX) {
+    cpu_div_grad_acc<ComplexTensor, complex>(din, a, b, dout);
+  } else {
+    cpu_div_grad_acc<RealTensor, real1>(din, a, b, dout);
+  }
+}
+
+void reduce_broadcast_acc(Tensor &din, const Tensor &dout, const real1 &s) {
+  validate_acc(din, {&dout}, "reduce_broadcast_acc");
+#if ENABLE_GPU
+  if (din.storage->device == DeviceTag::GPU) {
+    gpu_acc(din, std::make_shared<Tensor>(dout), s);
+    return;
+  }
+#endif
+  if (din.storage->dtype == DType::COMPLEX) {
+    cpu_reduce_broadcast_acc<ComplexTensor, complex>(din, dout, s);
+  } else {
+    cpu_reduce_broadcast_acc<RealTensor, real1>(din, dout, s);
+  }
+}
+} // namespace Weed
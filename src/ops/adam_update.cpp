@@ -0,0 +1,160 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#include "ops/adam_update.hpp"
+#include "common/parallel_for.hpp"
+#include "ops/util.hpp"
+#include "tensors/flat_tensors.hpp"
+
+#include <cmath>
+
+#define ADAM_ELEMENT(grad)                                                     \
+  const real1 gi = (grad) + l2 * pp[i];                                        \
+  const real1 mi = b1 * pm[i] + ob1 * gi;                                      \
+  const real1 vi = b2 * pv[i] + ob2 * gi * gi;                                 \
+  pm[i] = mi;                                                                  \
+  pv[i] = vi;                                                                  \
+  pp[i] = shrink * pp[i] - step * mi / ((real1)std::sqrt(vi * inv_bc2) + eps)
+
+namespace Weed {
+static bool is_dense_real_cpu(const Tensor &t) {
+  return (t.storage->stype == StorageType::REAL_CPU_DENSE) && !t.offset;
+}
+
+static bool is_lazy_grad(const Tensor &g, const tcapint &n) {
+  return (g.storage->stype == StorageType::REAL_CPU_SPARSE) && !g.offset &&
+         (g.storage->size == n) && g.is_packed() &&
+         (static_cast<SparseCpuRealStorage *>(g.storage.get())
+              ->default_value == ZERO_R1);
+}
+
+#if ENABLE_GPU
+static bool is_dense_real_gpu(const Tensor &t, const int64_t &did) {
+  return (t.storage->stype == StorageType::REAL_GPU_DENSE) &&
+         (t.storage->get_device_id() == did);
+}
+
+static bool can_gpu_adam_update(const Tensor &p, const Tensor &m,
+                                const Tensor &v, const Tensor &g) {
+  const tcapint n = p.storage->size;
+  const int64_t did = p.storage->get_device_id();
+
+  return is_dense_real_gpu(p, did) && is_dense_real_gpu(m, did) &&
+         is_dense_real_gpu(v, did) && is_dense_real_gpu(g, did) &&
+         !p.offset && !m.offset && !v.offset && (m.storage->size == n) &&
+         (v.storage->size == n) && (g.get_broadcast_size() == n) &&
+         g.is_packed();
+}
+#endif
+
+bool can_adam_update(const Tensor &p, const Tensor &m, const Tensor &v,
+                     const Tensor &g) {
+#if ENABLE_GPU
+  if (p.storage->device == DeviceTag::GPU) {
+    return can_gpu_adam_update(p, m, v, g);
+  }
+#endif
+  const tcapint n = p.storage->size;
+
+  return is_dense_real_cpu(p) && is_dense_real_cpu(m) &&
+         is_dense_real_cpu(v) && (m.storage->size == n) &&
+         (v.storage->size == n) && (g.storage->dtype == DType::REAL) &&
+         (g.storage->device == DeviceTag::CPU) &&
+         (g.get_broadcast_size() == n) && !g.is_broadcast() &&
+         (!g.storage->is_sparse() || is_lazy_grad(g, n));
+}
+
+void adam_update(Tensor &p, Tensor &m, Tensor &v, const Tensor &g,
+                 const AdamCoefficients &c) {
+  if (!can_adam_update(p, m, v, g)) {
+    throw std::domain_error("adam_update() requires dense real parameter and "
+                            "moments, and a real gradient of equal size!");
+  }
+
+  const tcapint n = p.storage->size;
+  const real1 b1 = c.beta1;
+  const real1 b2 = c.beta2;
+  const real1 ob1 = ONE_R1 - c.beta1;
+  const real1 ob2 = ONE_R1 - c.beta2;
+  const real1 step = c.lr / c.bias_correction1;
+  const real1 inv_bc2 = ONE_R1 / c.bias_correction2;
+  const real1 eps = c.eps;
+  const real1 l2 = c.decoupled ? ZERO_R1 : c.weight_decay;
+  const real1 shrink = c.decoupled ? (ONE_R1 - c.lr * c.weight_decay) : ONE_R1;
+
+#if ENABLE_GPU
+  if (p.storage->device == DeviceTag::GPU) {
+    // The coefficients outnumber the constant argument buffer, so they ride
+    // along in a small buffer of their own.
+    const Tensor coef(
+        std::vector<real1>{b1, b2, ob1, ob2, step, inv_bc2, eps, l2, shrink},
+        std::vector<tcapint>{9U}, false, DeviceTag::GPU,
+        p.storage->get_device_id());
+    const tcapint args[12U]{g.offset, 0U, 0U, 0U, 0U, 0U,
+                            0U,       0U, 0U, 0U, 0U, 0U};
+    std::shared_ptr<GpuRealStorage> p_storage =
+        std::dynamic_pointer_cast<GpuRealStorage>(p.storage);
+    std::shared_ptr<GpuRealStorage> m_storage =
+        std::dynamic_pointer_cast<GpuRealStorage>(m.storage);
+    std::shared_ptr<GpuRealStorage> v_storage =
+        std::dynamic_pointer_cast<GpuRealStorage>(v.storage);
+    std::shared_ptr<GpuRealStorage> g_storage =
+        std::dynamic_pointer_cast<GpuRealStorage>(g.storage);
+    std::shared_ptr<GpuRealStorage> c_storage =
+        std::dynamic_pointer_cast<GpuRealStorage>(coef.storage);
+    p_storage->dev->RequestKernel(
+        OCLAPI::OCL_API_ADAM_UPDATE_REAL, args, n,
+        {p_storage->buffer, m_storage->buffer, v_storage->buffer,
+         g_storage->buffer, c_storage->buffer});
+
+    return;
+  }
+#endif
+
+  real1 *pp = static_cast<CpuRealStorage *>(p.storage.get())->data.get();
+  real1 *pm = static_cast<CpuRealStorage *>(m.storage.get())->data.get();
+  real1 *pv = static_cast<CpuRealStorage *>(v.storage.get())->data.get();
+
+  if (g.storage->is_sparse()) {
+    const RealSparseVector &sg =
+        static_cast<SparseCpuRealStorage *>(g.storage.get())->data;
+    pfControl.par_for(sg, [&](const tcapint &i, const unsigned &cpu) {
+      ADAM_ELEMENT(sg.at(i));
+    });
+
+    return;
+  }
+
+  // One contiguous block per core, each a plain loop over raw pointers
+  if ((g.storage->stype == StorageType::REAL_CPU_DENSE) && g.is_packed()) {
+    const real1 *pg =
+        static_cast<CpuRealStorage *>(g.storage.get())->data.get() + g.offset;
+    const auto fn = [&](const tcapint &begin, const tcapint &end,
+                        const unsigned &cpu) {
+      for (tcapint i = begin; i < end; ++i) {
+        ADAM_ELEMENT(pg[i]);
+      }
+    };
+    pfControl.par_for_blocks(0U, n, fn);
+
+    return;
+  }
+
+  GET_CONST_FLAT_TENSOR(RealTensor, g, pgt);
+  const auto fn = [&](const tcapint &begin, const tcapint &end,
+                      const unsigned &cpu) {
+    for (tcapint i = begin; i < end; ++i) {
+      ADAM_ELEMENT((*pgt)[i]);
+    }
+  };
+  pfControl.par_for_blocks(0U, n, fn);
+}
+} // namespace Weed
@@ -0,0 +1,288 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#include "ops/cross_entropy.hpp"
+#include "common/parallel_for.hpp"
+#include "ops/matmul.hpp"
+#include "storage/all_storage.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace Weed {
+// Storage offset of every row (over all but the last axis, first axis
+// fastest) of a tensor
+static std::vector<tcapint> row_offsets(const BaseTensor &t,
+                                        const size_t &row_dims) {
+  tcapint rows = 1U;
+  for (size_t i = 0U; i < row_dims; ++i) {
+    rows *= t.shape[i];
+  }
+  std::vector<tcapint> o(rows);
+  for (tcapint r = 0U; r < rows; ++r) {
+    tcapint q = r;
+    tcapint off = t.offset;
+    for (size_t i = 0U; i < row_dims; ++i) {
+      off += (q % t.shape[i]) * t.stride[i];
+      q /= t.shape[i];
+    }
+    o[r] = off;
+  }
+
+  return o;
+}
+
+static std::vector<tcapint> read_targets(const SymbolTensor &targets,
+                                         const tcapint &V) {
+  const std::vector<tcapint> o = row_offsets(targets, targets.shape.size());
+  const IntStorage &s = *static_cast<IntStorage *>(targets.storage.get());
+  std::vector<tcapint> tgt(o.size());
+  for (size_t r = 0U; r < o.size(); ++r) {
+    const symint t = s[o[r]];
+    if ((t < 0) || ((tcapint)t >= V)) {
+      throw std::invalid_argument("cross_entropy() target out of range!");
+    }
+    tgt[r] = (tcapint)t;
+  }
+
+  return tgt;
+}
+
+bool can_cross_entropy(const Tensor &logits, const SymbolTensor &targets) {
+  if (logits.shape.empty() || targets.shape.empty() ||
+      !logits.shape.back() ||
+      (logits.storage->stype != StorageType::REAL_CPU_DENSE) ||
+      (targets.storage->device != DeviceTag::CPU)) {
+    return false;
+  }
+
+  return (logits.get_broadcast_size() / logits.shape.back()) ==
+         targets.get_broadcast_size();
+}
+
+real1 cross_entropy(const Tensor &logits, const SymbolTensor &targets,
+                    std::vector<real1> &lse) {
+  if (!can_cross_entropy(logits, targets)) {
+    throw std::domain_error("cross_entropy() requires dense CPU real logits "
+                            "with one target per row!");
+  }
+
+  const tcapint V = logits.shape.back();
+  const tcapint vs = logits.stride.back();
+  const std::vector<tcapint> rows =
+      row_offsets(logits, logits.shape.size() - 1U);
+  const std::vector<tcapint> tgt = read_targets(targets, V);
+  const real1 *x =
+      static_cast<CpuRealStorage *>(logits.storage.get())->data.get();
+  const tcapint R = rows.size();
+  lse.resize(R);
+  std::vector<real1> nll(R);
+
+  pfControl.par_for(0, R, [&](const tcapint &r, const unsigned &cpu) {
+    const real1 *xr = x + rows[r];
+    real1 m = -std::numeric_limits<real1>::infinity();
+    for (tcapint v = 0U; v < V; ++v) {
+      m = std::max(m, xr[v * vs]);
+    }
+    real1 s = ZERO_R1;
+    for (tcapint v = 0U; v < V; ++v) {
+      s += (real1)std::exp(xr[v * vs] - m);
+    }
+    lse[r] = m + (real1)std::log(s);
+    nll[r] = lse[r] - xr[tgt[r] * vs];
+  });
+
+  real1 total = ZERO_R1;
+  for (const real1 &l : nll) {
+    total += l;
+  }
+
+  return total / (real1)R;
+}
+
+void cross_entropy_grad(Tensor &dlogits, const Tensor &logits,
+                        const SymbolTensor &targets,
+                        const std::vector<real1> &lse, const real1 &scale) {
+  if (!can_cross_entropy(logits, targets) ||
+      (dlogits.storage->stype != StorageType::REAL_CPU_DENSE) ||
+      (dlogits.shape != logits.shape)) {
+    throw std::domain_error("cross_entropy_grad() requires dense CPU real "
+                            "logits and gradient of equal shape!");
+  }
+
+  const tcapint V = logits.shape.back();
+  const tcapint vs = logits.stride.back();
+  const tcapint ds = dlogits.stride.back();
+  const std::vector<tcapint> rows =
+      row_offsets(logits, logits.shape.size() - 1U);
+  const std::vector<tcapint> drows =
+      row_offsets(dlogits, dlogits.shape.size() - 1U);
+  const std::vector<tcapint> tgt = read_targets(targets, V);
+  const real1 *x =
+      static_cast<CpuRealStorage *>(logits.storage.get())->data.get();
+  real1 *d = static_cast<CpuRealStorage *>(dlogits.storage.get())->data.get();
+
+  pfControl.par_for(0, rows.size(), [&](const tcapint &r, const unsigned &cpu) {
+    const real1 *xr = x + rows[r];
+    real1 *dr = d + drows[r];
+    const real1 l = lse[r];
+    for (tcapint v = 0U; v < V; ++v) {
+      dr[v * ds] += scale * (real1)std::exp(xr[v * vs] - l);
+    }
+    dr[tgt[r] * ds] -= scale;
+  });
+}
+
+bool can_linear_cross_entropy(const Tensor &x, const Tensor &w,
+                              const SymbolTensor &targets) {
+  if ((w.shape.size() != 2U) || !w.shape[0U] || !w.shape[1U] ||
+      x.shape.empty() || (x.shape.back() != w.shape[0U]) ||
+      (x.storage->stype != StorageType::REAL_CPU_DENSE) ||
+      (w.storage->dtype != DType::REAL) ||
+      (w.storage->device != DeviceTag::CPU) ||
+      (targets.storage->device != DeviceTag::CPU)) {
+    return false;
+  }
+
+  return (x.get_broadcast_size() / x.shape.back()) ==
+         targets.get_broadcast_size();
+}
+
+// Logits of columns [c, c + n) into the leading columns of l
+static void chunk_logits(const Tensor &x, const Tensor &w, const Tensor *b,
+                         const tcapint &c, const tcapint &n, Tensor &l) {
+  const Tensor wc = column_view(w, c, n);
+  Tensor lc = column_view(l, 0U, n);
+  matmul(x, wc, lc);
+  if (!b) {
+    return;
+  }
+  const RealStorage &bs = *static_cast<RealStorage *>(b->storage.get());
+  const tcapint R = x.shape[0U];
+  real1 *pl = static_cast<CpuRealStorage *>(l.storage.get())->data.get();
+  for (tcapint v = 0U; v < n; ++v) {
+    const real1 bv = bs[b->offset + (c + v) * b->stride.back()];
+    real1 *col = pl + v * R;
+    for (tcapint r = 0U; r < R; ++r) {
+      col[r] += bv;
+    }
+  }
+}
+
+real1 linear_cross_entropy(const Tensor &x, const Tensor &w, const Tensor *b,
+                           const SymbolTensor &targets, const tcapint &chunk,
+                           std::vector<real1> &lse) {
+  if ((x.shape.size() != 2U) || !can_linear_cross_entropy(x, w, targets) ||
+      !chunk) {
+    throw std::domain_error("linear_cross_entropy() requires [rows, in] dense "
+                            "CPU real input, CPU real weight, and one target "
+                            "per row!");
+  }
+
+  const tcapint R = x.shape[0U];
+  const tcapint V = w.shape[1U];
+  const tcapint C = std::min(chunk, V);
+  const std::vector<tcapint> tgt = read_targets(targets, V);
+  TensorPtr l =
+      Tensor::zeros({R, C}, false, false, DType::REAL, DeviceTag::CPU);
+  const real1 *pl = static_cast<CpuRealStorage *>(l->storage.get())->data.get();
+
+  // Online log-sum-exp: running maximum and rescaled sum per row
+  std::vector<real1> m(R, -std::numeric_limits<real1>::infinity());
+  std::vector<real1> s(R, ZERO_R1);
+  std::vector<real1> xt(R, ZERO_R1);
+  for (tcapint c = 0U; c < V; c += C) {
+    const tcapint n = std::min(C, V - c);
+    chunk_logits(x, w, b, c, n, *(l.get()));
+    pfControl.par_for(0, R, [&](const tcapint &r, const unsigned &cpu) {
+      real1 cm = m[r];
+      for (tcapint v = 0U; v < n; ++v) {
+        cm = std::max(cm, pl[r + v * R]);
+      }
+      real1 cs = s[r] * (real1)std::exp(m[r] - cm);
+      for (tcapint v = 0U; v < n; ++v) {
+        cs += (real1)std::exp(pl[r + v * R] - cm);
+      }
+      m[r] = cm;
+      s[r] = cs;
+      if ((tgt[r] >= c) && (tgt[r] < (c + n))) {
+        xt[r] = pl[r + (tgt[r] - c) * R];
+      }
+    });
+  }
+
+  lse.resize(R);
+  real1 total = ZERO_R1;
+  for (tcapint r = 0U; r < R; ++r) {
+    lse[r] = m[r] + (real1)std::log(s[r]);
+    total += lse[r] - xt[r];
+  }
+
+  return total / (real1)R;
+}
+
+void linear_cross_entropy_grad(Tensor *dx, Tensor *dw, std::vector<real1> *db,
+                               const Tensor &x, const Tensor &w,
+                               const Tensor *b, const SymbolTensor &targets,
+                               const std::vector<real1> &lse,
+                               const real1 &scale, const tcapint &chunk) {
+  const tcapint R = x.shape[0U];
+  const tcapint V = w.shape[1U];
+  const tcapint C = std::min(chunk, V);
+  const std::vector<tcapint> tgt = read_targets(targets, V);
+  TensorPtr l =
+      Tensor::zeros({R, C}, false, false, DType::REAL, DeviceTag::CPU);
+  real1 *pl = static_cast<CpuRealStorage *>(l->storage.get())->data.get();
+  if (db) {
+    db->assign(V, ZERO_R1);
+  }
+
+  // Transposed views, for the two gradient products
+  Tensor xT(x);
+  xT.transpose();
+
+  for (tcapint c = 0U; c < V; c += C) {
+    const tcapint n = std::min(C, V - c);
+    chunk_logits(x, w, b, c, n, *(l.get()));
+
+    // Logits become g = scale * (softmax - onehot), in place.
+    pfControl.par_for(0, R, [&](const tcapint &r, const unsigned &cpu) {
+      for (tcapint v = 0U; v < n; ++v) {
+        real1 &g = pl[r + v * R];
+        g = scale * (real1)std::exp(g - lse[r]);
+      }
+      if ((tgt[r] >= c) && (tgt[r] < (c + n))) {
+        pl[r + (tgt[r] - c) * R] -= scale;
+      }
+    });
+
+    const Tensor g = column_view(*(l.get()), 0U, n);
+    if (dx) {
+      Tensor wcT = column_view(w, c, n);
+      wcT.transpose();
+      matmul_acc(g, wcT, *dx);
+    }
+    if (dw) {
+      Tensor dwc = column_view(*dw, c, n);
+      matmul_acc(xT, g, dwc);
+    }
+    if (db) {
+      for (tcapint v = 0U; v < n; ++v) {
+        real1 sum = ZERO_R1;
+        for (tcapint r = 0U; r < R; ++r) {
+          sum += pl[r + v * R];
+        }
+        (*db)[c + v] += sum;
+      }
+    }
+  }
+}
+} // namespace Weed
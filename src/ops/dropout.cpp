@@ -0,0 +1,92 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#include "ops/dropout.hpp"
+#include "common/parallel_for.hpp"
+#include "common/philox.hpp"
+#include "storage/all_storage.hpp"
+
+namespace Weed {
+// Random words at or above this threshold keep their element.
+static uint32_t keep_threshold(const real1 &p) {
+  const double t = (double)p * 4294967296.0;
+
+  return (t >= 4294967295.0) ? 0xFFFFFFFFU : (uint32_t)t;
+}
+
+bool can_dropout(const Tensor &x) {
+  return (x.storage->stype == StorageType::REAL_CPU_DENSE) && x.is_packed();
+}
+
+std::vector<uint64_t> dropout_mask(const tcapint &n, const real1 &p,
+                                   const uint64_t &seed,
+                                   const uint64_t &stream) {
+  const uint32_t thr = keep_threshold(p);
+  std::vector<uint64_t> mask((n + 63U) >> 6U, 0U);
+
+  // 16 Philox blocks of 4 words fill each 64-bit mask word.
+  pfControl.par_for(0, mask.size(), [&](const tcapint &w,
+                                        const unsigned &cpu) {
+    uint64_t bits = 0U;
+    for (uint64_t b = 0U; b < 16U; ++b) {
+      const Philox4x32::Block r =
+          Philox4x32::generate((((uint64_t)w) << 4U) | b, stream, seed);
+      for (uint64_t k = 0U; k < 4U; ++k) {
+        if (r[k] >= thr) {
+          bits |= 1ULL << ((b << 2U) | k);
+        }
+      }
+    }
+    const tcapint rem = n - (w << 6U);
+    mask[w] = (rem < 64U) ? (bits & ((1ULL << rem) - 1U)) : bits;
+  });
+
+  return mask;
+}
+
+// out = (is_acc ? out : 0) + in * mask / (1 - p), four elements per block
+static void apply(Tensor &out, const Tensor &in, const real1 &p,
+                  const uint64_t &seed, const uint64_t &stream,
+                  const bool &is_acc) {
+  if (!can_dropout(in) || !can_dropout(out) || (in.shape != out.shape)) {
+    throw std::domain_error("dropout() requires dense contiguous CPU real "
+                            "tensors of equal shape!");
+  }
+
+  const tcapint n = in.get_broadcast_size();
+  const uint32_t thr = keep_threshold(p);
+  const real1 scale = ONE_R1 / (ONE_R1 - p);
+  const real1 *pi =
+      static_cast<CpuRealStorage *>(in.storage.get())->data.get() + in.offset;
+  real1 *po =
+      static_cast<CpuRealStorage *>(out.storage.get())->data.get() + out.offset;
+
+  pfControl.par_for(0, (n + 3U) >> 2U, [&](const tcapint &b,
+                                           const unsigned &cpu) {
+    const Philox4x32::Block r = Philox4x32::generate(b, stream, seed);
+    const tcapint i0 = b << 2U;
+    for (tcapint k = 0U; (k < 4U) && ((i0 + k) < n); ++k) {
+      const real1 v = (r[k] >= thr) ? (pi[i0 + k] * scale) : ZERO_R1;
+      po[i0 + k] = is_acc ? (po[i0 + k] + v) : v;
+    }
+  });
+}
+
+void dropout(Tensor &y, const Tensor &x, const real1 &p, const uint64_t &seed,
+             const uint64_t &stream) {
+  apply(y, x, p, seed, stream, false);
+}
+
+void dropout_grad(Tensor &dx, const Tensor &dy, const real1 &p,
+                  const uint64_t &seed, const uint64_t &stream) {
+  apply(dx, dy, p, seed, stream, true);
+}
+} // namespace Weed
@@ -97,7 +97,7 @@ static void cpu_backward(Tensor &dW, const SymbolTensor &indices,
   const tcapint O_s0 = dout.stride[0];
   const tcapint O_s1 = dout.stride.back();
 
-  pfControl.par_for(0U, N, [&](const tcapint &i, const unsigned &) {
+  const auto fn = [&](const tcapint &i, const unsigned &) {
     const tcapint token = (*idx)[indices.offset + i * I_s];
 
     const tcapint w_base = dW.offset + token * W_s0;
@@ -106,7 +106,16 @@ static void cpu_backward(Tensor &dW, const SymbolTensor &indices,
     for (tcapint d = 0U; d < D; ++d) {
       dWt->add(w_base + d * W_s1, (*dOut)[o_base + d * O_s1]);
     }
-  });
+  };
+
+  if (dW.storage->is_sparse()) {
+    // Sparse maps can't take concurrent insertions.
+    for (tcapint i = 0U; i < N; ++i) {
+      fn(i, 0U);
+    }
+  } else {
+    pfControl.par_for(0U, N, fn);
+  }
 }
 
 #if ENABLE_GPU
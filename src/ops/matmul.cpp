@@ -11,6 +11,7 @@
 
 #include "ops/matmul.hpp"
 #include "common/parallel_for.hpp"
+#include "ops/in_place.hpp"
 #include "ops/util.hpp"
 #include "tensors/flat_tensors.hpp"
 
@@ -43,7 +44,11 @@
                         sum += (*pa)[a_idx] * (*pb)[b_idx];                    \
                       }                                                        \
                       const auto o_idx = d.O_o + i * d.O_s0 + j * d.O_s1;      \
-                      po->write(o_idx, sum);                                   \
+                      if (acc) {                                               \
+                        po->add(o_idx, sum);                                   \
+                      } else {                                                 \
+                        po->write(o_idx, sum);                                 \
+                      }                                                        \
                     })
 
 #define TILE_BY_TYPE(ltype, lstorage, rtype, rstorage, otype, ostorage, call)  \
@@ -80,7 +85,7 @@
     break;                                                                     \
   case DeviceTag::CPU:                                                         \
   default:                                                                     \
-    cpu(a, b, out);                                                            \
+    cpu(a, b, out, false);                                                     \
   }
 
 namespace Weed {
@@ -122,11 +127,54 @@ static MatrixDim get_dim(const Tensor &a, const Tensor &b, Tensor &out) {
 }
 
 template <typename T1, typename T2, typename T3, typename T4>
-static void cpu(const Tensor &a, const Tensor &b, Tensor &out) {
+static void cpu(const Tensor &a, const Tensor &b, Tensor &out,
+                const bool &acc) {
   CPU_HEADER(T1, T2, T3);
   CPU_BY_TYPE(T4);
 }
-static inline void cpu_real(const Tensor &a, const Tensor &b, Tensor &out) {
+template <typename Codec>
+static void cpu_half_right(const Tensor &a, const Tensor &b, Tensor &out,
+                           const bool &acc) {
+  // Right-hand operand (typically weights) stays at 2 bytes per element and
+  // is decoded to fp32 in registers; accumulation is in real1_f.
+  const MatrixDim d = get_dim(a, b, out);
+  const real1 *pa = static_cast<CpuRealStorage *>(a.storage.get())->data.get();
+  const uint16_t *pb =
+      static_cast<CpuHalfStorage<Codec> *>(b.storage.get())->data.get();
+  real1 *po = static_cast<CpuRealStorage *>(out.storage.get())->data.get();
+  pfControl.par_for(0, d.N, [&](const tcapint &j, const unsigned &cpu) {
+    real1 *oj = po + d.O_o + j * d.O_s1;
+    const uint16_t *bj = pb + d.B_o + j * d.B_s1;
+    if (!acc) {
+      for (tcapint i = 0U; i < d.M; ++i) {
+        oj[i * d.O_s0] = ZERO_R1;
+      }
+    }
+    for (tcapint k = 0U; k < d.K; ++k) {
+      const real1_f w = (real1_f)Codec::decode(bj[k * d.B_s0]);
+      if (w == ZERO_R1_F) {
+        continue;
+      }
+      const real1 *ak = pa + d.A_o + k * d.A_s1;
+      for (tcapint i = 0U; i < d.M; ++i) {
+        oj[i * d.O_s0] =
+            (real1)((real1_f)oj[i * d.O_s0] + (real1_f)ak[i * d.A_s0] * w);
+      }
+    }
+  });
+}
+static inline void cpu_real(const Tensor &a, const Tensor &b, Tensor &out,
+                            const bool &acc) {
+  const bool isDense = (a.storage->stype == StorageType::REAL_CPU_DENSE) &&
+                       (out.storage->stype == StorageType::REAL_CPU_DENSE);
+  if (isDense && (b.storage->stype == StorageType::REAL_CPU_FP16)) {
+    cpu_half_right<Fp16Codec>(a, b, out, acc);
+    return;
+  }
+  if (isDense && (b.storage->stype == StorageType::REAL_CPU_BF16)) {
+    cpu_half_right<Bf16Codec>(a, b, out, acc);
+    return;
+  }
 #if WEED_BLAS && (WEED_FPPOW > 4) && (WEED_FPPOW < 7)
   MatrixDim d = get_dim(a, b, out);
 
@@ -137,10 +185,15 @@ static inline void cpu_real(const Tensor &a, const Tensor &b, Tensor &out) {
   // Weed col-major: stride[0]=1 (row stride), stride[1]=M (col stride).
   // So lda = d.A_s1, ldb = d.B_s1, ldc = d.O_s1.
   // This works as long as offsets are zero and strides are contiguous.
+  // (A transposed view, with unit stride along its second index, is passed
+  // to BLAS as the transpose of its underlying contiguous matrix.)
+  const bool isATrans = (d.A_s0 != 1U) && (d.A_s1 == 1U) && (d.A_s0 >= d.K);
+  const bool isBTrans = (d.B_s0 != 1U) && (d.B_s1 == 1U) && (d.B_s0 >= d.N);
 
-  if ((d.A_s0 == 1U) && (d.B_s0 == 1U) && (d.O_s0 == 1U) && (d.A_s1 >= d.M) &&
-      (d.B_s1 >= d.K) && (d.O_s1 >= d.M) && (d.M > 0U) && (d.N > 0U) &&
-      (d.K > 0U)) {
+  if (isDense && (b.storage->stype == StorageType::REAL_CPU_DENSE) &&
+      (isATrans || ((d.A_s0 == 1U) && (d.A_s1 >= d.M))) &&
+      (isBTrans || ((d.B_s0 == 1U) && (d.B_s1 >= d.K))) && (d.O_s0 == 1U) &&
+      (d.O_s1 >= d.M) && (d.M > 0U) && (d.N > 0U) && (d.K > 0U)) {
     // Get raw pointers to storage
     auto *a_store = static_cast<CpuRealStorage *>(a.storage.get());
     auto *b_store = static_cast<CpuRealStorage *>(b.storage.get());
@@ -151,14 +204,17 @@ static inline void cpu_real(const Tensor &a, const Tensor &b, Tensor &out) {
 #else
     cblas_dgemm(
 #endif
-        CblasColMajor, CblasNoTrans, CblasNoTrans,
-        (blasint)d.M,                                 // rows of A and C
-        (blasint)d.N,                                 // cols of B and C
-        (blasint)d.K,                                 // cols of A, rows of B
-        ONE_R1_F,                                     // alpha
-        a_store->data.get() + d.A_o, (blasint)d.A_s1, // A, lda
-        b_store->data.get() + d.B_o, (blasint)d.B_s1, // B, ldb
-        ZERO_R1_F,                                    // beta (overwrite C)
+        CblasColMajor, isATrans ? CblasTrans : CblasNoTrans,
+        isBTrans ? CblasTrans : CblasNoTrans,
+        (blasint)d.M, // rows of A and C
+        (blasint)d.N, // cols of B and C
+        (blasint)d.K, // cols of A, rows of B
+        ONE_R1_F,     // alpha
+        a_store->data.get() + d.A_o,
+        (blasint)(isATrans ? d.A_s0 : d.A_s1), // A, lda
+        b_store->data.get() + d.B_o,
+        (blasint)(isBTrans ? d.B_s0 : d.B_s1), // B, ldb
+        acc ? ONE_R1_F : ZERO_R1_F, // beta (accumulate into, or overwrite, C)
         o_store->data.get() + d.O_o, (blasint)d.O_s1  // C, ldc
     );
 
@@ -166,9 +222,10 @@ static inline void cpu_real(const Tensor &a, const Tensor &b, Tensor &out) {
   }
   // Fall through to hand-rolled for non-contiguous cases
 #endif
-  cpu<RealStorage, RealStorage, RealStorage, real1>(a, b, out);
+  cpu<RealStorage, RealStorage, RealStorage, real1>(a, b, out, acc);
 }
-static inline void cpu_complex(const Tensor &a, const Tensor &b, Tensor &out) {
+static inline void cpu_complex(const Tensor &a, const Tensor &b, Tensor &out,
+                               const bool &acc) {
 #if WEED_BLAS && (WEED_FPPOW > 4) && (WEED_FPPOW < 7)
   MatrixDim d = get_dim(a, b, out);
 
@@ -179,10 +236,10 @@ static inline void cpu_complex(const Tensor &a, const Tensor &b, Tensor &out) {
 
 #if MAC_BLAS
     const complex alpha(ONE_R1_F, ZERO_R1_F); // complex 1+0i
-    const complex beta(ZERO_R1_F, ZERO_R1_F); // complex 0+0i
+    const complex beta(acc ? ONE_R1_F : ZERO_R1_F, ZERO_R1_F);
 #else
     const real1_f alpha[2] = {ONE_R1_F, ZERO_R1_F}; // complex 1+0i
-    const real1_f beta[2] = {ZERO_R1_F, ZERO_R1_F}; // complex 0+0i
+    const real1_f beta[2] = {acc ? ONE_R1_F : ZERO_R1_F, ZERO_R1_F};
 #endif
 
 #if WEED_FPPOW == 5
@@ -205,15 +262,20 @@ static inline void cpu_complex(const Tensor &a, const Tensor &b, Tensor &out) {
     return;
   }
 #endif
-  cpu<ComplexStorage, ComplexStorage, ComplexStorage, complex>(a, b, out);
+  cpu<ComplexStorage, ComplexStorage, ComplexStorage, complex>(a, b, out,
+                                                               acc);
 }
 static inline void cpu_mixed_c_left(const Tensor &a, const Tensor &b,
-                                    Tensor &out) {
-  cpu<ComplexStorage, RealStorage, ComplexStorage, complex>(a, b, out);
+                                    Tensor &out, const bool &acc) {
+  cpu<ComplexStorage, RealStorage, ComplexStorage, complex>(a, b, out, acc);
 }
 static inline void cpu_mixed_c_right(const Tensor &a, const Tensor &b,
-                                     Tensor &out) {
-  cpu<RealStorage, ComplexStorage, ComplexStorage, complex>(a, b, out);
+                                     Tensor &out, const bool &acc) {
+  cpu<RealStorage, ComplexStorage, ComplexStorage, complex>(a, b, out, acc);
+}
+static inline void cpu_real_c_out(const Tensor &a, const Tensor &b,
+                                  Tensor &out, const bool &acc) {
+  cpu<RealStorage, RealStorage, ComplexStorage, complex>(a, b, out, acc);
 }
 
 #if ENABLE_GPU
@@ -255,26 +317,67 @@ void matmul(const Tensor &a, const Tensor &b, Tensor &out) {
 #if ENABLE_GPU
     DEVICE_SWITCH(cpu_complex, gpu_complex);
 #else
-    cpu_complex(a, b, out);
+    cpu_complex(a, b, out, false);
 #endif
   } else if (isAComplex) {
 #if ENABLE_GPU
     DEVICE_SWITCH(cpu_mixed_c_left, gpu_mixed_c_left);
 #else
-    cpu_mixed_c_left(a, b, out);
+    cpu_mixed_c_left(a, b, out, false);
 #endif
   } else if (isBComplex) {
 #if ENABLE_GPU
     DEVICE_SWITCH(cpu_mixed_c_right, gpu_mixed_c_right);
 #else
-    cpu_mixed_c_right(a, b, out);
+    cpu_mixed_c_right(a, b, out, false);
 #endif
   } else {
 #if ENABLE_GPU
     DEVICE_SWITCH(cpu_real, gpu_real);
 #else
-    cpu_real(a, b, out);
+    cpu_real(a, b, out, false);
+#endif
+  }
+}
+
+void matmul_acc(const Tensor &a, const Tensor &b, Tensor &out) {
+  validate_all_same_device({&a, &b, &out}, "MatMulKernel::matmul_acc");
+  const bool isAComplex = a.storage->dtype == DType::COMPLEX;
+  const bool isBComplex = b.storage->dtype == DType::COMPLEX;
+  const bool isOutComplex = out.storage->dtype == DType::COMPLEX;
+  if (!isOutComplex && (isAComplex || isBComplex)) {
+    throw std::invalid_argument(
+        "Cannot combine complex tensors into real1 tensor!");
+  }
+#if ENABLE_GPU
+  if (out.storage->device == DeviceTag::GPU) {
+    // No accumulating tile kernel: multiply into a temporary, then add.
+    TensorPtr tmp = Tensor::allocate_like(out, out.storage->dtype, false,
+                                          out.storage->is_sparse());
+    matmul(a, b, *(tmp.get()));
+    add_in_place(out, *(tmp.get()));
+    return;
+  }
 #endif
+  if (isAComplex && isBComplex) {
+    cpu_complex(a, b, out, true);
+  } else if (isAComplex) {
+    cpu_mixed_c_left(a, b, out, true);
+  } else if (isBComplex) {
+    cpu_mixed_c_right(a, b, out, true);
+  } else if (isOutComplex) {
+    cpu_real_c_out(a, b, out, true);
+  } else {
+    cpu_real(a, b, out, true);
   }
 }
+
+Tensor column_view(const Tensor &m, const tcapint &c, const tcapint &n) {
+  Tensor v(m);
+  v.offset += c * v.stride[1U];
+  v.shape[1U] = n;
+  v.stride[1U] = m.stride[1U] ? m.stride[1U] : m.shape[0U];
+
+  return v;
+}
 } // namespace Weed
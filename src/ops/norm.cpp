@@ -0,0 +1,234 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#include "ops/norm.hpp"
+#include "common/parallel_for.hpp"
+#include "storage/all_storage.hpp"
+
+#include <cmath>
+
+namespace Weed {
+// Values of a per-feature parameter, along its last axis
+static std::vector<real1> read_features(const Tensor &w) {
+  const RealStorage &s = *static_cast<RealStorage *>(w.storage.get());
+  const tcapint H = w.shape.back();
+  const tcapint ws = w.stride.back();
+  std::vector<real1> v(H);
+  for (tcapint h = 0U; h < H; ++h) {
+    v[h] = s[w.offset + h * ws];
+  }
+
+  return v;
+}
+
+static real1 *cpu_data(const Tensor &t) {
+  return static_cast<CpuRealStorage *>(t.storage.get())->data.get() + t.offset;
+}
+
+static bool is_dense_like(const Tensor &t, const Tensor &x) {
+  return (t.storage->stype == StorageType::REAL_CPU_DENSE) &&
+         (t.shape == x.shape) && t.is_packed();
+}
+
+bool can_fused_norm(const Tensor &x, const Tensor &w) {
+  if (x.shape.empty() || !x.shape.back() || w.shape.empty() ||
+      (w.shape.size() > x.shape.size()) ||
+      (x.storage->stype != StorageType::REAL_CPU_DENSE) ||
+      !x.is_packed() ||
+      (w.storage->dtype != DType::REAL) ||
+      (w.storage->device != DeviceTag::CPU) ||
+      (w.shape.back() != x.shape.back())) {
+    return false;
+  }
+  for (size_t i = 0U; (i + 1U) < w.shape.size(); ++i) {
+    if ((w.shape[i] != 1U) && w.stride[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Rows of a contiguous [..., H] tensor are interleaved: (r, h) is r + h * R.
+
+void rms_norm(const Tensor &x, const Tensor &w, const real1 &eps, Tensor &y,
+              std::vector<real1> &rstd) {
+  if (!can_fused_norm(x, w) || !is_dense_like(y, x)) {
+    throw std::domain_error("rms_norm() requires dense contiguous CPU real "
+                            "input and output, and a CPU real weight!");
+  }
+
+  const tcapint H = x.shape.back();
+  const tcapint R = x.get_broadcast_size() / H;
+  const std::vector<real1> wv = read_features(w);
+  const real1 *px = cpu_data(x);
+  real1 *py = cpu_data(y);
+  rstd.resize(R);
+
+  pfControl.par_for(0, R, [&](const tcapint &r, const unsigned &cpu) {
+    real1 ss = ZERO_R1;
+    for (tcapint h = 0U; h < H; ++h) {
+      const real1 v = px[r + h * R];
+      ss += v * v;
+    }
+    const real1 rs = ONE_R1 / (real1)std::sqrt(ss / (real1)H + eps);
+    rstd[r] = rs;
+    for (tcapint h = 0U; h < H; ++h) {
+      py[r + h * R] = px[r + h * R] * rs * wv[h];
+    }
+  });
+}
+
+void rms_norm_grad(Tensor *dx, std::vector<real1> *dw, const Tensor &dy,
+                   const Tensor &x, const Tensor &w,
+                   const std::vector<real1> &rstd) {
+  if (!can_fused_norm(x, w) || !is_dense_like(dy, x) ||
+      (dx && !is_dense_like(*dx, x))) {
+    throw std::domain_error("rms_norm_grad() requires dense contiguous CPU "
+                            "real tensors of equal shape!");
+  }
+
+  const tcapint H = x.shape.back();
+  const tcapint R = x.get_broadcast_size() / H;
+  const std::vector<real1> wv = read_features(w);
+  const real1 *px = cpu_data(x);
+  const real1 *pdy = cpu_data(dy);
+
+  if (dx) {
+    real1 *pdx = cpu_data(*dx);
+    pfControl.par_for(0, R, [&](const tcapint &r, const unsigned &cpu) {
+      const real1 rs = rstd[r];
+      real1 dot = ZERO_R1;
+      for (tcapint h = 0U; h < H; ++h) {
+        dot += pdy[r + h * R] * wv[h] * px[r + h * R] * rs;
+      }
+      dot /= (real1)H;
+      for (tcapint h = 0U; h < H; ++h) {
+        const tcapint i = r + h * R;
+        pdx[i] += rs * (pdy[i] * wv[h] - px[i] * rs * dot);
+      }
+    });
+  }
+
+  if (dw) {
+    dw->resize(H);
+    pfControl.par_for(0, H, [&](const tcapint &h, const unsigned &cpu) {
+      real1 sum = ZERO_R1;
+      for (tcapint r = 0U; r < R; ++r) {
+        sum += pdy[r + h * R] * px[r + h * R] * rstd[r];
+      }
+      (*dw)[h] = sum;
+    });
+  }
+}
+
+void layer_norm(const Tensor &x, const Tensor &gamma, const Tensor &beta,
+                const real1 &eps, Tensor &y, std::vector<real1> &mean,
+                std::vector<real1> &rstd) {
+  if (!can_fused_norm(x, gamma) || !can_fused_norm(x, beta) ||
+      !is_dense_like(y, x)) {
+    throw std::domain_error("layer_norm() requires dense contiguous CPU real "
+                            "input and output, and CPU real gamma and beta!");
+  }
+
+  const tcapint H = x.shape.back();
+  const tcapint R = x.get_broadcast_size() / H;
+  const std::vector<real1> gv = read_features(gamma);
+  const std::vector<real1> bv = read_features(beta);
+  const real1 *px = cpu_data(x);
+  real1 *py = cpu_data(y);
+  mean.resize(R);
+  rstd.resize(R);
+
+  pfControl.par_for(0, R, [&](const tcapint &r, const unsigned &cpu) {
+    // Welford's running mean and sum of squared deviations
+    real1 mu = ZERO_R1;
+    real1 m2 = ZERO_R1;
+    for (tcapint h = 0U; h < H; ++h) {
+      const real1 v = px[r + h * R];
+      const real1 d = v - mu;
+      mu += d / (real1)(h + 1U);
+      m2 += d * (v - mu);
+    }
+    const real1 rs = ONE_R1 / (real1)std::sqrt(m2 / (real1)H + eps);
+    mean[r] = mu;
+    rstd[r] = rs;
+    for (tcapint h = 0U; h < H; ++h) {
+      py[r + h * R] = (px[r + h * R] - mu) * rs * gv[h] + bv[h];
+    }
+  });
+}
+
+void layer_norm_grad(Tensor *dx, std::vector<real1> *dgamma,
+                     std::vector<real1> *dbeta, const Tensor &dy,
+                     const Tensor &x, const Tensor &gamma,
+                     const std::vector<real1> &mean,
+                     const std::vector<real1> &rstd) {
+  if (!can_fused_norm(x, gamma) || !is_dense_like(dy, x) ||
+      (dx && !is_dense_like(*dx, x))) {
+    throw std::domain_error("layer_norm_grad() requires dense contiguous CPU "
+                            "real tensors of equal shape!");
+  }
+
+  const tcapint H = x.shape.back();
+  const tcapint R = x.get_broadcast_size() / H;
+  const std::vector<real1> gv = read_features(gamma);
+  const real1 *px = cpu_data(x);
+  const real1 *pdy = cpu_data(dy);
+
+  if (dx) {
+    real1 *pdx = cpu_data(*dx);
+    pfControl.par_for(0, R, [&](const tcapint &r, const unsigned &cpu) {
+      const real1 mu = mean[r];
+      const real1 rs = rstd[r];
+      real1 gm = ZERO_R1;
+      real1 dot = ZERO_R1;
+      for (tcapint h = 0U; h < H; ++h) {
+        const real1 g = pdy[r + h * R] * gv[h];
+        gm += g;
+        dot += g * (px[r + h * R] - mu) * rs;
+      }
+      gm /= (real1)H;
+      dot /= (real1)H;
+      for (tcapint h = 0U; h < H; ++h) {
+        const tcapint i = r + h * R;
+        const real1 xh = (px[i] - mu) * rs;
+        pdx[i] += rs * (pdy[i] * gv[h] - gm - xh * dot);
+      }
+    });
+  }
+
+  if (!dgamma && !dbeta) {
+    return;
+  }
+  if (dgamma) {
+    dgamma->resize(H);
+  }
+  if (dbeta) {
+    dbeta->resize(H);
+  }
+  pfControl.par_for(0, H, [&](const tcapint &h, const unsigned &cpu) {
+    real1 sg = ZERO_R1;
+    real1 sb = ZERO_R1;
+    for (tcapint r = 0U; r < R; ++r) {
+      const real1 d = pdy[r + h * R];
+      sg += d * (px[r + h * R] - mean[r]) * rstd[r];
+      sb += d;
+    }
+    if (dgamma) {
+      (*dgamma)[h] = sg;
+    }
+    if (dbeta) {
+      (*dbeta)[h] = sb;
+    }
+  });
+}
+} // namespace Weed
@@ -0,0 +1,171 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#include "ops/quantized_matmul.hpp"
+#include "common/parallel_for.hpp"
+#include "tensors/flat_tensors.hpp"
+
+#include <cmath>
+
+namespace Weed {
+QuantizedWeight::QuantizedWeight(const Tensor &wt, const tcapint &b,
+                                 const tcapint &gs)
+    : bits(b) {
+  if ((wt.shape.size() != 2U) || (wt.storage->dtype != DType::REAL)) {
+    throw std::invalid_argument(
+        "QuantizedWeight requires a real-valued tensor with 2 indices!");
+  }
+  if ((bits != 4U) && (bits != 8U)) {
+    throw std::invalid_argument("QuantizedWeight bits must be 4 or 8!");
+  }
+
+  rows = wt.shape[0U];
+  cols = wt.shape[1U];
+  group_size = (gs && (gs < rows)) ? gs : rows;
+
+  const TensorPtr w = wt.cast(DeviceTag::CPU);
+  GET_CONST_FLAT_TENSOR(RealTensor, *(w.get()), pw);
+
+  const tcapint groups = get_groups();
+  const tcapint col_bytes = get_col_bytes();
+  const real1_f qmax = (bits == 4U) ? 7.0f : 127.0f;
+  q.resize(cols * col_bytes);
+  scales.resize(cols * groups);
+  std::fill(q.begin(), q.end(), (bits == 4U) ? 0x88U : 0U);
+
+  pfControl.par_for(0, cols, [&](const tcapint &j, const unsigned &cpu) {
+    uint8_t *c = q.data() + j * col_bytes;
+    for (tcapint g = 0U; g < groups; ++g) {
+      const tcapint start = g * group_size;
+      const tcapint end = std::min(start + group_size, rows);
+
+      real1_f amax = ZERO_R1_F;
+      for (tcapint k = start; k < end; ++k) {
+        amax = std::max(amax, (real1_f)std::abs((*pw)[k + j * rows]));
+      }
+      const real1_f scale = amax / qmax;
+      scales[j * groups + g] = (real1)scale;
+      if (scale <= ZERO_R1_F) {
+        continue;
+      }
+
+      for (tcapint k = start; k < end; ++k) {
+        real1_f v = std::round((real1_f)(*pw)[k + j * rows] / scale);
+        v = std::max(-qmax, std::min(qmax, v));
+        if (bits == 8U) {
+          c[k] = (uint8_t)(int8_t)v;
+        } else {
+          const uint8_t nib = (uint8_t)((int)v + 8);
+          uint8_t &byte = c[k >> 1U];
+          byte = (k & 1U) ? ((byte & 0x0FU) | (nib << 4U))
+                          : ((byte & 0xF0U) | nib);
+        }
+      }
+    }
+  });
+}
+
+void QuantizedWeight::decode_column(const tcapint &j, real1_f *out) const {
+  const uint8_t *c = q.data() + j * get_col_bytes();
+  const tcapint groups = get_groups();
+  const real1 *s = scales.data() + j * groups;
+  for (tcapint g = 0U; g < groups; ++g) {
+    const real1_f scale = (real1_f)s[g];
+    const tcapint start = g * group_size;
+    const tcapint end = std::min(start + group_size, rows);
+    if (bits == 8U) {
+      for (tcapint k = start; k < end; ++k) {
+        out[k] = (real1_f)(int8_t)c[k] * scale;
+      }
+    } else {
+      for (tcapint k = start; k < end; ++k) {
+        const uint8_t byte = c[k >> 1U];
+        const int nib = (k & 1U) ? (byte >> 4U) : (byte & 0x0FU);
+        out[k] = (real1_f)(nib - 8) * scale;
+      }
+    }
+  }
+}
+
+TensorPtr QuantizedWeight::dequantize(const DeviceTag &dtag) const {
+  std::vector<real1_f> col(rows);
+  std::vector<real1> v(rows * cols);
+  for (tcapint j = 0U; j < cols; ++j) {
+    decode_column(j, col.data());
+    std::transform(col.begin(), col.end(), v.begin() + j * rows,
+                   [](real1_f x) { return (real1)x; });
+  }
+
+  return std::make_shared<Tensor>(v, std::vector<tcapint>{rows, cols}, false,
+                                  dtag);
+}
+
+void QuantizedWeight::validate() const {
+  if (((bits != 4U) && (bits != 8U)) || !rows || !cols || !group_size ||
+      (q.size() != (cols * get_col_bytes())) ||
+      (scales.size() != (cols * get_groups()))) {
+    throw std::domain_error("QuantizedWeight is malformed!");
+  }
+}
+
+void quantized_matmul(const Tensor &a, const QuantizedWeight &w, Tensor &out) {
+  if ((a.shape.size() != 2U) || (out.shape.size() != 2U)) {
+    throw std::invalid_argument(
+        "quantized_matmul is only for matrices with 2 indices!");
+  }
+  const tcapint M = a.shape[0U];
+  const tcapint K = w.rows;
+  const tcapint N = w.cols;
+  if (a.shape[1U] != K) {
+    throw std::invalid_argument(
+        "quantized_matmul operand dimensions aren't compatible!");
+  }
+  if ((out.shape[0U] != M) || (out.shape[1U] != N)) {
+    throw std::invalid_argument(
+        "quantized_matmul output dimensions don't match inputs!");
+  }
+  if ((a.storage->dtype != DType::REAL) || (a.storage->device != DeviceTag::CPU)) {
+    throw std::invalid_argument(
+        "quantized_matmul input must be real-valued and on CPU!");
+  }
+  if ((out.storage->stype != StorageType::REAL_CPU_DENSE) ||
+      !Tensor::is_contiguous(out.shape, out.stride)) {
+    throw std::invalid_argument(
+        "quantized_matmul output must be contiguous dense CPU storage!");
+  }
+
+  // Gather the input row-major, so every dot product is unit-stride.
+  GET_CONST_FLAT_TENSOR(RealTensor, a, pa);
+  std::vector<real1_f> x(M * K);
+  pfControl.par_for(0, M * K, [&](const tcapint &l, const unsigned &cpu) {
+    x[(l % M) * K + (l / M)] = (real1_f)(*pa)[l];
+  });
+
+  real1 *po =
+      static_cast<CpuRealStorage *>(out.storage.get())->data.get() + out.offset;
+
+  // Each column of weights is read (and decoded) exactly once.
+  std::vector<std::vector<real1_f>> col(pfControl.GetNumCores(),
+                                        std::vector<real1_f>(K));
+  pfControl.par_for(0, N, [&](const tcapint &j, const unsigned &cpu) {
+    real1_f *wc = col[cpu].data();
+    w.decode_column(j, wc);
+    for (tcapint i = 0U; i < M; ++i) {
+      const real1_f *xi = x.data() + i * K;
+      real1_f sum = ZERO_R1_F;
+      for (tcapint k = 0U; k < K; ++k) {
+        sum += xi[k] * wc[k];
+      }
+      po[i + j * M] = (real1)sum;
+    }
+  });
+}
+} // namespace Weed
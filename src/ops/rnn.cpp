@@ -0,0 +1,416 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#include "ops/rnn.hpp"
+#include "common/parallel_for.hpp"
+#include "ops/matmul.hpp"
+#include "storage/all_storage.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Weed {
+static real1 *cpu_data(const Tensor &t) {
+  return static_cast<CpuRealStorage *>(t.storage.get())->data.get() + t.offset;
+}
+
+static real1 sigmoid(const real1 &v) {
+  return ONE_R1 / (ONE_R1 + (real1)std::exp(-v));
+}
+
+static bool is_dense_matrix(const Tensor &t, const tcapint &rows,
+                            const tcapint &cols) {
+  return (t.storage->stype == StorageType::REAL_CPU_DENSE) &&
+         (t.shape == std::vector<tcapint>{rows, cols}) && t.is_packed();
+}
+
+static bool is_cpu_real(const Tensor &t) {
+  return (t.storage->dtype == DType::REAL) &&
+         (t.storage->device == DeviceTag::CPU);
+}
+
+// A bias (or null) varying only along its last axis, of width C
+static bool is_bias(const Tensor *b, const tcapint &C) {
+  if (!b) {
+    return true;
+  }
+  if (b->shape.empty() || (b->shape.back() != C) || !is_cpu_real(*b)) {
+    return false;
+  }
+  for (size_t i = 0U; (i + 1U) < b->shape.size(); ++i) {
+    if ((b->shape[i] != 1U) && b->stride[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Rows [r, r + n) of a [rows, cols] matrix, as a view
+static Tensor row_block(const Tensor &m, const tcapint &r, const tcapint &n) {
+  Tensor v(m);
+  v.offset += r;
+  v.shape[0U] = n;
+  v.stride[0U] = 1U;
+  v.stride[1U] = m.stride[1U] ? m.stride[1U] : m.shape[0U];
+
+  return v;
+}
+
+static Tensor transposed(const Tensor &m) {
+  Tensor t(m);
+  t.transpose();
+
+  return t;
+}
+
+bool can_rnn_sequence(const Tensor &x, const Tensor &wx, const Tensor *bx,
+                      const Tensor &wh, const Tensor *bh, const tcapint &G) {
+  if ((x.shape.size() != 3U) || !x.shape[0U] || !x.shape[1U] ||
+      (x.storage->stype != StorageType::REAL_CPU_DENSE) || !x.is_packed() ||
+      (wx.shape.size() != 2U) || (wh.shape.size() != 2U) ||
+      !is_cpu_real(wx) || !is_cpu_real(wh)) {
+    return false;
+  }
+  const tcapint H = wh.shape[0U];
+
+  return H && (x.shape[2U] == wx.shape[0U]) && (wx.shape[1U] == (G * H)) &&
+         (wh.shape[1U] == (G * H)) && is_bias(bx, G * H) && is_bias(bh, G * H);
+}
+
+// Input projection of every step in one GEMM, plus both biases: z = x * wx
+static void project_inputs(const Tensor &x, const Tensor &wx, const Tensor *bx,
+                           const Tensor *bh, Tensor &z) {
+  matmul(x, wx, z);
+  const tcapint N = z.shape[0U];
+  const tcapint C = z.shape[1U];
+  real1 *pz = cpu_data(z);
+  for (const Tensor *b : {bx, bh}) {
+    if (!b) {
+      continue;
+    }
+    const RealStorage &bs = *static_cast<RealStorage *>(b->storage.get());
+    const tcapint st = b->stride.back();
+    for (tcapint q = 0U; q < C; ++q) {
+      const real1 v = bs[b->offset + q * st];
+      real1 *col = pz + q * N;
+      for (tcapint r = 0U; r < N; ++r) {
+        col[r] += v;
+      }
+    }
+  }
+}
+
+// Column sums of dz, as the gradient of both biases
+static void bias_grad(const Tensor &dz, std::vector<real1> &db) {
+  const tcapint N = dz.shape[0U];
+  const tcapint C = dz.shape[1U];
+  const real1 *pdz = cpu_data(dz);
+  db.resize(C);
+  pfControl.par_for(0, C, [&](const tcapint &q, const unsigned &cpu) {
+    real1 sum = ZERO_R1;
+    for (tcapint r = 0U; r < N; ++r) {
+      sum += pdz[r + q * N];
+    }
+    db[q] = sum;
+  });
+}
+
+// Every step's previous hidden state, as one [N, H] matrix: h0, then hs
+// shifted down by one step
+static TensorPtr previous_states(const Tensor &h0, const Tensor &hs) {
+  const tcapint B = h0.shape[0U];
+  const tcapint N = hs.shape[0U];
+  const tcapint H = hs.shape[1U];
+  TensorPtr hp =
+      Tensor::zeros({N, H}, false, false, DType::REAL, DeviceTag::CPU);
+  const real1 *p0 = cpu_data(h0);
+  const real1 *ps = cpu_data(hs);
+  real1 *pp = cpu_data(*(hp.get()));
+  for (tcapint j = 0U; j < H; ++j) {
+    std::copy(p0 + j * B, p0 + (j + 1U) * B, pp + j * N);
+    std::copy(ps + j * N, ps + j * N + (N - B), pp + j * N + B);
+  }
+
+  return hp;
+}
+
+// The last step of [N, H] rows, as [B, H]
+static void last_step(const Tensor &s, Tensor &out) {
+  const tcapint N = s.shape[0U];
+  const tcapint B = out.shape[0U];
+  const tcapint H = out.shape[1U];
+  const real1 *ps = cpu_data(s);
+  real1 *po = cpu_data(out);
+  for (tcapint j = 0U; j < H; ++j) {
+    std::copy(ps + j * N + (N - B), ps + (j + 1U) * N, po + j * B);
+  }
+}
+
+// Shared input, weight and bias gradients, each in one pass over the sequence
+static void input_grads(Tensor *dx, Tensor *dwx, std::vector<real1> *db,
+                        const Tensor &dz, const Tensor &x, const Tensor &wx) {
+  if (dx) {
+    matmul_acc(dz, transposed(wx), *dx);
+  }
+  if (dwx) {
+    matmul_acc(transposed(x), dz, *dwx);
+  }
+  if (db) {
+    bias_grad(dz, *db);
+  }
+}
+
+static void check_sequence(const Tensor &x, const Tensor &wx, const Tensor &wh,
+                           const Tensor &h0, const tcapint &G,
+                           const Tensor &z, const Tensor &hs) {
+  const tcapint N = x.shape.empty() ? 0U : x.shape[0U];
+  const tcapint H = wh.shape.empty() ? 0U : wh.shape[0U];
+  const tcapint B = h0.shape.empty() ? 0U : h0.shape[0U];
+  if ((x.shape.size() != 2U) ||
+      (x.storage->stype != StorageType::REAL_CPU_DENSE) ||
+      (wx.shape.size() != 2U) || (wx.shape[0U] != x.shape[1U]) ||
+      (wx.shape[1U] != (G * H)) ||
+      (wh.shape != std::vector<tcapint>{H, G * H}) || !is_cpu_real(wx) ||
+      !is_cpu_real(wh) || !B || (N % B) || !is_dense_matrix(h0, B, H) ||
+      !is_dense_matrix(z, N, G * H) || !is_dense_matrix(hs, N, H)) {
+    throw std::domain_error("RNN sequence kernels require [B * T, in] dense "
+                            "CPU real input, CPU real weights, and dense "
+                            "state buffers of matching shapes!");
+  }
+}
+
+void lstm_sequence(const Tensor &x, const Tensor &wx, const Tensor *bx,
+                   const Tensor &wh, const Tensor *bh, const Tensor &h0,
+                   const Tensor &c0, Tensor &z, Tensor &hs, Tensor &cs,
+                   Tensor &h_last, Tensor &c_last) {
+  check_sequence(x, wx, wh, h0, 4U, z, hs);
+  const tcapint N = x.shape[0U];
+  const tcapint B = h0.shape[0U];
+  const tcapint H = wh.shape[0U];
+  if (!is_dense_matrix(c0, B, H) || !is_dense_matrix(cs, N, H) ||
+      !is_dense_matrix(h_last, B, H) || !is_dense_matrix(c_last, B, H)) {
+    throw std::domain_error("lstm_sequence() requires dense [B, H] and "
+                            "[B * T, H] cell state buffers!");
+  }
+
+  project_inputs(x, wx, bx, bh, z);
+  real1 *pz = cpu_data(z);
+  real1 *phs = cpu_data(hs);
+  real1 *pcs = cpu_data(cs);
+  const real1 *pc0 = cpu_data(c0);
+  for (tcapint s = 0U; s < N; s += B) {
+    Tensor zt = row_block(z, s, B);
+    matmul_acc(s ? row_block(hs, s - B, B) : h0, wh, zt);
+    pfControl.par_for(0, B * H, [&](const tcapint &i, const unsigned &cpu) {
+      const tcapint b = i % B;
+      const tcapint j = i / B;
+      const tcapint r = s + b;
+      real1 &f = pz[r + j * N];
+      real1 &ig = pz[r + (H + j) * N];
+      real1 &g = pz[r + ((H << 1U) + j) * N];
+      real1 &o = pz[r + (3U * H + j) * N];
+      f = sigmoid(f);
+      ig = sigmoid(ig);
+      g = (real1)std::tanh(g);
+      o = sigmoid(o);
+      const real1 cp = s ? pcs[r - B + j * N] : pc0[i];
+      const real1 c = f * cp + ig * g;
+      pcs[r + j * N] = c;
+      phs[r + j * N] = o * (real1)std::tanh(c);
+    });
+  }
+
+  last_step(hs, h_last);
+  last_step(cs, c_last);
+}
+
+void lstm_sequence_grad(Tensor *dx, Tensor *dwx, Tensor *dwh,
+                        std::vector<real1> *db, const Tensor &dhs,
+                        const Tensor &x, const Tensor &wx, const Tensor &wh,
+                        const Tensor &h0, const Tensor &c0, const Tensor &z,
+                        const Tensor &hs, const Tensor &cs) {
+  check_sequence(x, wx, wh, h0, 4U, z, hs);
+  const tcapint N = x.shape[0U];
+  const tcapint B = h0.shape[0U];
+  const tcapint H = wh.shape[0U];
+  if (!is_dense_matrix(dhs, N, H) || !is_dense_matrix(cs, N, H)) {
+    throw std::domain_error("lstm_sequence_grad() requires dense [B * T, H] "
+                            "output gradient and cell states!");
+  }
+
+  TensorPtr dz =
+      Tensor::zeros({N, H << 2U}, false, false, DType::REAL, DeviceTag::CPU);
+  TensorPtr dh_next =
+      Tensor::zeros({B, H}, false, false, DType::REAL, DeviceTag::CPU);
+  std::vector<real1> dc_next(B * H, ZERO_R1);
+  const Tensor whT = transposed(wh);
+  const real1 *pz = cpu_data(z);
+  const real1 *pcs = cpu_data(cs);
+  const real1 *pc0 = cpu_data(c0);
+  const real1 *pdy = cpu_data(dhs);
+  real1 *pdz = cpu_data(*(dz.get()));
+  real1 *pdh = cpu_data(*(dh_next.get()));
+
+  for (tcapint s = N; s > 0U;) {
+    s -= B;
+    pfControl.par_for(0, B * H, [&](const tcapint &i, const unsigned &cpu) {
+      const tcapint b = i % B;
+      const tcapint j = i / B;
+      const tcapint r = s + b;
+      const real1 f = pz[r + j * N];
+      const real1 ig = pz[r + (H + j) * N];
+      const real1 g = pz[r + ((H << 1U) + j) * N];
+      const real1 o = pz[r + (3U * H + j) * N];
+      const real1 tc = (real1)std::tanh(pcs[r + j * N]);
+      const real1 cp = s ? pcs[r - B + j * N] : pc0[i];
+      const real1 dh = pdy[r + j * N] + pdh[i];
+      const real1 dc = dc_next[i] + dh * o * (ONE_R1 - tc * tc);
+      pdz[r + j * N] = dc * cp * f * (ONE_R1 - f);
+      pdz[r + (H + j) * N] = dc * g * ig * (ONE_R1 - ig);
+      pdz[r + ((H << 1U) + j) * N] = dc * ig * (ONE_R1 - g * g);
+      pdz[r + (3U * H + j) * N] = dh * tc * o * (ONE_R1 - o);
+      dc_next[i] = dc * f;
+    });
+    if (s) {
+      matmul(row_block(*(dz.get()), s, B), whT, *(dh_next.get()));
+    }
+  }
+
+  if (dwh) {
+    const TensorPtr hp = previous_states(h0, hs);
+    matmul_acc(transposed(*(hp.get())), *(dz.get()), *dwh);
+  }
+  input_grads(dx, dwx, db, *(dz.get()), x, wx);
+}
+
+void gru_sequence(const Tensor &x, const Tensor &wx, const Tensor *bx,
+                  const Tensor &wh, const Tensor *bh, const Tensor &h0,
+                  Tensor &z, Tensor &hs, Tensor &rh, Tensor &h_last) {
+  check_sequence(x, wx, wh, h0, 3U, z, hs);
+  const tcapint N = x.shape[0U];
+  const tcapint B = h0.shape[0U];
+  const tcapint H = wh.shape[0U];
+  if (!is_dense_matrix(rh, N, H) || !is_dense_matrix(h_last, B, H)) {
+    throw std::domain_error("gru_sequence() requires dense [B * T, H] and "
+                            "[B, H] state buffers!");
+  }
+
+  project_inputs(x, wx, bx, bh, z);
+  // Update and reset gates see h_prev; the candidate sees r * h_prev.
+  const Tensor wh_zr = column_view(wh, 0U, H << 1U);
+  const Tensor wh_n = column_view(wh, H << 1U, H);
+  real1 *pz = cpu_data(z);
+  real1 *phs = cpu_data(hs);
+  real1 *prh = cpu_data(rh);
+  const real1 *ph0 = cpu_data(h0);
+  for (tcapint s = 0U; s < N; s += B) {
+    const Tensor zt = row_block(z, s, B);
+    Tensor zt_zr = column_view(zt, 0U, H << 1U);
+    Tensor zt_n = column_view(zt, H << 1U, H);
+    matmul_acc(s ? row_block(hs, s - B, B) : h0, wh_zr, zt_zr);
+    pfControl.par_for(0, B * H, [&](const tcapint &i, const unsigned &cpu) {
+      const tcapint r = s + (i % B);
+      const tcapint j = i / B;
+      real1 &zg = pz[r + j * N];
+      real1 &rg = pz[r + (H + j) * N];
+      zg = sigmoid(zg);
+      rg = sigmoid(rg);
+      prh[r + j * N] = rg * (s ? phs[r - B + j * N] : ph0[i]);
+    });
+    matmul_acc(row_block(rh, s, B), wh_n, zt_n);
+    pfControl.par_for(0, B * H, [&](const tcapint &i, const unsigned &cpu) {
+      const tcapint r = s + (i % B);
+      const tcapint j = i / B;
+      const real1 zg = pz[r + j * N];
+      real1 &n = pz[r + ((H << 1U) + j) * N];
+      n = (real1)std::tanh(n);
+      const real1 hp = s ? phs[r - B + j * N] : ph0[i];
+      phs[r + j * N] = (ONE_R1 - zg) * hp + zg * n;
+    });
+  }
+
+  last_step(hs, h_last);
+}
+
+void gru_sequence_grad(Tensor *dx, Tensor *dwx, Tensor *dwh,
+                       std::vector<real1> *db, const Tensor &dhs,
+                       const Tensor &x, const Tensor &wx, const Tensor &wh,
+                       const Tensor &h0, const Tensor &z, const Tensor &hs,
+                       const Tensor &rh) {
+  check_sequence(x, wx, wh, h0, 3U, z, hs);
+  const tcapint N = x.shape[0U];
+  const tcapint B = h0.shape[0U];
+  const tcapint H = wh.shape[0U];
+  if (!is_dense_matrix(dhs, N, H) || !is_dense_matrix(rh, N, H)) {
+    throw std::domain_error("gru_sequence_grad() requires dense [B * T, H] "
+                            "output gradient and reset states!");
+  }
+
+  TensorPtr dz =
+      Tensor::zeros({N, 3U * H}, false, false, DType::REAL, DeviceTag::CPU);
+  TensorPtr dh_next =
+      Tensor::zeros({B, H}, false, false, DType::REAL, DeviceTag::CPU);
+  TensorPtr drh =
+      Tensor::zeros({B, H}, false, false, DType::REAL, DeviceTag::CPU);
+  std::vector<real1> dh_direct(B * H);
+  const Tensor wh_zrT = transposed(column_view(wh, 0U, H << 1U));
+  const Tensor wh_nT = transposed(column_view(wh, H << 1U, H));
+  const real1 *pz = cpu_data(z);
+  const real1 *phs = cpu_data(hs);
+  const real1 *ph0 = cpu_data(h0);
+  const real1 *pdy = cpu_data(dhs);
+  real1 *pdz = cpu_data(*(dz.get()));
+  real1 *pdh = cpu_data(*(dh_next.get()));
+  const real1 *pdrh = cpu_data(*(drh.get()));
+
+  for (tcapint s = N; s > 0U;) {
+    s -= B;
+    pfControl.par_for(0, B * H, [&](const tcapint &i, const unsigned &cpu) {
+      const tcapint r = s + (i % B);
+      const tcapint j = i / B;
+      const real1 zg = pz[r + j * N];
+      const real1 n = pz[r + ((H << 1U) + j) * N];
+      const real1 hp = s ? phs[r - B + j * N] : ph0[i];
+      const real1 dh = pdy[r + j * N] + pdh[i];
+      pdz[r + j * N] = dh * (n - hp) * zg * (ONE_R1 - zg);
+      pdz[r + ((H << 1U) + j) * N] = dh * zg * (ONE_R1 - n * n);
+      dh_direct[i] = dh * (ONE_R1 - zg);
+    });
+    const Tensor dzt = row_block(*(dz.get()), s, B);
+    matmul(column_view(dzt, H << 1U, H), wh_nT, *(drh.get()));
+    pfControl.par_for(0, B * H, [&](const tcapint &i, const unsigned &cpu) {
+      const tcapint r = s + (i % B);
+      const tcapint j = i / B;
+      const real1 rg = pz[r + (H + j) * N];
+      const real1 hp = s ? phs[r - B + j * N] : ph0[i];
+      pdz[r + (H + j) * N] = pdrh[i] * hp * rg * (ONE_R1 - rg);
+      dh_direct[i] += pdrh[i] * rg;
+    });
+    if (s) {
+      matmul(column_view(dzt, 0U, H << 1U), wh_zrT, *(dh_next.get()));
+      for (tcapint i = 0U; i < (B * H); ++i) {
+        pdh[i] += dh_direct[i];
+      }
+    }
+  }
+
+  if (dwh) {
+    const TensorPtr hp = previous_states(h0, hs);
+    Tensor dwh_zr = column_view(*dwh, 0U, H << 1U);
+    Tensor dwh_n = column_view(*dwh, H << 1U, H);
+    matmul_acc(transposed(*(hp.get())), column_view(*(dz.get()), 0U, H << 1U),
+               dwh_zr);
+    matmul_acc(transposed(rh), column_view(*(dz.get()), H << 1U, H), dwh_n);
+  }
+  input_grads(dx, dwx, db, *(dz.get()), x, wx);
+}
+} // namespace Weed
@@ -0,0 +1,95 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#include "ops/rope.hpp"
+#include "common/parallel_for.hpp"
+#include "storage/all_storage.hpp"
+
+namespace Weed {
+static real1 *cpu_data(const Tensor &t) {
+  return static_cast<CpuRealStorage *>(t.storage.get())->data.get() + t.offset;
+}
+
+static bool is_dense_cpu(const Tensor &t) {
+  return t.storage->stype == StorageType::REAL_CPU_DENSE;
+}
+
+bool can_rope(const Tensor &x, const Tensor &cos_table,
+              const Tensor &sin_table, const tcapint &pos) {
+  if ((x.shape.size() != 4U) || !is_dense_cpu(x) || !is_dense_cpu(cos_table) ||
+      !is_dense_cpu(sin_table) || (cos_table.shape.size() != 2U) ||
+      (cos_table.shape != sin_table.shape) || !cos_table.is_packed() ||
+      !sin_table.is_packed()) {
+    return false;
+  }
+  const tcapint D = x.shape[3U];
+
+  return !(D & 1U) && (D == cos_table.shape[1U]) &&
+         ((pos + x.shape[2U]) <= cos_table.shape[0U]);
+}
+
+// Rotate each pair of every [B, H, T] row of x into y, by R, or by R^T for
+// the gradient (which accumulates).
+static void rotate(Tensor &y, const Tensor &x, const Tensor &cos_table,
+                   const Tensor &sin_table, const tcapint &pos,
+                   const bool &is_grad) {
+  if (!can_rope(x, cos_table, sin_table, pos) || !is_dense_cpu(y) ||
+      (y.shape != x.shape)) {
+    throw std::domain_error("rope() requires dense CPU real [B, H, T, "
+                            "head_dim] tensors, and positions in range of "
+                            "the tables!");
+  }
+
+  const tcapint B = x.shape[0U];
+  const tcapint H = x.shape[1U];
+  const tcapint T = x.shape[2U];
+  const tcapint half = x.shape[3U] >> 1U;
+  const tcapint L = cos_table.shape[0U];
+  const real1 *pc = cpu_data(cos_table);
+  const real1 *ps = cpu_data(sin_table);
+  const real1 *px = cpu_data(x);
+  real1 *py = cpu_data(y);
+  const std::vector<tcapint> &xs = x.stride;
+  const std::vector<tcapint> &ys = y.stride;
+
+  pfControl.par_for(0, B * H * T, [&](const tcapint &r, const unsigned &cpu) {
+    const tcapint t = r % T;
+    const tcapint h = (r / T) % H;
+    const tcapint b = r / (T * H);
+    const real1 *xr = px + b * xs[0U] + h * xs[1U] + t * xs[2U];
+    real1 *yr = py + b * ys[0U] + h * ys[1U] + t * ys[2U];
+    const real1 *cr = pc + pos + t;
+    const real1 *sr = ps + pos + t;
+    for (tcapint j = 0U; j < half; ++j) {
+      const tcapint k = j + half;
+      const real1 x0 = xr[j * xs[3U]];
+      const real1 x1 = xr[k * xs[3U]];
+      if (is_grad) {
+        yr[j * ys[3U]] += x0 * cr[j * L] + x1 * sr[k * L];
+        yr[k * ys[3U]] += x1 * cr[k * L] - x0 * sr[j * L];
+      } else {
+        yr[j * ys[3U]] = x0 * cr[j * L] - x1 * sr[j * L];
+        yr[k * ys[3U]] = x1 * cr[k * L] + x0 * sr[k * L];
+      }
+    }
+  });
+}
+
+void rope(Tensor &y, const Tensor &x, const Tensor &cos_table,
+          const Tensor &sin_table, const tcapint &pos) {
+  rotate(y, x, cos_table, sin_table, pos, false);
+}
+
+void rope_grad(Tensor &dx, const Tensor &dy, const Tensor &cos_table,
+               const Tensor &sin_table, const tcapint &pos) {
+  rotate(dx, dy, cos_table, sin_table, pos, true);
+}
+} // namespace Weed
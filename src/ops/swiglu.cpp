@@ -0,0 +1,120 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#include "ops/swiglu.hpp"
+#include "common/parallel_for.hpp"
+#include "ops/matmul.hpp"
+#include "storage/all_storage.hpp"
+
+#include <cmath>
+
+namespace Weed {
+static real1 *cpu_data(const Tensor &t) {
+  return static_cast<CpuRealStorage *>(t.storage.get())->data.get() + t.offset;
+}
+
+static bool is_dense_matrix(const Tensor &t, const tcapint &rows,
+                            const tcapint &cols) {
+  return (t.storage->stype == StorageType::REAL_CPU_DENSE) &&
+         (t.shape == std::vector<tcapint>{rows, cols}) && t.is_packed();
+}
+
+bool can_swiglu(const Tensor &x, const Tensor &wg, const Tensor &wu) {
+  if ((wg.shape.size() != 2U) || (wg.shape != wu.shape) || !wg.shape[0U] ||
+      !wg.shape[1U] || x.shape.empty() || (x.shape.back() != wg.shape[0U]) ||
+      (x.storage->stype != StorageType::REAL_CPU_DENSE)) {
+    return false;
+  }
+  for (const Tensor *w : {&wg, &wu}) {
+    if ((w->storage->dtype != DType::REAL) ||
+        (w->storage->device != DeviceTag::CPU)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void swiglu(const Tensor &x, const Tensor &wg, const Tensor &wu, Tensor &gu,
+            Tensor &a) {
+  const tcapint I = wg.shape[1U];
+  const tcapint R = x.shape.empty() ? 0U : x.shape[0U];
+  if ((x.shape.size() != 2U) || !can_swiglu(x, wg, wu) ||
+      !is_dense_matrix(gu, R, I << 1U) || !is_dense_matrix(a, R, I)) {
+    throw std::domain_error("swiglu() requires [rows, in] dense CPU real "
+                            "input, CPU real weights, and dense contiguous "
+                            "outputs!");
+  }
+
+  Tensor g = column_view(gu, 0U, I);
+  Tensor u = column_view(gu, I, I);
+  matmul(x, wg, g);
+  matmul(x, wu, u);
+
+  // Epilogue: column-major, so the up block starts R * I past the gate block
+  const real1 *pg = cpu_data(gu);
+  const real1 *pu = pg + R * I;
+  real1 *pa = cpu_data(a);
+  pfControl.par_for(0, R * I, [&](const tcapint &i, const unsigned &cpu) {
+    const real1 v = pg[i];
+    pa[i] = v / (ONE_R1 + (real1)std::exp(-v)) * pu[i];
+  });
+}
+
+void swiglu_grad(Tensor *dx, Tensor *dwg, Tensor *dwu, const Tensor &da,
+                 const Tensor &x, const Tensor &wg, const Tensor &wu,
+                 const Tensor &gu) {
+  const tcapint in = wg.shape[0U];
+  const tcapint I = wg.shape[1U];
+  const tcapint R = x.shape.empty() ? 0U : x.shape[0U];
+  if ((x.shape.size() != 2U) || !can_swiglu(x, wg, wu) ||
+      !is_dense_matrix(gu, R, I << 1U) || !is_dense_matrix(da, R, I) ||
+      (dx && !is_dense_matrix(*dx, R, in))) {
+    throw std::domain_error("swiglu_grad() requires dense CPU real tensors "
+                            "of the forward shapes!");
+  }
+
+  TensorPtr d =
+      Tensor::zeros({R, I << 1U}, false, false, DType::REAL, DeviceTag::CPU);
+  const real1 *pg = cpu_data(gu);
+  const real1 *pu = pg + R * I;
+  const real1 *pda = cpu_data(da);
+  real1 *pdg = cpu_data(*(d.get()));
+  real1 *pdu = pdg + R * I;
+  pfControl.par_for(0, R * I, [&](const tcapint &i, const unsigned &cpu) {
+    const real1 v = pg[i];
+    const real1 s = ONE_R1 / (ONE_R1 + (real1)std::exp(-v));
+    pdg[i] = pda[i] * pu[i] * s * (ONE_R1 + v * (ONE_R1 - s));
+    pdu[i] = pda[i] * v * s;
+  });
+
+  const Tensor dg = column_view(*(d.get()), 0U, I);
+  const Tensor du = column_view(*(d.get()), I, I);
+  if (dx) {
+    Tensor wgT(wg);
+    wgT.transpose();
+    Tensor wuT(wu);
+    wuT.transpose();
+    matmul_acc(dg, wgT, *dx);
+    matmul_acc(du, wuT, *dx);
+  }
+  if (dwg || dwu) {
+    Tensor xT(x);
+    xT.transpose();
+    if (dwg) {
+      matmul_acc(xT, dg, *dwg);
+    }
+    if (dwu) {
+      matmul_acc(xT, du, *dwu);
+    }
+  }
+}
+} // namespace Weed
@@ -9,6 +9,8 @@
 #include "shared_api.hpp"
 
 #include "autograd/cross_entropy_loss.hpp"
+#include "autograd/grad_accumulator.hpp"
+#include "autograd/grad_mode.hpp"
 #include "autograd/sgd.hpp"
 #include "modules/module.hpp"
 #include "storage/cpu_storage.hpp"
@@ -67,7 +69,8 @@ struct ModuleResult {
   ModulePtr m;
   TensorPtr t;
   int error;
-  ModuleResult(ModulePtr a) : m(a), t(nullptr), error(0) {}
+  std::unique_ptr<GradAccumulator> acc;
+  ModuleResult(ModulePtr a) : m(a), t(nullptr), error(0), acc(nullptr) {}
 };
 typedef std::unique_ptr<ModuleResult> ModuleResultPtr;
 
@@ -76,6 +79,51 @@ int meta_error = 0;
 
 std::vector<ModuleResultPtr> module_results;
 
+// Forward and cross-entropy loss of one token batch, in training mode
+static TensorPtr train_loss(const uintw &mid, const uintw &n,
+                            const uintw *shape, const intw *input_ids,
+                            const uintw &n_target, const intw *target_ids) {
+  // 1. Switch to training mode
+  module_results[mid]->m->train();
+
+  // 2. Build input SymbolTensor (same as forward_int)
+  std::vector<tcapint> sh(n);
+  std::vector<tcapint> st(n);
+  tcapint stride = 1U;
+  for (size_t i = 0U; i < n; ++i) {
+    sh[i] = (tcapint)shape[i];
+    st[i] = stride;
+    stride *= sh[i];
+  }
+  tcapint max_index = 0U;
+  for (size_t i = 0U; i < sh.size(); ++i) {
+    max_index += (sh[i] - 1U) * st[i];
+  }
+  if (!sh.empty()) {
+    ++max_index;
+  }
+  std::vector<symint> v(max_index);
+  for (size_t i = 0U; i < max_index; ++i) {
+    v[i] = (symint)input_ids[i];
+  }
+  SymbolTensorPtr x = std::make_shared<SymbolTensor>(v, sh);
+
+  std::vector<symint> tgt(n_target);
+  for (tcapint i = 0U; i < n_target; ++i) {
+    tgt[i] = (symint)target_ids[i];
+  }
+  SymbolTensorPtr targets = std::make_shared<SymbolTensor>(
+      tgt, std::vector<tcapint>{(tcapint)n_target});
+
+  // 3. Forward pass
+  TensorPtr logits = module_results[mid]->m->forward(x);
+  // logits shape: [1, seq_len, vocab_size]
+
+  // 4. Cross-entropy loss over target_ids
+  // For each position t, loss += -log(softmax(logits[0,t,:])[target_ids[t]])
+  return cross_entropy_loss(logits, targets);
+}
+
 extern "C" {
 MICROSOFT_QUANTUM_DECL int get_error(_In_ const uintw mid) {
   if (meta_error) {
@@ -100,9 +148,7 @@ MICROSOFT_QUANTUM_DECL uintw load_module(_In_ const char *f) {
   bool is_success = true;
   ModulePtr m;
   try {
-    std::ifstream i(f);
-    m = Module::load(i);
-    i.close();
+    m = Module::load_mapped(f);
     m->eval();
   } catch (const std::exception &ex) {
     std::cout << ex.what() << std::endl;
@@ -141,6 +187,21 @@ MICROSOFT_QUANTUM_DECL void save_module(_In_ uintw mid, _In_ const char *f) {
   }
 }
 
+MICROSOFT_QUANTUM_DECL void save_module_aligned(_In_ uintw mid,
+                                                _In_ const char *f) {
+  MODULE_LOCK_GUARD_VOID(mid);
+
+  try {
+    std::ofstream o(f, std::ios::binary);
+    module_results[mid]->m->train();
+    module_results[mid]->m->save_aligned(o);
+    o.close();
+  } catch (const std::exception &ex) {
+    std::cout << ex.what() << std::endl;
+    meta_error = 1;
+  }
+}
+
 MICROSOFT_QUANTUM_DECL void free_module(_In_ uintw mid) {
   {
     MODULE_LOCK_GUARD_VOID(mid);
@@ -196,6 +257,7 @@ MICROSOFT_QUANTUM_DECL void forward(_In_ uintw mid, _In_ uintw dtype,
   }
 
   try {
+    NoGradGuard no_grad;
     module_results[mid]->t =
         Tensor::contiguous(module_results[mid]->m->forward(x));
   } catch (const std::exception &ex) {
@@ -240,6 +302,7 @@ MICROSOFT_QUANTUM_DECL void forward_int(_In_ uintw mid, _In_ uintw dtype,
   }
 
   try {
+    NoGradGuard no_grad;
     module_results[mid]->t =
         Tensor::contiguous(module_results[mid]->m->forward(x));
   } catch (const std::exception &ex) {
@@ -360,45 +423,9 @@ train_step(_In_ uintw mid, _In_ uintw n, _In_reads_(n) uintw *shape,
   MODULE_LOCK_GUARD_VOID(mid);
 
   try {
-    // 1. Switch to training mode
-    module_results[mid]->m->train();
-
-    // 2. Build input SymbolTensor (same as forward_int)
-    std::vector<tcapint> sh(n);
-    std::vector<tcapint> st(n);
-    tcapint stride = 1U;
-    for (size_t i = 0U; i < n; ++i) {
-      sh[i] = (tcapint)shape[i];
-      st[i] = stride;
-      stride *= sh[i];
-    }
-    tcapint max_index = 0U;
-    for (size_t i = 0U; i < sh.size(); ++i) {
-      max_index += (sh[i] - 1U) * st[i];
-    }
-    if (!sh.empty()) {
-      ++max_index;
-    }
-    std::vector<symint> v(max_index);
-    for (size_t i = 0U; i < max_index; ++i) {
-      v[i] = (symint)input_ids[i];
-    }
-    SymbolTensorPtr x = std::make_shared<SymbolTensor>(v, sh);
-
-    std::vector<symint> tgt(n_target);
-    for (tcapint i = 0U; i < n_target; ++i) {
-      tgt[i] = (symint)target_ids[i];
-    }
-    SymbolTensorPtr targets = std::make_shared<SymbolTensor>(
-        tgt, std::vector<tcapint>{(tcapint)n_target});
-
-    // 3. Forward pass
-    TensorPtr logits = module_results[mid]->m->forward(x);
-    // logits shape: [1, seq_len, vocab_size]
-
-    // 4. Cross-entropy loss over target_ids
-    // For each position t, loss += -log(softmax(logits[0,t,:])[target_ids[t]])
-    TensorPtr loss = cross_entropy_loss(logits, targets);
+    // 1-4. Training mode, forward pass, and cross-entropy loss
+    TensorPtr loss =
+        train_loss(mid, n, shape, input_ids, n_target, target_ids);
 
     // 5. Backward pass
     Tensor::backward(loss);
@@ -414,8 +441,9 @@ train_step(_In_ uintw mid, _In_ uintw n, _In_reads_(n) uintw *shape,
     //     }
     // }
 
-    // 8. Back to eval mode
+    // 8. Back to eval mode (which drops any train_accumulate() gradients)
     module_results[mid]->m->eval();
+    module_results[mid]->acc = nullptr;
 
   } catch (const std::exception &ex) {
     std::cout << ex.what() << std::endl;
@@ -423,6 +451,44 @@ train_step(_In_ uintw mid, _In_ uintw n, _In_reads_(n) uintw *shape,
   }
 }
 
+// Back-propagate one micro-batch, adding to gradients kept since the last
+// train_apply()
+MICROSOFT_QUANTUM_DECL void
+train_accumulate(_In_ uintw mid, _In_ uintw n, _In_reads_(n) uintw *shape,
+                 _In_ intw *input_ids, _In_ uintw n_target,
+                 _In_reads_(n_target) intw *target_ids) {
+  MODULE_LOCK_GUARD_VOID(mid);
+
+  try {
+    std::unique_ptr<GradAccumulator> &acc = module_results[mid]->acc;
+    if (!acc) {
+      acc = std::unique_ptr<GradAccumulator>(
+          new GradAccumulator(module_results[mid]->m->parameters()));
+    }
+    acc->accumulate(
+        train_loss(mid, n, shape, input_ids, n_target, target_ids));
+    // The module stays in training mode, so the gradients persist.
+  } catch (const std::exception &ex) {
+    std::cout << ex.what() << std::endl;
+    module_results[mid]->error = 1;
+  }
+}
+
+// SGD step on the mean of the gradients accumulated by train_accumulate()
+MICROSOFT_QUANTUM_DECL void train_apply(_In_ uintw mid,
+                                        _In_ double learning_rate) {
+  MODULE_LOCK_GUARD_VOID(mid);
+
+  try {
+    if (module_results[mid]->acc) {
+      module_results[mid]->acc->sgd_step(real1(learning_rate));
+    }
+  } catch (const std::exception &ex) {
+    std::cout << ex.what() << std::endl;
+    module_results[mid]->error = 1;
+  }
+}
+
 /// Reset KV cache
 MICROSOFT_QUANTUM_DECL void reset_kv_cache(_In_ uintw mid) {
   MODULE_LOCK_GUARD_VOID(mid);
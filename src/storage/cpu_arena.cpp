@@ -0,0 +1,186 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#include "storage/cpu_arena.hpp"
+#include "storage/cpu_complex_storage.hpp"
+#include "storage/cpu_int_storage.hpp"
+#include "storage/cpu_real_storage.hpp"
+#include "storage/memory_plan.hpp"
+#include "tensors/symbol_tensor.hpp"
+#include "tensors/tensor.hpp"
+
+namespace Weed {
+static thread_local CpuArena *bound_arena = nullptr;
+
+CpuArena::Block::Block(const size_t &cap)
+    : mem(TypedStorage<unsigned char>::Alloc(cap)), capacity(cap), top(0U) {
+  if (!mem) {
+    throw std::bad_alloc();
+  }
+}
+
+void *CpuArena::allocate(size_t bytes) {
+  bytes = ((bytes + WEED_ALIGN_SIZE - 1U) / WEED_ALIGN_SIZE) * WEED_ALIGN_SIZE;
+
+  while (current_block < blocks.size()) {
+    Block &b = blocks[current_block];
+    if ((b.capacity - b.top) >= bytes) {
+      break;
+    }
+    ++current_block;
+  }
+
+  if (current_block == blocks.size()) {
+    blocks.emplace_back(std::max(bytes, block_bytes));
+  }
+
+  Block &b = blocks[current_block];
+  unsigned char *p = b.mem.get() + b.top;
+  b.top += bytes;
+  used += bytes;
+  if (used > peak) {
+    peak = used;
+  }
+
+  return p;
+}
+
+void CpuArena::release() {
+  if (blocks.size() > 1U) {
+    // Coalesce, so the next pass of the same shape fits in one region
+    const size_t total = get_capacity();
+    blocks.clear();
+    blocks.emplace_back(total);
+  } else if (blocks.size()) {
+    blocks[0U].top = 0U;
+  }
+  current_block = 0U;
+  used = 0U;
+}
+
+bool CpuArena::owns(const void *p) const {
+  const unsigned char *c = (const unsigned char *)p;
+  for (const Block &b : blocks) {
+    if ((c >= b.mem.get()) && (c < (b.mem.get() + b.capacity))) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+size_t CpuArena::get_capacity() const {
+  size_t total = 0U;
+  for (const Block &b : blocks) {
+    total += b.capacity;
+  }
+
+  return total;
+}
+
+CpuArena *CpuArena::current() { return bound_arena; }
+
+template <typename S>
+static StoragePtr persist_storage(const CpuArena *arena, const StoragePtr &sp) {
+  S *s = static_cast<S *>(sp.get());
+  if (!arena->owns(s->data.get())) {
+    return sp;
+  }
+
+  std::shared_ptr<S> n = std::make_shared<S>(s->size);
+  std::copy(s->data.get(), s->data.get() + s->size, n->data.get());
+
+  return n;
+}
+
+// A detached copy of dense CPU storage held by the arena, else sp itself
+static StoragePtr persist_any(const CpuArena *arena, const StoragePtr &sp) {
+  switch (sp->stype) {
+  case StorageType::REAL_CPU_DENSE:
+    return persist_storage<CpuRealStorage>(arena, sp);
+  case StorageType::COMPLEX_CPU_DENSE:
+    return persist_storage<CpuComplexStorage>(arena, sp);
+  case StorageType::INT_CPU_DENSE:
+    return persist_storage<CpuIntStorage>(arena, sp);
+  default:
+    // Sparse and GPU storage never come from the arena.
+    return sp;
+  }
+}
+
+TensorPtr CpuArena::persist(const TensorPtr &t) {
+  const CpuArena *arena = current();
+  if (!arena) {
+    return t;
+  }
+  if (t->requires_grad) {
+    throw std::invalid_argument("CpuArena::persist() is for inference only, "
+                                "but the tensor requires gradient!");
+  }
+
+  ArenaSuspend suspend;
+  const StoragePtr sp = persist_any(arena, t->storage);
+  if (sp == t->storage) {
+    return t;
+  }
+
+  TensorPtr out = std::make_shared<Tensor>(*t);
+  out->storage = sp;
+  out->grad_node = nullptr;
+  out->grad = nullptr;
+
+  return out;
+}
+
+SymbolTensorPtr CpuArena::persist(const SymbolTensorPtr &t) {
+  const CpuArena *arena = current();
+  if (!arena) {
+    return t;
+  }
+
+  ArenaSuspend suspend;
+  const StoragePtr sp = persist_any(arena, t->storage);
+  if (sp == t->storage) {
+    return t;
+  }
+
+  SymbolTensorPtr out = std::make_shared<SymbolTensor>(*t);
+  out->storage = sp;
+
+  return out;
+}
+
+ArenaGuard::ArenaGuard(CpuArena &a) : arena(a), prior(bound_arena) {
+  if (arena.bound) {
+    throw std::invalid_argument(
+        "ArenaGuard cannot bind a CpuArena that is already bound!");
+  }
+  arena.bound = true;
+  bound_arena = &arena;
+}
+
+ArenaGuard::~ArenaGuard() {
+  bound_arena = prior;
+  arena.bound = false;
+  arena.release();
+}
+
+ArenaSuspend::ArenaSuspend()
+    : prior(bound_arena), prior_plan(MemoryPlan::current()) {
+  bound_arena = nullptr;
+  MemoryPlan::set_current(nullptr);
+}
+
+ArenaSuspend::~ArenaSuspend() {
+  bound_arena = prior;
+  MemoryPlan::set_current(prior_plan);
+}
+} // namespace Weed
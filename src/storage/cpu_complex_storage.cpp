@@ -35,8 +35,6 @@ StoragePtr CpuComplexStorage::gpu(const int64_t &did) {
 }
 void CpuComplexStorage::save(std::ostream &os) const {
   Storage::save(os);
-  for (tcapint i = 0U; i < size; ++i) {
-    Serializer::write_complex(os, data[i]);
-  }
+  write_payload(os, data.get(), sizeof(complex), size);
 }
 } // namespace Weed
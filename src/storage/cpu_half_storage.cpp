@@ -0,0 +1,79 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#include "storage/cpu_half_storage.hpp"
+#include "storage/cpu_complex_storage.hpp"
+#include "storage/cpu_real_storage.hpp"
+#if ENABLE_GPU
+#include "storage/gpu_real_storage.hpp"
+#endif
+
+namespace Weed {
+template <typename Codec>
+StoragePtr CpuHalfStorage<Codec>::Upcast(const DType &dt) {
+  if (dt != DType::COMPLEX) {
+    return get_ptr();
+  }
+
+  CpuComplexStoragePtr n = std::make_shared<CpuComplexStorage>(size);
+  for (tcapint i = 0U; i < size; ++i) {
+    n->data[i] = complex((real1)get(i), ZERO_R1);
+  }
+
+  return n;
+}
+
+template <typename Codec>
+StoragePtr CpuHalfStorage<Codec>::gpu(const int64_t &did) {
+#if ENABLE_GPU
+  std::vector<real1> v(size);
+  for (tcapint i = 0U; i < size; ++i) {
+    v[i] = (real1)get(i);
+  }
+
+  return std::make_shared<GpuRealStorage>(v, did);
+#else
+  return get_ptr();
+#endif
+}
+
+template struct CpuHalfStorage<Fp16Codec>;
+template struct CpuHalfStorage<Bf16Codec>;
+
+StoragePtr cast_cpu_real_storage(const StoragePtr &s, const StorageType &st) {
+  if ((s->device != DeviceTag::CPU) || (s->dtype != DType::REAL) ||
+      s->is_sparse()) {
+    throw std::invalid_argument("cast_cpu_real_storage() requires dense, "
+                                "real-valued CPU storage!");
+  }
+  if (s->stype == st) {
+    return s;
+  }
+
+  const RealStorage &orig = *static_cast<RealStorage *>(s.get());
+  switch (st) {
+  case StorageType::REAL_CPU_DENSE: {
+    CpuRealStoragePtr n = std::make_shared<CpuRealStorage>(orig.size);
+    for (tcapint i = 0U; i < orig.size; ++i) {
+      n->data[i] = orig[i];
+    }
+    return n;
+  }
+  case StorageType::REAL_CPU_FP16:
+    return std::make_shared<CpuFp16Storage>(orig);
+  case StorageType::REAL_CPU_BF16:
+    return std::make_shared<CpuBf16Storage>(orig);
+  default:
+    throw std::invalid_argument(
+        "cast_cpu_real_storage() target must be a dense CPU real StorageType!");
+  }
+}
+} // namespace Weed
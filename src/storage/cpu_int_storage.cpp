@@ -34,8 +34,6 @@ StoragePtr CpuIntStorage::gpu(const int64_t &did) {
 }
 void CpuIntStorage::save(std::ostream &os) const {
   Storage::save(os);
-  for (tcapint i = 0U; i < size; ++i) {
-    Serializer::write_symint(os, data[i]);
-  }
+  write_payload(os, data.get(), sizeof(symint), size);
 }
 } // namespace Weed
@@ -44,9 +44,34 @@ StoragePtr CpuRealStorage::Upcast(const DType &dt) {
   return n;
 }
 void CpuRealStorage::save(std::ostream &os) const {
-  Storage::save(os);
-  for (tcapint i = 0U; i < size; ++i) {
-    Serializer::write_real(os, data[i]);
+  if (Storage::get_aligned_blobs()) {
+    const size_t bytes = sizeof(real1) * (size_t)size;
+    const bool header = Storage::get_blob_headers();
+    write_storage_type(
+        os, header ? (StorageType)(StorageType::REAL_CPU_ALIGNED |
+                                   StorageType::STORAGE_HEADER_FLAG)
+                   : StorageType::REAL_CPU_ALIGNED);
+    Serializer::write_int64(os, get_device_id());
+    Serializer::write_tcapint(os, size);
+    if (header) {
+      write_blob_header(os, sizeof(real1), data.get(), bytes);
+    }
+    // Pad so the blob starts WEED_ALIGN_SIZE-aligned in the file.
+    const std::streamoff pos = os.tellp() + (std::streamoff)1;
+    const uint8_t pad =
+        (pos <= 0) ? 0U
+                   : (uint8_t)((WEED_ALIGN_SIZE - (pos % WEED_ALIGN_SIZE)) %
+                               WEED_ALIGN_SIZE);
+    Serializer::write_uint8(os, pad);
+    for (uint8_t i = 0U; i < pad; ++i) {
+      Serializer::write_uint8(os, 0U);
+    }
+    Serializer::write_block(os, data.get(), size);
+
+    return;
   }
+
+  Storage::save(os);
+  write_payload(os, data.get(), sizeof(real1), size);
 }
 } // namespace Weed
@@ -24,16 +24,12 @@ void GpuComplexStorage::save(std::ostream &os) const {
   Storage::save(os);
   if (data) {
     dev->LockSync(buffer, sizeof(complex) * size, data.get(), false);
-    for (tcapint i = 0U; i < size; ++i) {
-      Serializer::write_complex(os, data.get()[i]);
-    }
+    write_payload(os, data.get(), sizeof(complex), size);
     dev->UnlockSync(buffer, data.get());
   } else {
     std::unique_ptr<complex[], void (*)(complex *)> d(Alloc(size));
     dev->LockSync(buffer, sizeof(complex) * size, d.get(), false);
-    for (tcapint i = 0U; i < size; ++i) {
-      Serializer::write_complex(os, d.get()[i]);
-    }
+    write_payload(os, d.get(), sizeof(complex), size);
   }
 }
 } // namespace Weed
@@ -24,16 +24,12 @@ void GpuIntStorage::save(std::ostream &os) const {
   Storage::save(os);
   if (data) {
     dev->LockSync(buffer, sizeof(symint) * size, data.get(), false);
-    for (tcapint i = 0U; i < size; ++i) {
-      Serializer::write_symint(os, data.get()[i]);
-    }
+    write_payload(os, data.get(), sizeof(symint), size);
     dev->UnlockSync(buffer, data.get());
   } else {
     std::unique_ptr<symint[], void (*)(symint *)> d(Alloc(size));
     dev->LockSync(buffer, sizeof(symint) * size, d.get(), false);
-    for (tcapint i = 0U; i < size; ++i) {
-      Serializer::write_symint(os, d.get()[i]);
-    }
+    write_payload(os, d.get(), sizeof(symint), size);
   }
 }
 } // namespace Weed
@@ -36,16 +36,12 @@ void GpuRealStorage::save(std::ostream &os) const {
   Storage::save(os);
   if (data) {
     dev->LockSync(buffer, sizeof(real1) * size, data.get(), false);
-    for (tcapint i = 0U; i < size; ++i) {
-      Serializer::write_real(os, data.get()[i]);
-    }
+    write_payload(os, data.get(), sizeof(real1), size);
     dev->UnlockSync(buffer, data.get());
   } else {
     std::unique_ptr<real1[], void (*)(real1 *)> d(Alloc(size));
     dev->LockSync(buffer, sizeof(real1) * size, d.get(), false);
-    for (tcapint i = 0U; i < size; ++i) {
-      Serializer::write_real(os, d.get()[i]);
-    }
+    write_payload(os, d.get(), sizeof(real1), size);
   }
 }
 } // namespace Weed
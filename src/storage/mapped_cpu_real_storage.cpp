@@ -0,0 +1,72 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#include "storage/mapped_cpu_real_storage.hpp"
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Weed {
+static thread_local MappedFilePtr current_mapping = nullptr;
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+// No POSIX mmap: read the whole file into (aligned) memory, once.
+MappedFile::MappedFile(const std::string &path) : base(nullptr), length(0U) {
+  std::ifstream f(path, std::ios::binary | std::ios::ate);
+  if (!f) {
+    throw std::invalid_argument("MappedFile couldn't open " + path);
+  }
+  length = (size_t)f.tellg();
+  base = (unsigned char *)_aligned_malloc(length ? length : 1U,
+                                          WEED_ALIGN_SIZE);
+  f.seekg(0);
+  f.read((char *)base, length);
+}
+MappedFile::~MappedFile() { _aligned_free(base); }
+#else
+MappedFile::MappedFile(const std::string &path) : base(nullptr), length(0U) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::invalid_argument("MappedFile couldn't open " + path);
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) || !st.st_size) {
+    close(fd);
+    throw std::invalid_argument("MappedFile couldn't stat (or empty) " + path);
+  }
+  length = (size_t)st.st_size;
+
+  // Private, writable mapping: copy-on-write, so training never touches disk.
+  void *p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED) {
+    throw std::runtime_error("MappedFile couldn't mmap " + path);
+  }
+  base = (unsigned char *)p;
+}
+MappedFile::~MappedFile() { munmap(base, length); }
+#endif
+
+MappedFilePtr MappedFile::current() { return current_mapping; }
+
+MappedLoadScope::MappedLoadScope(const MappedFilePtr &m)
+    : prior(current_mapping) {
+  current_mapping = m;
+}
+MappedLoadScope::~MappedLoadScope() { current_mapping = prior; }
+} // namespace Weed
@@ -0,0 +1,239 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#include "storage/memory_plan.hpp"
+#include "storage/cpu_complex_storage.hpp"
+#include "storage/cpu_int_storage.hpp"
+#include "storage/cpu_real_storage.hpp"
+#include "tensors/symbol_tensor.hpp"
+#include "tensors/tensor.hpp"
+
+#include <algorithm>
+
+namespace Weed {
+static thread_local MemoryPlan *bound_plan = nullptr;
+
+MemoryPlan::MemoryPlan(const std::vector<tcapint> &shp)
+    : shape(shp), intervals(), recording(true), bound(false), clock(0U),
+      cursor(0U), misses(0U), slab_bytes(0U), live_peak_bytes(0U), live(),
+      scratch(), slab(nullptr, TypedStorage<unsigned char>::deleter) {}
+
+void *MemoryPlan::allocate(size_t bytes) {
+  bytes = ((std::max(bytes, (size_t)1U) + WEED_ALIGN_SIZE - 1U) /
+           WEED_ALIGN_SIZE) *
+          WEED_ALIGN_SIZE;
+
+  if (!recording) {
+    const size_t i = cursor++;
+    if ((i >= intervals.size()) || (bytes > intervals[i].bytes)) {
+      ++misses;
+      return nullptr;
+    }
+
+    return slab.get() + intervals[i].offset;
+  }
+
+  scratch.push_back(TypedStorage<unsigned char>::Alloc(bytes));
+  void *p = scratch.back().get();
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  live[p] = intervals.size();
+  intervals.push_back(Interval{bytes, clock++, 0U, 0U});
+
+  size_t total = 0U;
+  for (const auto &l : live) {
+    total += intervals[l.second].bytes;
+  }
+  if (total > live_peak_bytes) {
+    live_peak_bytes = total;
+  }
+
+  return p;
+}
+
+void MemoryPlan::deallocate(const void *p) {
+  const auto it = live.find(p);
+  if (it == live.end()) {
+    return;
+  }
+  intervals[it->second].end = clock++;
+  live.erase(it);
+}
+
+void MemoryPlan::finalize() {
+  if (!recording) {
+    return;
+  }
+  recording = false;
+
+  // Whatever is still live was held to the end of the pass
+  for (const auto &l : live) {
+    intervals[l.second].end = clock;
+  }
+  live.clear();
+  scratch.clear();
+
+  std::vector<size_t> order(intervals.size());
+  for (size_t i = 0U; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [this](const size_t &a, const size_t &b) {
+                     return intervals[a].bytes > intervals[b].bytes;
+                   });
+
+  // Greedy by size: place each buffer at the lowest offset that doesn't
+  // collide with any already-placed buffer of overlapping lifetime
+  slab_bytes = 0U;
+  std::vector<size_t> placed;
+  for (const size_t &i : order) {
+    Interval &b = intervals[i];
+    std::vector<const Interval *> conflicts;
+    for (const size_t &j : placed) {
+      const Interval &o = intervals[j];
+      if ((o.end >= b.start) && (b.end >= o.start)) {
+        conflicts.push_back(&o);
+      }
+    }
+    std::sort(conflicts.begin(), conflicts.end(),
+              [](const Interval *a, const Interval *c) {
+                return a->offset < c->offset;
+              });
+    size_t offset = 0U;
+    for (const Interval *o : conflicts) {
+      if ((offset + b.bytes) <= o->offset) {
+        break;
+      }
+      offset = std::max(offset, o->offset + o->bytes);
+    }
+    b.offset = offset;
+    slab_bytes = std::max(slab_bytes, offset + b.bytes);
+    placed.push_back(i);
+  }
+
+  slab = TypedStorage<unsigned char>::Alloc(slab_bytes);
+  if (slab_bytes && !slab) {
+    throw std::bad_alloc();
+  }
+}
+
+bool MemoryPlan::owns(const void *p) const {
+  const unsigned char *c = (const unsigned char *)p;
+
+  return slab && (c >= slab.get()) && (c < (slab.get() + slab_bytes));
+}
+
+size_t MemoryPlan::get_unplanned_bytes() const {
+  size_t total = 0U;
+  for (const Interval &i : intervals) {
+    total += i.bytes;
+  }
+
+  return total;
+}
+
+MemoryPlan *MemoryPlan::current() { return bound_plan; }
+
+void MemoryPlan::set_current(MemoryPlan *p) { bound_plan = p; }
+
+void MemoryPlan::notify_free(const void *p) {
+  if (bound_plan && bound_plan->recording) {
+    bound_plan->deallocate(p);
+  }
+}
+
+template <typename S>
+static StoragePtr persist_storage(const MemoryPlan *plan,
+                                  const StoragePtr &sp) {
+  S *s = static_cast<S *>(sp.get());
+  if (!plan->owns(s->data.get())) {
+    return sp;
+  }
+
+  std::shared_ptr<S> n = std::make_shared<S>(s->size);
+  std::copy(s->data.get(), s->data.get() + s->size, n->data.get());
+
+  return n;
+}
+
+// A detached copy of dense CPU storage in the plan's slab, else sp itself
+static StoragePtr persist_any(const MemoryPlan *plan, const StoragePtr &sp) {
+  switch (sp->stype) {
+  case StorageType::REAL_CPU_DENSE:
+    return persist_storage<CpuRealStorage>(plan, sp);
+  case StorageType::COMPLEX_CPU_DENSE:
+    return persist_storage<CpuComplexStorage>(plan, sp);
+  case StorageType::INT_CPU_DENSE:
+    return persist_storage<CpuIntStorage>(plan, sp);
+  default:
+    // Sparse and GPU storage never come from the plan.
+    return sp;
+  }
+}
+
+TensorPtr MemoryPlan::persist(const TensorPtr &t) {
+  MemoryPlan *plan = current();
+  if (!plan) {
+    return t;
+  }
+
+  set_current(nullptr);
+  const StoragePtr sp = persist_any(plan, t->storage);
+  set_current(plan);
+
+  if (sp == t->storage) {
+    return t;
+  }
+
+  TensorPtr out = std::make_shared<Tensor>(*t);
+  out->storage = sp;
+  out->grad_node = nullptr;
+  out->grad = nullptr;
+
+  return out;
+}
+
+SymbolTensorPtr MemoryPlan::persist(const SymbolTensorPtr &t) {
+  MemoryPlan *plan = current();
+  if (!plan) {
+    return t;
+  }
+
+  set_current(nullptr);
+  const StoragePtr sp = persist_any(plan, t->storage);
+  set_current(plan);
+
+  if (sp == t->storage) {
+    return t;
+  }
+
+  SymbolTensorPtr out = std::make_shared<SymbolTensor>(*t);
+  out->storage = sp;
+
+  return out;
+}
+
+MemoryPlanGuard::MemoryPlanGuard(MemoryPlan &p) : plan(p), prior(bound_plan) {
+  if (plan.bound) {
+    throw std::invalid_argument(
+        "MemoryPlanGuard cannot bind a MemoryPlan that is already bound!");
+  }
+  plan.bound = true;
+  plan.cursor = 0U;
+  bound_plan = &plan;
+}
+
+MemoryPlanGuard::~MemoryPlanGuard() {
+  bound_plan = prior;
+  plan.bound = false;
+}
+} // namespace Weed
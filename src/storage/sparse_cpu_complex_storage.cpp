@@ -36,10 +36,6 @@ StoragePtr SparseCpuComplexStorage::gpu(const int64_t &did) {
 }
 void SparseCpuComplexStorage::save(std::ostream &os) const {
   Storage::save(os);
-  Serializer::write_tcapint(os, (tcapint)(data.size()));
-  for (auto it = data.begin(); it != data.end(); ++it) {
-    Serializer::write_tcapint(os, it->first);
-    Serializer::write_complex(os, it->second);
-  }
+  save_entries(os);
 }
 } // namespace Weed
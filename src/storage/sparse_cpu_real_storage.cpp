@@ -49,10 +49,6 @@ StoragePtr SparseCpuRealStorage::Upcast(const DType &dt) {
 }
 void SparseCpuRealStorage::save(std::ostream &os) const {
   Storage::save(os);
-  Serializer::write_tcapint(os, (tcapint)(data.size()));
-  for (auto it = data.begin(); it != data.end(); ++it) {
-    Serializer::write_tcapint(os, it->first);
-    Serializer::write_real(os, it->second);
-  }
+  save_entries(os);
 }
 } // namespace Weed
@@ -11,8 +11,10 @@
 
 #include "common/serializer.hpp"
 #include "storage/cpu_complex_storage.hpp"
+#include "storage/cpu_half_storage.hpp"
 #include "storage/cpu_int_storage.hpp"
 #include "storage/cpu_real_storage.hpp"
+#include "storage/mapped_cpu_real_storage.hpp"
 #include "storage/sparse_cpu_complex_storage.hpp"
 #include "storage/sparse_cpu_real_storage.hpp"
 #if ENABLE_GPU
@@ -22,8 +24,114 @@
 #endif
 
 namespace Weed {
+static thread_local bool aligned_blobs = false;
+static thread_local bool blob_headers = false;
+
+void Storage::set_aligned_blobs(const bool &b) { aligned_blobs = b; }
+bool Storage::get_aligned_blobs() { return aligned_blobs; }
+void Storage::set_blob_headers(const bool &b) { blob_headers = b; }
+bool Storage::get_blob_headers() { return blob_headers; }
+
+void Storage::write_blob_header(std::ostream &out, const size_t &elem_size,
+                                const void *p, const size_t &bytes) {
+  Serializer::write_uint8(out, (uint8_t)elem_size);
+  Serializer::write_uint8(out, Serializer::get_endianness());
+  const uint64_t c = Serializer::checksum(p, bytes);
+  Serializer::write_block(out, &c, 1U);
+}
+
+BlobHeader Storage::read_blob_header(std::istream &in,
+                                     const size_t &elem_size) {
+  BlobHeader h;
+  Serializer::read_uint8(in, h.elem_size);
+  Serializer::read_uint8(in, h.endianness);
+  Serializer::read_block(in, &(h.checksum), 1U);
+  if (h.elem_size != (uint8_t)elem_size) {
+    throw std::domain_error(
+        "Storage::load() element size does not match this build!");
+  }
+  if (h.endianness != Serializer::get_endianness()) {
+    throw std::domain_error(
+        "Storage::load() byte order does not match this host!");
+  }
+
+  return h;
+}
+
+void Storage::check_blob(const BlobHeader &h, const void *p,
+                         const size_t &bytes) {
+  if (h.checksum != Serializer::checksum(p, bytes)) {
+    throw std::domain_error("Storage::load() payload checksum mismatch!");
+  }
+}
+
+void Storage::write_payload(std::ostream &out, const void *p,
+                            const size_t &elem_size, const size_t &n) {
+  const size_t bytes = elem_size * n;
+  if (blob_headers) {
+    write_blob_header(out, elem_size, p, bytes);
+  }
+  out.write(reinterpret_cast<const char *>(p), bytes);
+}
+
+void Storage::read_payload(std::istream &in, void *p, const size_t &elem_size,
+                           const size_t &n, const bool &has_header) {
+  const size_t bytes = elem_size * n;
+  BlobHeader h;
+  if (has_header) {
+    h = read_blob_header(in, elem_size);
+  }
+  in.read(reinterpret_cast<char *>(p), bytes);
+  if (!in) {
+    throw std::domain_error("Storage::load() payload is truncated!");
+  }
+  if (has_header) {
+    check_blob(h, p, bytes);
+  }
+}
+
+static StoragePtr load_aligned_real(std::istream &is, const tcapint &size,
+                                    const bool &has_header) {
+  BlobHeader h;
+  if (has_header) {
+    h = Storage::read_blob_header(is, sizeof(real1));
+  }
+
+  uint8_t pad;
+  Serializer::read_uint8(is, pad);
+  is.ignore(pad);
+
+  const size_t bytes = sizeof(real1) * (size_t)size;
+  const MappedFilePtr mf = MappedFile::current();
+  const std::streamoff pos = is.tellg();
+  if (mf && (pos >= 0) && (((size_t)pos + bytes) <= mf->length)) {
+    unsigned char *p = mf->base + (size_t)pos;
+    if (!((uintptr_t)p % alignof(real1))) {
+      // Zero-copy: alias the mapped blob and skip past it.
+      is.seekg(bytes, std::ios_base::cur);
+      if (has_header) {
+        Storage::check_blob(h, p, bytes);
+      }
+      return std::make_shared<MappedCpuRealStorage>(mf, (real1 *)p, size);
+    }
+  }
+
+  CpuRealStoragePtr n = std::make_shared<CpuRealStorage>(size);
+  Serializer::read_block(is, n->data.get(), size);
+  if (!is) {
+    throw std::domain_error("Storage::load() payload is truncated!");
+  }
+  if (has_header) {
+    Storage::check_blob(h, n->data.get(), bytes);
+  }
+
+  return n;
+}
+
 void Storage::save(std::ostream &os) const {
-  write_storage_type(os, stype);
+  write_storage_type(os, blob_headers
+                             ? (StorageType)(stype | STORAGE_HEADER_FLAG)
+                             : stype);
   Serializer::write_int64(os, get_device_id());
   Serializer::write_tcapint(os, size);
   // Needs the inheriting struct to do the rest
@@ -33,80 +141,68 @@ StoragePtr Storage::load(std::istream &is) {
   StorageType stype;
   read_storage_type(is, stype);
 
-  symint did;
+  int64_t did;
   Serializer::read_int64(is, did);
 
   tcapint size;
   Serializer::read_tcapint(is, size);
 
+  const bool has_header = stype & STORAGE_HEADER_FLAG;
+  stype = (StorageType)(stype & ~STORAGE_HEADER_FLAG);
+
   switch (stype) {
   case StorageType::REAL_CPU_DENSE: {
-    std::vector<real1> v(size);
-    for (tcapint i = 0U; i < size; ++i) {
-      Serializer::read_real(is, v[i]);
-    }
-    return std::make_shared<CpuRealStorage>(v);
+    CpuRealStoragePtr n = std::make_shared<CpuRealStorage>(size);
+    read_payload(is, n->data.get(), sizeof(real1), size, has_header);
+    return n;
   }
+  case StorageType::REAL_CPU_ALIGNED:
+    return load_aligned_real(is, size, has_header);
   case StorageType::COMPLEX_CPU_DENSE: {
-    std::vector<complex> v(size);
-    for (tcapint i = 0U; i < size; ++i) {
-      Serializer::read_complex(is, v[i]);
-    }
-    return std::make_shared<CpuComplexStorage>(v);
+    CpuComplexStoragePtr n = std::make_shared<CpuComplexStorage>(size);
+    read_payload(is, n->data.get(), sizeof(complex), size, has_header);
+    return n;
   }
   case StorageType::INT_CPU_DENSE: {
-    std::vector<symint> v(size);
-    for (tcapint i = 0U; i < size; ++i) {
-      Serializer::read_symint(is, v[i]);
-    }
-    return std::make_shared<CpuIntStorage>(v);
+    CpuIntStoragePtr n = std::make_shared<CpuIntStorage>(size);
+    read_payload(is, n->data.get(), sizeof(symint), size, has_header);
+    return n;
+  }
+  case StorageType::REAL_CPU_FP16: {
+    CpuFp16StoragePtr n = std::make_shared<CpuFp16Storage>(size);
+    read_payload(is, n->data.get(), sizeof(uint16_t), size, has_header);
+    return n;
+  }
+  case StorageType::REAL_CPU_BF16: {
+    CpuBf16StoragePtr n = std::make_shared<CpuBf16Storage>(size);
+    read_payload(is, n->data.get(), sizeof(uint16_t), size, has_header);
+    return n;
   }
   case StorageType::REAL_CPU_SPARSE: {
-    tcapint ksize;
-    Serializer::read_tcapint(is, ksize);
-    RealSparseVector s;
-    tcapint k;
-    real1 v;
-    for (tcapint i = 0U; i < ksize; ++i) {
-      Serializer::read_tcapint(is, k);
-      Serializer::read_real(is, v);
-      s[k] = v;
-    }
-    return std::make_shared<SparseCpuRealStorage>(s, size);
+    SparseCpuRealStoragePtr n = std::make_shared<SparseCpuRealStorage>(size);
+    n->load_entries(is, has_header);
+    return n;
   }
   case StorageType::COMPLEX_CPU_SPARSE: {
-    tcapint ksize;
-    Serializer::read_tcapint(is, ksize);
-    ComplexSparseVector s;
-    tcapint k;
-    complex v;
-    for (tcapint i = 0U; i < ksize; ++i) {
-      Serializer::read_tcapint(is, k);
-      Serializer::read_complex(is, v);
-      s[k] = v;
-    }
-    return std::make_shared<SparseCpuComplexStorage>(s, size);
+    SparseCpuComplexStoragePtr n =
+        std::make_shared<SparseCpuComplexStorage>(size);
+    n->load_entries(is, has_header);
+    return n;
   }
 #if ENABLE_GPU
   case StorageType::REAL_GPU_DENSE: {
     std::vector<real1> v(size);
-    for (tcapint i = 0U; i < size; ++i) {
-      Serializer::read_real(is, v[i]);
-    }
+    read_payload(is, v.data(), sizeof(real1), size, has_header);
     return std::make_shared<GpuRealStorage>(v, did);
   }
   case StorageType::COMPLEX_GPU_DENSE: {
     std::vector<complex> v(size);
-    for (tcapint i = 0U; i < size; ++i) {
-      Serializer::read_complex(is, v[i]);
-    }
+    read_payload(is, v.data(), sizeof(complex), size, has_header);
     return std::make_shared<GpuComplexStorage>(v, did);
   }
   case StorageType::INT_GPU_DENSE: {
     std::vector<symint> v(size);
-    for (tcapint i = 0U; i < size; ++i) {
-      Serializer::read_symint(is, v[i]);
-    }
+    read_payload(is, v.data(), sizeof(symint), size, has_header);
     return std::make_shared<GpuIntStorage>(v, did);
   }
 #endif
@@ -0,0 +1,72 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#include "tensors/graph_capture.hpp"
+#include "storage/all_storage.hpp"
+
+#include <cstring>
+
+namespace Weed {
+template <typename T>
+static void copy_dense(const BaseTensor &src, BaseTensor &dst,
+                       const tcapint &n) {
+  const T *s = static_cast<CpuStorage<T> *>(src.storage.get())->data.get();
+  T *d = static_cast<CpuStorage<T> *>(dst.storage.get())->data.get();
+  std::memcpy(d + dst.offset, s + src.offset, sizeof(T) * n);
+}
+
+void CapturedGraph::set_input(const BaseTensorPtr &x) {
+  if (x->shape != input->shape) {
+    throw std::invalid_argument(
+        "CapturedGraph input shape doesn't match the captured shape!");
+  }
+  if (!BaseTensor::is_contiguous(x->shape, x->stride)) {
+    throw std::invalid_argument("CapturedGraph input must be contiguous!");
+  }
+
+  const StoragePtr s = x->storage->cpu();
+  if (s->stype != input->storage->stype) {
+    throw std::invalid_argument(
+        "CapturedGraph input must be dense, with the captured dtype!");
+  }
+
+  BaseTensor src(*(x.get()));
+  src.storage = s;
+  tcapint n = 1U;
+  for (const tcapint &d : x->shape) {
+    n *= d;
+  }
+
+  switch (s->stype) {
+  case StorageType::REAL_CPU_DENSE:
+    copy_dense<real1>(src, *(input.get()), n);
+    break;
+  case StorageType::COMPLEX_CPU_DENSE:
+    copy_dense<complex>(src, *(input.get()), n);
+    break;
+  case StorageType::INT_CPU_DENSE:
+    copy_dense<symint>(src, *(input.get()), n);
+    break;
+  default:
+    throw std::invalid_argument(
+        "CapturedGraph input must be dense, with the captured dtype!");
+  }
+}
+
+TensorPtr CapturedGraph::replay(const BaseTensorPtr &x) {
+  set_input(x);
+  for (const std::function<void()> &f : launches) {
+    f();
+  }
+
+  return output;
+}
+} // namespace Weed
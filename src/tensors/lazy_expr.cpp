@@ -0,0 +1,316 @@
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Daniel Strano and the Qrack contributors 2026. All rights reserved.
+//
+// Weed is for minimalist AI/ML inference and backprogation in the style of
+// Qrack.
+//
+// Licensed under the GNU Lesser General Public License V3.
+// See LICENSE.md in the project root or
+// https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
+
+#include "tensors/lazy_expr.hpp"
+#include "autograd/grad_mode.hpp"
+#include "common/parallel_for.hpp"
+#include "storage/typed_storage.hpp"
+#include "tensors/graph_capture.hpp"
+
+#include <cmath>
+
+// Per-element register stack and leaf count limits of the fused kernel
+// (larger expressions are evaluated op-by-op, instead)
+#define LAZY_MAX_STACK 32U
+#define LAZY_MAX_LEAVES 16U
+
+namespace Weed {
+static real1 lazy_unary(const LazyOp &op, const real1 &a, const real1 &v) {
+  switch (op) {
+  case LAZY_POW:
+    return (real1)std::pow(a, v);
+  case LAZY_TANH:
+    return (real1)std::tanh(a);
+  case LAZY_EXP:
+    return (real1)std::exp(a);
+  case LAZY_SIGMOID:
+    return ONE_R1 / (ONE_R1 + (real1)std::exp(-a));
+  case LAZY_RELU:
+  default:
+    return std::max(a, (real1)ZERO_R1);
+  }
+}
+
+static real1 lazy_binary(const LazyOp &op, const real1 &l, const real1 &r) {
+  switch (op) {
+  case LAZY_ADD:
+    return l + r;
+  case LAZY_SUB:
+    return l - r;
+  case LAZY_MUL:
+    return l * r;
+  case LAZY_DIV:
+  default:
+    return l / r;
+  }
+}
+
+LazyExprPtr LazyExpr::binary(const LazyOp &o, const LazyExprPtr l,
+                             const LazyExprPtr r) {
+  if ((l->op == LAZY_CONST) && (r->op == LAZY_CONST)) {
+    return constant(lazy_binary(o, l->value, r->value));
+  }
+
+  return std::make_shared<LazyExpr>(o, std::vector<LazyExprPtr>{l, r});
+}
+
+LazyExprPtr LazyExpr::unary(const LazyOp &o, const LazyExprPtr a,
+                            const real1 &v) {
+  if (a->op == LAZY_CONST) {
+    return constant(lazy_unary(o, a->value, v));
+  }
+
+  return std::make_shared<LazyExpr>(o, std::vector<LazyExprPtr>{a}, v);
+}
+
+TensorPtr LazyExpr::eager() const {
+  switch (op) {
+  case LAZY_LEAF:
+    return tensor;
+  case LAZY_CONST:
+    return std::make_shared<Tensor>(std::vector<real1>{value},
+                                    std::vector<tcapint>{1U});
+  case LAZY_POW:
+    return Tensor::pow(args[0U]->eager(), value);
+  case LAZY_TANH:
+    return Tensor::tanh(args[0U]->eager());
+  case LAZY_EXP:
+    return Tensor::exp(args[0U]->eager());
+  case LAZY_SIGMOID:
+    return Tensor::sigmoid(args[0U]->eager());
+  case LAZY_RELU:
+    return Tensor::relu(args[0U]->eager());
+  default:
+    break;
+  }
+
+  // Binary: at most one side is constant, after folding
+  const LazyExprPtr &l = args[0U];
+  const LazyExprPtr &r = args[1U];
+  if (l->op == LAZY_CONST) {
+    const TensorPtr b = r->eager();
+    switch (op) {
+    case LAZY_ADD:
+      return l->value + b;
+    case LAZY_SUB:
+      return l->value - b;
+    case LAZY_MUL:
+      return l->value * b;
+    case LAZY_DIV:
+    default:
+      return l->value / b;
+    }
+  }
+  const TensorPtr a = l->eager();
+  if (r->op == LAZY_CONST) {
+    switch (op) {
+    case LAZY_ADD:
+      return a + r->value;
+    case LAZY_SUB:
+      return a - r->value;
+    case LAZY_MUL:
+      return a * r->value;
+    case LAZY_DIV:
+    default:
+      return a / r->value;
+    }
+  }
+  const TensorPtr b = r->eager();
+  switch (op) {
+  case LAZY_ADD:
+    return a + b;
+  case LAZY_SUB:
+    return a - b;
+  case LAZY_MUL:
+    return a * b;
+  case LAZY_DIV:
+  default:
+    return a / b;
+  }
+}
+
+/**
+ * One postfix instruction of a compiled LazyExpr
+ */
+struct LazyInstr {
+  LazyOp op;
+  real1 value;
+  size_t leaf;
+};
+
+/**
+ * A LazyExpr compiled to a postfix program over deduplicated leaves, with
+ * leaf strides aligned (from the right) to the broadcast output shape
+ */
+struct FusedKernel {
+  std::vector<LazyInstr> program;
+  std::vector<TensorPtr> leaves;
+  std::vector<tcapint> shape;
+  // strides[l * shape.size() + d] is leaf l's stride along output dim d
+  std::vector<tcapint> strides;
+  TensorPtr out;
+
+  size_t leaf_index(const TensorPtr &t) {
+    for (size_t l = 0U; l < leaves.size(); ++l) {
+      if (leaves[l] == t) {
+        return l;
+      }
+    }
+    leaves.push_back(t);
+
+    return leaves.size() - 1U;
+  }
+
+  /**
+   * Emit e in postfix order, and return its stack depth
+   */
+  size_t emit(const LazyExpr &e) {
+    size_t depth = 1U;
+    switch (e.op) {
+    case LAZY_LEAF:
+      program.push_back(LazyInstr{e.op, ZERO_R1, leaf_index(e.tensor)});
+      break;
+    case LAZY_CONST:
+      program.push_back(LazyInstr{e.op, e.value, 0U});
+      break;
+    case LAZY_ADD:
+    case LAZY_SUB:
+    case LAZY_MUL:
+    case LAZY_DIV:
+      depth = emit(*(e.args[0U].get()));
+      depth = std::max(depth, emit(*(e.args[1U].get())) + 1U);
+      program.push_back(LazyInstr{e.op, ZERO_R1, 0U});
+      break;
+    default:
+      depth = emit(*(e.args[0U].get()));
+      program.push_back(LazyInstr{e.op, e.value, 0U});
+    }
+
+    return depth;
+  }
+
+  void broadcast() {
+    size_t rank = 0U;
+    for (const TensorPtr &t : leaves) {
+      rank = std::max(rank, t->shape.size());
+    }
+    shape = std::vector<tcapint>(rank, 1U);
+    for (const TensorPtr &t : leaves) {
+      const size_t o = rank - t->shape.size();
+      for (size_t d = 0U; d < t->shape.size(); ++d) {
+        const tcapint &s = t->shape[d];
+        if (s == 1U) {
+          continue;
+        }
+        if ((shape[o + d] != 1U) && (shape[o + d] != s)) {
+          throw std::invalid_argument(
+              "LazyExpr::materialize() operand shapes do not broadcast!");
+        }
+        shape[o + d] = s;
+      }
+    }
+    strides = std::vector<tcapint>(leaves.size() * rank, 0U);
+    for (size_t l = 0U; l < leaves.size(); ++l) {
+      const TensorPtr &t = leaves[l];
+      const size_t o = rank - t->shape.size();
+      for (size_t d = 0U; d < t->shape.size(); ++d) {
+        if (t->shape[d] != 1U) {
+          strides[l * rank + o + d] = t->stride[d];
+        }
+      }
+    }
+  }
+
+  void run() const {
+    const size_t rank = shape.size();
+    const size_t n_leaves = leaves.size();
+    const tcapint n0 = rank ? shape[0U] : 1U;
+    const tcapint rows = out->storage->size / n0;
+    TypedStorage<real1> *po =
+        static_cast<TypedStorage<real1> *>(out->storage.get());
+    std::vector<const TypedStorage<real1> *> pl(n_leaves);
+    for (size_t l = 0U; l < n_leaves; ++l) {
+      pl[l] = static_cast<const TypedStorage<real1> *>(
+          leaves[l]->storage.get());
+    }
+
+    pfControl.par_for(0, rows, [&](const tcapint &r, const unsigned &cpu) {
+      tcapint base[LAZY_MAX_LEAVES];
+      for (size_t l = 0U; l < n_leaves; ++l) {
+        base[l] = leaves[l]->offset;
+      }
+      tcapint tmp = r;
+      for (size_t d = 1U; d < rank; ++d) {
+        const tcapint i_d = tmp % shape[d];
+        tmp /= shape[d];
+        for (size_t l = 0U; l < n_leaves; ++l) {
+          base[l] += i_d * strides[l * rank + d];
+        }
+      }
+      real1 stack[LAZY_MAX_STACK];
+      for (tcapint j = 0U; j < n0; ++j) {
+        size_t sp = 0U;
+        for (const LazyInstr &in : program) {
+          switch (in.op) {
+          case LAZY_LEAF:
+            stack[sp++] = (*pl[in.leaf])[base[in.leaf] +
+                                         j * strides[in.leaf * rank]];
+            break;
+          case LAZY_CONST:
+            stack[sp++] = in.value;
+            break;
+          case LAZY_ADD:
+          case LAZY_SUB:
+          case LAZY_MUL:
+          case LAZY_DIV:
+            --sp;
+            stack[sp - 1U] =
+                lazy_binary(in.op, stack[sp - 1U], stack[sp]);
+            break;
+          default:
+            stack[sp - 1U] = lazy_unary(in.op, stack[sp - 1U], in.value);
+          }
+        }
+        po->write(r * n0 + j, stack[0U]);
+      }
+    });
+  }
+};
+
+TensorPtr LazyExpr::materialize() const {
+  if (op == LAZY_LEAF) {
+    return tensor;
+  }
+
+  FusedKernel kernel;
+  const size_t depth = kernel.emit(*this);
+  if ((depth > LAZY_MAX_STACK) || (kernel.leaves.size() > LAZY_MAX_LEAVES) ||
+      kernel.leaves.empty()) {
+    return eager();
+  }
+  for (const TensorPtr &t : kernel.leaves) {
+    if ((t->storage->dtype != DType::REAL) ||
+        (t->storage->device != DeviceTag::CPU) ||
+        (GradMode::is_enabled() && t->requires_grad)) {
+      return eager();
+    }
+  }
+
+  kernel.broadcast();
+  kernel.out = std::make_shared<Tensor>(
+      kernel.shape, Tensor::full_contiguous_stride(kernel.shape), false,
+      false, DType::REAL, DeviceTag::CPU);
+
+  WEED_LAUNCH(kernel.run());
+
+  return kernel.out;
+}
+} // namespace Weed
@@ -9,28 +9,37 @@
 // See LICENSE.md in the project root or
 // https://www.gnu.org/licenses/lgpl-3.0.en.html for details.
 
+#include "autograd/grad_hook.hpp"
 #include "autograd/node.hpp"
+#include "tensors/graph_capture.hpp"
+#include "tensors/lazy_expr.hpp"
 #include "ops/abs.hpp"
+#include "ops/accumulate.hpp"
 #include "ops/clamp.hpp"
 #include "ops/commuting.hpp"
 #include "ops/copy_broadcast.hpp"
+#include "ops/cross_entropy.hpp"
 #include "ops/div.hpp"
+#include "ops/dropout.hpp"
 #include "ops/in_place.hpp"
 #include "ops/logsoftmax.hpp"
 #include "ops/matmul.hpp"
+#include "ops/norm.hpp"
 #include "ops/pow.hpp"
 #include "ops/real_extremum.hpp"
 #include "ops/real_unary.hpp"
+#include "ops/rnn.hpp"
 #include "ops/reduce.hpp"
+#include "ops/rope.hpp"
 #include "ops/softmax.hpp"
 #include "ops/sub.hpp"
 #include "ops/sum.hpp"
+#include "ops/swiglu.hpp"
 #include "tensors/real_scalar.hpp"
 
 #include "storage/all_storage.hpp"
 
 #include <thread>
-#include <unordered_set>
 
 #define GET_REAL(ptr) static_cast<RealScalar *>((ptr).get())->get_item()
 #define IS_SPARSE(a)                                                           \
@@ -94,23 +103,97 @@ void Tensor::make_gradient(const bool &force_sparse) {
     if (is_same_shape) {
       return;
     }
+
+    // A gradient already summed over this tensor's broadcast indices (as a
+    // bias parameter's, between backward passes) is kept as it is, for
+    // materialize_gradient() to re-expand only if a consumer needs that.
+    if (is_grad_reduced()) {
+      return;
+    }
+  }
+
+  if (!force_sparse && !storage->is_sparse()) {
+    // Dense gradients are deferred: an empty sparse placeholder stands in
+    // (and is shared by views) until materialize_gradient().
+    grad = Tensor::make_gradient(shape, true, storage->dtype, DeviceTag::CPU,
+                                 -1);
+    return;
   }
 
+  grad = Tensor::make_gradient(shape, true, storage->dtype, gradient_dtag(),
+                               storage->get_device_id());
+}
+
+DeviceTag Tensor::gradient_dtag() const {
   const tcapint sz = storage->size;
   const tcapint sp = storage->get_sparse_size();
-  DeviceTag dtag = DeviceTag::CPU;
   if (sz == sp) {
-    if (sz > GSTRIDE) {
-      dtag = DeviceTag::GPU;
+    return (sz > GSTRIDE) ? DeviceTag::GPU : DeviceTag::CPU;
+  }
+
+  return ((sp << 1U) > GSTRIDE) ? DeviceTag::GPU : DeviceTag::CPU;
+}
+
+bool Tensor::is_grad_reduced() const {
+  if (!grad || (grad->shape.size() != shape.size()) || (grad->shape == shape)) {
+    return false;
+  }
+
+  for (size_t i = 0U; i < shape.size(); ++i) {
+    if ((grad->shape[i] != shape[i]) && ((grad->shape[i] != 1U) || stride[i])) {
+      return false;
     }
-  } else {
-    if ((sp << 1U) > GSTRIDE) {
-      dtag = DeviceTag::GPU;
+  }
+
+  return true;
+}
+
+void Tensor::materialize_gradient(const bool &reduced) {
+  if (!requires_grad) {
+    return;
+  }
+
+  make_gradient();
+
+  if (is_grad_reduced()) {
+    if (reduced && (grad->storage->device == DeviceTag::CPU)) {
+      return;
+    }
+
+    // Re-expand into the first broadcast slice, so the next accumulation and
+    // reduction add to it.
+    TensorPtr g =
+        Tensor::zeros(shape, false, false, grad->storage->dtype,
+                      grad->storage->device, grad->storage->get_device_id());
+    Tensor slice(*(g.get()));
+    slice.shape = grad->shape;
+    Weed::add_in_place(slice, *(grad.get()));
+    grad = g;
+
+    return;
+  }
+
+  if (storage->is_sparse() || !grad->storage->is_sparse() ||
+      grad->storage->get_sparse_size()) {
+    return;
+  }
+
+  const DeviceTag dtag = gradient_dtag();
+  std::vector<tcapint> shp = grad->shape;
+  if (reduced && (dtag == DeviceTag::CPU)) {
+    for (size_t i = 0U; i < shp.size(); ++i) {
+      if (!stride[i]) {
+        shp[i] = 1U;
+      }
     }
   }
 
-  grad = Tensor::make_gradient(shape, force_sparse || storage->is_sparse(),
-                               storage->dtype, dtag, storage->get_device_id());
+  const TensorPtr g = Tensor::make_gradient(shp, false, grad->storage->dtype,
+                                            dtag, storage->get_device_id());
+  grad->storage = g->storage;
+  grad->shape = g->shape;
+  grad->stride = g->stride;
+  grad->offset = 0U;
 }
 
 TensorPtr Tensor::one_hot(const SymbolTensorPtr targets,
@@ -128,6 +211,531 @@ TensorPtr Tensor::one_hot(const SymbolTensorPtr targets,
   return std::make_shared<Tensor>(sv, std::vector<tcapint>{T, vocab_size});
 }
 
+std::vector<TensorPtr> filterParents(const std::vector<TensorPtr> &parents);
+
+// A dense contiguous CPU real copy of t, unless t already is one
+static TensorPtr dense_cpu(const TensorPtr &t) {
+  if ((t->storage->stype == StorageType::REAL_CPU_DENSE) && t->is_packed()) {
+    return t;
+  }
+  TensorPtr d =
+      Tensor::zeros(t->shape, false, false, DType::REAL, DeviceTag::CPU);
+  TensorPtr c = t->cast(DeviceTag::CPU);
+  c->upcast(DType::REAL);
+  Weed::add_in_place(*(d.get()), *(c.get()));
+
+  return d;
+}
+
+// A dense contiguous CPU real tensor, for a kernel that writes all of it (so
+// its storage is left uninitialized)
+static TensorPtr dense_cpu_out(const std::vector<tcapint> &shp,
+                               const bool &rg) {
+  TensorPtr t =
+      std::make_shared<Tensor>(shp, Tensor::full_contiguous_stride(shp), rg,
+                               true, DType::REAL, DeviceTag::CPU, -1);
+  t->storage = std::make_shared<CpuRealStorage>(t->get_size());
+
+  return t;
+}
+
+// The gradient of x, for a fused kernel to accumulate into in place, if it
+// is dense CPU real and contiguous, else a zeroed temporary
+static TensorPtr fused_grad_target(const TensorPtr &x) {
+  const TensorPtr &g = x->grad;
+  if ((g->storage->stype == StorageType::REAL_CPU_DENSE) &&
+      (g->shape == x->shape) && g->is_packed()) {
+    return g;
+  }
+
+  return Tensor::zeros(x->shape, false, false, DType::REAL, DeviceTag::CPU);
+}
+
+// Add a temporary from fused_grad_target() into the gradient of x
+static void fused_grad_commit(const TensorPtr &x, const TensorPtr &dx) {
+  if (dx == x->grad) {
+    return;
+  }
+  TensorPtr xg = x->grad->cast(DeviceTag::CPU);
+  xg->upcast(DType::REAL);
+  xg->materialize_broadcast();
+  Weed::add_in_place(*(xg.get()), *(dx.get()));
+  x->grad = xg;
+}
+
+// The gradient of x, matched to the shape of ref for a fused accumulation,
+// with extent 1 wherever it's reduced over (or broadcast from) x's broadcast
+// indices, so the accumulation sums straight into the existing buffer
+static TensorPtr reduced_grad_target(const TensorPtr &x, const DeviceTag &dtag,
+                                     const DType &dt, const TensorPtr &ref) {
+  TensorPtr g = x->grad->cast(dtag);
+  g->upcast(dt);
+  g->match_shape(ref);
+  for (size_t i = 0U; i < g->shape.size(); ++i) {
+    if (!g->stride[i]) {
+      g->shape[i] = 1U;
+    }
+  }
+
+  return g;
+}
+
+// Add a per-feature gradient, summed over rows, along the last axis of the
+// gradient of p (after summing any broadcast p has taken on)
+static void add_feature_grad(const TensorPtr &p, const std::vector<real1> &g) {
+  p->reduce_grad_broadcast();
+  TensorPtr t = std::make_shared<Tensor>(g, p->grad->shape, false,
+                                         p->grad->storage->device);
+  Weed::add_in_place(*(p->grad.get()), *(t.get()));
+}
+
+// Parents (of those given, non-null and requiring gradient) of a fused node
+static std::vector<TensorPtr>
+fused_parents(const std::vector<TensorPtr> &candidates) {
+  std::vector<TensorPtr> parents;
+  for (const TensorPtr &p : candidates) {
+    if (p && p->requires_grad) {
+      parents.push_back(p);
+    }
+  }
+
+  return parents;
+}
+
+TensorPtr Tensor::cross_entropy(const TensorPtr logits,
+                                const SymbolTensorPtr targets) {
+  const bool rg = GradMode::is_enabled() && logits->requires_grad;
+  std::shared_ptr<std::vector<real1>> lse =
+      std::make_shared<std::vector<real1>>();
+  TensorPtr out = dense_cpu_out({1U}, rg);
+  WEED_LAUNCH(static_cast<RealStorage *>(out->storage.get())
+                  ->write(0U, Weed::cross_entropy(*(logits.get()),
+                                                  *(targets.get()), *lse)));
+
+  if (!rg) {
+    return out;
+  }
+
+  out->make_gradient();
+  out->grad_node = std::make_shared<Node>(
+      std::vector<TensorPtr>{logits}, [logits, targets, lse, out]() {
+        const real1 dl = (*static_cast<RealStorage *>(
+            out->grad->storage.get()))[out->grad->offset];
+        const real1 scale = dl / (real1)lse->size();
+        TensorPtr dx = logits->grad;
+        if ((dx->storage->stype == StorageType::REAL_CPU_DENSE) &&
+            (dx->shape == logits->shape) && !dx->is_broadcast()) {
+          Weed::cross_entropy_grad(*(dx.get()), *(logits.get()),
+                                   *(targets.get()), *lse, scale);
+          return;
+        }
+        TensorPtr tmp = Tensor::zeros(logits->shape, false, false,
+                                      DType::REAL, DeviceTag::CPU);
+        Weed::cross_entropy_grad(*(tmp.get()), *(logits.get()),
+                                 *(targets.get()), *lse, scale);
+        dx = dx->cast(DeviceTag::CPU);
+        dx->upcast(DType::REAL);
+        dx->materialize_broadcast();
+        Weed::add_in_place(*(dx.get()), *(tmp.get()));
+        logits->grad = dx;
+      });
+
+  return out;
+}
+
+TensorPtr Tensor::linear_cross_entropy(const TensorPtr x, const TensorPtr w,
+                                       const TensorPtr b,
+                                       const SymbolTensorPtr targets,
+                                       const tcapint &chunk) {
+  const bool rg =
+      GradMode::is_enabled() &&
+      (x->requires_grad || w->requires_grad || (b && b->requires_grad));
+  const tcapint in = w->shape[0U];
+  const tcapint R = x->get_broadcast_size() / in;
+  TensorPtr x2 = Tensor::reshape(x, {(symint)R, (symint)in});
+  std::shared_ptr<std::vector<real1>> lse =
+      std::make_shared<std::vector<real1>>();
+  TensorPtr out = dense_cpu_out({1U}, rg);
+  WEED_LAUNCH(static_cast<RealStorage *>(out->storage.get())
+                  ->write(0U, Weed::linear_cross_entropy(
+                                  *(x2.get()), *(w.get()), b.get(),
+                                  *(targets.get()), chunk, *lse)));
+
+  if (!rg) {
+    return out;
+  }
+
+  out->make_gradient();
+  out->grad_node = std::make_shared<Node>(
+      fused_parents({x, w, b}), [x, x2, w, b, targets, chunk, lse, out]() {
+        const real1 dl = (*static_cast<RealStorage *>(
+            out->grad->storage.get()))[out->grad->offset];
+        const real1 scale = dl / (real1)lse->size();
+        const auto dense = [](const TensorPtr &t) {
+          return t->storage->stype == StorageType::REAL_CPU_DENSE &&
+                 !t->offset && t->is_packed();
+        };
+
+        // Accumulate in place into dense gradients, else via temporaries.
+        TensorPtr dx = nullptr;
+        if (x->requires_grad) {
+          dx = dense(x->grad)
+                   ? std::make_shared<Tensor>(*(x->grad.get()))
+                   : Tensor::zeros(x->shape, false, false, DType::REAL,
+                                   DeviceTag::CPU);
+          dx->reshape({(symint)x2->shape[0U], (symint)x2->shape[1U]});
+        }
+        TensorPtr dw = nullptr;
+        if (w->requires_grad) {
+          dw = dense(w->grad)
+                   ? w->grad
+                   : Tensor::zeros(w->shape, false, false, DType::REAL,
+                                   DeviceTag::CPU);
+        }
+        std::vector<real1> db;
+        const bool is_db = b && b->requires_grad;
+
+        Weed::linear_cross_entropy_grad(dx.get(), dw.get(),
+                                        is_db ? &db : nullptr, *(x2.get()),
+                                        *(w.get()), b.get(), *(targets.get()),
+                                        *lse, scale, chunk);
+
+        if (dx && (dx->storage != x->grad->storage)) {
+          TensorPtr xg = x->grad->cast(DeviceTag::CPU);
+          xg->upcast(DType::REAL);
+          xg->materialize_broadcast();
+          dx->reshape(std::vector<symint>(x->shape.begin(), x->shape.end()));
+          Weed::add_in_place(*(xg.get()), *(dx.get()));
+          x->grad = xg;
+        }
+        if (dw && (dw != w->grad)) {
+          TensorPtr wg = w->grad->cast(DeviceTag::CPU);
+          wg->upcast(DType::REAL);
+          wg->materialize_broadcast();
+          Weed::add_in_place(*(wg.get()), *(dw.get()));
+          w->grad = wg;
+        }
+        if (is_db) {
+          add_feature_grad(b, db);
+        }
+      });
+
+  return out;
+}
+
+TensorPtr Tensor::rms_norm(const TensorPtr x, const TensorPtr w,
+                           const real1 &eps) {
+  const bool rg =
+      GradMode::is_enabled() && (x->requires_grad || w->requires_grad);
+  TensorPtr out = dense_cpu_out(x->shape, rg);
+  std::shared_ptr<std::vector<real1>> rstd =
+      std::make_shared<std::vector<real1>>();
+  WEED_LAUNCH(
+      Weed::rms_norm(*(x.get()), *(w.get()), eps, *(out.get()), *rstd));
+
+  if (!rg) {
+    return out;
+  }
+
+  out->make_gradient();
+  out->grad_node = std::make_shared<Node>(
+      filterParents({x, w}), [x, w, rstd, out]() {
+        const TensorPtr dy = dense_cpu(out->grad);
+        const TensorPtr dx = x->requires_grad ? fused_grad_target(x) : nullptr;
+        std::vector<real1> dw;
+        Weed::rms_norm_grad(dx.get(), w->requires_grad ? &dw : nullptr,
+                            *(dy.get()), *(x.get()), *(w.get()), *rstd);
+        if (dx) {
+          fused_grad_commit(x, dx);
+        }
+        if (w->requires_grad) {
+          add_feature_grad(w, dw);
+        }
+      });
+
+  return out;
+}
+
+TensorPtr Tensor::layer_norm(const TensorPtr x, const TensorPtr gamma,
+                             const TensorPtr beta, const real1 &eps) {
+  const bool rg = GradMode::is_enabled() &&
+                  (x->requires_grad || gamma->requires_grad ||
+                   beta->requires_grad);
+  TensorPtr out = dense_cpu_out(x->shape, rg);
+  std::shared_ptr<std::vector<real1>> mean =
+      std::make_shared<std::vector<real1>>();
+  std::shared_ptr<std::vector<real1>> rstd =
+      std::make_shared<std::vector<real1>>();
+  WEED_LAUNCH(Weed::layer_norm(*(x.get()), *(gamma.get()), *(beta.get()), eps,
+                               *(out.get()), *mean, *rstd));
+
+  if (!rg) {
+    return out;
+  }
+
+  out->make_gradient();
+  out->grad_node = std::make_shared<Node>(
+      filterParents({x, gamma, beta}), [x, gamma, beta, mean, rstd, out]() {
+        const TensorPtr dy = dense_cpu(out->grad);
+        const TensorPtr dx = x->requires_grad ? fused_grad_target(x) : nullptr;
+        std::vector<real1> dg, db;
+        Weed::layer_norm_grad(
+            dx.get(), gamma->requires_grad ? &dg : nullptr,
+            beta->requires_grad ? &db : nullptr, *(dy.get()), *(x.get()),
+            *(gamma.get()), *mean, *rstd);
+        if (dx) {
+          fused_grad_commit(x, dx);
+        }
+        if (gamma->requires_grad) {
+          add_feature_grad(gamma, dg);
+        }
+        if (beta->requires_grad) {
+          add_feature_grad(beta, db);
+        }
+      });
+
+  return out;
+}
+
+TensorPtr Tensor::swiglu(const TensorPtr x, const TensorPtr wg,
+                         const TensorPtr wu) {
+  const bool rg = GradMode::is_enabled() &&
+                  (x->requires_grad || wg->requires_grad || wu->requires_grad);
+  const tcapint in = wg->shape[0U];
+  const tcapint I = wg->shape[1U];
+  const tcapint R = x->get_broadcast_size() / in;
+  TensorPtr x2 = Tensor::reshape(x, {(symint)R, (symint)in});
+  TensorPtr gu = dense_cpu_out({R, I << 1U}, false);
+  std::vector<tcapint> shp = x->shape;
+  shp.back() = I;
+  TensorPtr out = dense_cpu_out(shp, rg);
+  TensorPtr a = std::make_shared<Tensor>(*(out.get()));
+  a->reshape({(symint)R, (symint)I});
+  WEED_LAUNCH(
+      Weed::swiglu(*(x2.get()), *(wg.get()), *(wu.get()), *(gu.get()), *a));
+
+  if (!rg) {
+    return out;
+  }
+
+  out->make_gradient();
+  out->grad_node = std::make_shared<Node>(
+      filterParents({x, wg, wu}), [x, x2, wg, wu, gu, out, R, in, I]() {
+        Tensor da(*(dense_cpu(out->grad).get()));
+        da.reshape({(symint)R, (symint)I});
+        const TensorPtr dx = x->requires_grad ? fused_grad_target(x) : nullptr;
+        const TensorPtr dwg =
+            wg->requires_grad ? fused_grad_target(wg) : nullptr;
+        const TensorPtr dwu =
+            wu->requires_grad ? fused_grad_target(wu) : nullptr;
+        TensorPtr dx2 = nullptr;
+        if (dx) {
+          // [R, in] view of the gradient of x
+          dx2 = std::make_shared<Tensor>(*(dx.get()));
+          dx2->reshape({(symint)R, (symint)in});
+        }
+        Weed::swiglu_grad(dx2.get(), dwg.get(), dwu.get(), da,
+                          *(x2.get()), *(wg.get()), *(wu.get()), *(gu.get()));
+        if (dx) {
+          fused_grad_commit(x, dx);
+        }
+        if (dwg) {
+          fused_grad_commit(wg, dwg);
+        }
+        if (dwu) {
+          fused_grad_commit(wu, dwu);
+        }
+      });
+
+  return out;
+}
+
+TensorPtr Tensor::rope(const TensorPtr x, const TensorPtr cos_table,
+                       const TensorPtr sin_table, const tcapint &pos) {
+  const bool rg = GradMode::is_enabled() && x->requires_grad;
+  TensorPtr out = dense_cpu_out(x->shape, rg);
+  WEED_LAUNCH(Weed::rope(*(out.get()), *(x.get()), *(cos_table.get()),
+                         *(sin_table.get()), pos));
+
+  if (!rg) {
+    return out;
+  }
+
+  out->make_gradient();
+  out->grad_node = std::make_shared<Node>(
+      std::vector<TensorPtr>{x}, [x, cos_table, sin_table, pos, out]() {
+        const TensorPtr dy = dense_cpu(out->grad);
+        const TensorPtr dx = fused_grad_target(x);
+        Weed::rope_grad(*(dx.get()), *(dy.get()), *(cos_table.get()),
+                        *(sin_table.get()), pos);
+        fused_grad_commit(x, dx);
+      });
+
+  return out;
+}
+
+// Gradient targets for the input and weights of a fused recurrence, run the
+// backward, then commit the gradients (the bias gradient is shared)
+static void rnn_sequence_backward(
+    const TensorPtr &x, const TensorPtr &wx, const TensorPtr &bx,
+    const TensorPtr &wh, const TensorPtr &bh, const TensorPtr &out,
+    const std::function<void(Tensor *, Tensor *, Tensor *,
+                             std::vector<real1> *, const Tensor &)> &grad) {
+  const tcapint N = x->shape[0U] * x->shape[1U];
+  Tensor dy(*(dense_cpu(out->grad).get()));
+  dy.reshape({(symint)N, (symint)out->shape[2U]});
+  const TensorPtr dx = x->requires_grad ? fused_grad_target(x) : nullptr;
+  const TensorPtr dwx = wx->requires_grad ? fused_grad_target(wx) : nullptr;
+  const TensorPtr dwh = wh->requires_grad ? fused_grad_target(wh) : nullptr;
+  const bool is_db = (bx && bx->requires_grad) || (bh && bh->requires_grad);
+  TensorPtr dx2 = nullptr;
+  if (dx) {
+    // [B * T, in] view of the gradient of x
+    dx2 = std::make_shared<Tensor>(*(dx.get()));
+    dx2->reshape({(symint)N, (symint)x->shape[2U]});
+  }
+  std::vector<real1> db;
+
+  grad(dx2.get(), dwx.get(), dwh.get(), is_db ? &db : nullptr, dy);
+
+  for (const auto &g : {std::make_pair(x, dx), std::make_pair(wx, dwx),
+                        std::make_pair(wh, dwh)}) {
+    if (g.second) {
+      fused_grad_commit(g.first, g.second);
+    }
+  }
+  for (const TensorPtr &b : {bx, bh}) {
+    if (b && b->requires_grad) {
+      add_feature_grad(b, db);
+    }
+  }
+}
+
+TensorPtr Tensor::dropout(const TensorPtr x, const real1 &p,
+                          const uint64_t &seed, const uint64_t &stream) {
+  const bool rg = GradMode::is_enabled() && x->requires_grad;
+  TensorPtr out = dense_cpu_out(x->shape, rg);
+  WEED_LAUNCH(Weed::dropout(*(out.get()), *(x.get()), p, seed, stream));
+
+  if (!rg) {
+    return out;
+  }
+
+  out->make_gradient();
+  out->grad_node = std::make_shared<Node>(
+      std::vector<TensorPtr>{x}, [x, p, seed, stream, out]() {
+        const TensorPtr dy = dense_cpu(out->grad);
+        const TensorPtr dx = fused_grad_target(x);
+        Weed::dropout_grad(*(dx.get()), *(dy.get()), p, seed, stream);
+        fused_grad_commit(x, dx);
+      });
+
+  return out;
+}
+
+std::vector<TensorPtr> Tensor::lstm_sequence(const TensorPtr x,
+                                             const TensorPtr wx,
+                                             const TensorPtr bx,
+                                             const TensorPtr wh,
+                                             const TensorPtr bh,
+                                             const TensorPtr h0,
+                                             const TensorPtr c0) {
+  const std::vector<TensorPtr> parents = fused_parents({x, wx, bx, wh, bh});
+  const bool rg = GradMode::is_enabled() && !parents.empty();
+  const tcapint B = x->shape[0U];
+  const tcapint N = B * x->shape[1U];
+  const tcapint H = wh->shape[0U];
+  const TensorPtr x2 =
+      Tensor::reshape(x, {(symint)N, (symint)x->shape[2U]});
+  const TensorPtr hi = dense_cpu(h0);
+  const TensorPtr ci = dense_cpu(c0);
+  const TensorPtr z =
+      Tensor::zeros({N, H << 2U}, false, false, DType::REAL, DeviceTag::CPU);
+  const TensorPtr cs =
+      Tensor::zeros({N, H}, false, false, DType::REAL, DeviceTag::CPU);
+  TensorPtr out = Tensor::zeros({B, x->shape[1U], H}, rg, false, DType::REAL,
+                                DeviceTag::CPU);
+  TensorPtr hT =
+      Tensor::zeros({B, H}, false, false, DType::REAL, DeviceTag::CPU);
+  TensorPtr cT =
+      Tensor::zeros({B, H}, false, false, DType::REAL, DeviceTag::CPU);
+  const TensorPtr hs = std::make_shared<Tensor>(*(out.get()));
+  hs->reshape({(symint)N, (symint)H});
+  WEED_LAUNCH(Weed::lstm_sequence(*(x2.get()), *(wx.get()), bx.get(),
+                                  *(wh.get()), bh.get(), *(hi.get()),
+                                  *(ci.get()), *(z.get()), *(hs.get()),
+                                  *(cs.get()), *(hT.get()), *(cT.get())));
+
+  if (!rg) {
+    return {out, hT, cT};
+  }
+
+  out->make_gradient();
+  out->grad_node = std::make_shared<Node>(
+      parents, [x, x2, wx, bx, wh, bh, hi, ci, z, cs, out, hs]() {
+        rnn_sequence_backward(
+            x, wx, bx, wh, bh, out,
+            [&](Tensor *dx, Tensor *dwx, Tensor *dwh, std::vector<real1> *db,
+                const Tensor &dy) {
+              Weed::lstm_sequence_grad(dx, dwx, dwh, db, dy, *(x2.get()),
+                                       *(wx.get()), *(wh.get()), *(hi.get()),
+                                       *(ci.get()), *(z.get()),
+                                       *(hs.get()), *(cs.get()));
+            });
+      });
+
+  return {out, hT, cT};
+}
+
+std::vector<TensorPtr> Tensor::gru_sequence(const TensorPtr x,
+                                            const TensorPtr wx,
+                                            const TensorPtr bx,
+                                            const TensorPtr wh,
+                                            const TensorPtr bh,
+                                            const TensorPtr h0) {
+  const std::vector<TensorPtr> parents = fused_parents({x, wx, bx, wh, bh});
+  const bool rg = GradMode::is_enabled() && !parents.empty();
+  const tcapint B = x->shape[0U];
+  const tcapint N = B * x->shape[1U];
+  const tcapint H = wh->shape[0U];
+  const TensorPtr x2 =
+      Tensor::reshape(x, {(symint)N, (symint)x->shape[2U]});
+  const TensorPtr hi = dense_cpu(h0);
+  const TensorPtr z =
+      Tensor::zeros({N, 3U * H}, false, false, DType::REAL, DeviceTag::CPU);
+  const TensorPtr rh =
+      Tensor::zeros({N, H}, false, false, DType::REAL, DeviceTag::CPU);
+  TensorPtr out = Tensor::zeros({B, x->shape[1U], H}, rg, false, DType::REAL,
+                                DeviceTag::CPU);
+  TensorPtr hT =
+      Tensor::zeros({B, H}, false, false, DType::REAL, DeviceTag::CPU);
+  const TensorPtr hs = std::make_shared<Tensor>(*(out.get()));
+  hs->reshape({(symint)N, (symint)H});
+  WEED_LAUNCH(Weed::gru_sequence(*(x2.get()), *(wx.get()), bx.get(),
+                                 *(wh.get()), bh.get(), *(hi.get()),
+                                 *(z.get()), *(hs.get()), *(rh.get()),
+                                 *(hT.get())));
+
+  if (!rg) {
+    return {out, hT};
+  }
+
+  out->make_gradient();
+  out->grad_node = std::make_shared<Node>(
+      parents, [x, x2, wx, bx, wh, bh, hi, z, rh, out, hs]() {
+        rnn_sequence_backward(
+            x, wx, bx, wh, bh, out,
+            [&](Tensor *dx, Tensor *dwx, Tensor *dwh, std::vector<real1> *db,
+                const Tensor &dy) {
+              Weed::gru_sequence_grad(dx, dwx, dwh, db, dy, *(x2.get()),
+                                      *(wx.get()), *(wh.get()), *(hi.get()),
+                                      *(z.get()), *(hs.get()), *(rh.get()));
+            });
+      });
+
+  return {out, hT};
+}
+
 TensorPtr Tensor::allocate_scalar_like(const Tensor &orig, const bool &rg) {
   return allocate_like(std::vector<tcapint>{1U}, std::vector<tcapint>{0U}, orig,
                        orig.storage->dtype, rg, false);
@@ -332,14 +940,7 @@ bool Tensor::match_shape(const TensorPtr a) {
 }
 
 void Tensor::materialize_broadcast() {
-  bool needs = false;
-  for (size_t i = 0; i < shape.size(); ++i) {
-    if (shape[i] > 1U && stride[i] == 0) {
-      needs = true;
-      break;
-    }
-  }
-  if (!needs) {
+  if (!is_broadcast()) {
     return;
   }
 
@@ -347,7 +948,12 @@ void Tensor::materialize_broadcast() {
                                         requires_grad, storage->is_sparse());
 
   // copy via kernel (broadcast-aware read)
-  Weed::copy_broadcast(*tmp, *this);
+  if (GraphRecorder::is_active()) {
+    TensorPtr src = std::make_shared<Tensor>(*this);
+    WEED_LAUNCH(Weed::copy_broadcast(*tmp, *src));
+  } else {
+    Weed::copy_broadcast(*tmp, *this);
+  }
 
   *this = *tmp;
 }
@@ -359,13 +965,36 @@ void Tensor::reduce_grad_broadcast() {
         "gradient Tensor! (This should be called only during autograd.)");
   }
 
-  for (symint i = stride.size() - 1; i >= 0; --i) {
-    if (stride[i]) {
-      continue;
+  if ((grad->storage->device != DeviceTag::CPU) ||
+      grad->storage->is_sparse() || (grad->shape.size() != stride.size())) {
+    for (symint i = stride.size() - 1; i >= 0; --i) {
+      if (stride[i]) {
+        continue;
+      }
+
+      grad = sum(grad, i);
     }
 
-    grad = sum(grad, i);
+    return;
+  }
+
+  // Sum over every broadcast index at once, in one pass
+  std::vector<tcapint> shp = grad->shape;
+  bool needs = false;
+  for (size_t i = 0U; i < stride.size(); ++i) {
+    if (!stride[i] && (shp[i] != 1U)) {
+      shp[i] = 1U;
+      needs = true;
+    }
+  }
+  if (!needs) {
+    return;
   }
+
+  TensorPtr r =
+      Tensor::zeros(shp, false, false, grad->storage->dtype, DeviceTag::CPU);
+  Weed::reduce_broadcast_acc(*(r.get()), *(grad.get()));
+  grad = r;
 }
 
 void Tensor::backward(TensorPtr loss) {
@@ -374,29 +1003,85 @@ void Tensor::backward(TensorPtr loss) {
   }
 
   // Seed gradient
+  loss->materialize_gradient();
   loss->grad->storage->FillOnes();
 
-  std::vector<NodePtr> topo;
-  std::unordered_set<Node *> seen;
+  if (!loss->grad_node) {
+    return;
+  }
 
-  std::function<void(const NodePtr &)> dfs = [&](const NodePtr &n) {
-    if (!n || seen.count(n.get())) {
-      return;
+  // Count, for every reachable node, the consumers of its output that must
+  // run before it does (iteratively, so deep graphs can't overflow the stack).
+  std::unordered_map<Node *, tcapint> pending;
+  // Intermediate tensors whose gradient each node consumes
+  std::unordered_map<Node *, std::vector<TensorPtr>> outputs;
+  // With a gradient-ready hook, the consumers of every leaf left to run
+  const GradReadyHook::Fn hook = GradReadyHook::get();
+  std::unordered_map<Tensor *, tcapint> leaves;
+  std::vector<Node *> stack{loss->grad_node.get()};
+  pending[loss->grad_node.get()] = 0U;
+  while (!stack.empty()) {
+    Node *n = stack.back();
+    stack.pop_back();
+    for (const TensorPtr &p : n->parents) {
+      if (!p || !p->grad_node) {
+        if (hook && p && p->requires_grad) {
+          ++leaves[p.get()];
+        }
+        continue;
+      }
+      Node *m = p->grad_node.get();
+      outputs[m].push_back(p);
+      const auto it = pending.find(m);
+      if (it == pending.end()) {
+        pending[m] = 1U;
+        stack.push_back(m);
+      } else {
+        ++(it->second);
+      }
+    }
+  }
+
+  // Run each node once all of its consumers have, then release it.
+  std::vector<NodePtr> ready{loss->grad_node};
+  while (!ready.empty()) {
+    const NodePtr n = ready.back();
+    ready.pop_back();
+
+    if (!n->sparse_grad) {
+      for (const TensorPtr &p : n->parents) {
+        if (p) {
+          p->materialize_gradient(n->reduce_grad);
+        }
+      }
+    }
+
+    if (n->backward) {
+      n->backward();
     }
 
-    seen.insert(n.get());
-    for (auto &p : n->parents) {
-      if (p && p->grad_node) {
-        dfs(p->grad_node);
+    for (const TensorPtr &p : n->parents) {
+      if (p && p->grad_node && !(--pending[p->grad_node.get()])) {
+        ready.push_back(p->grad_node);
+      } else if (hook && p && !p->grad_node && p->requires_grad &&
+                 !(--leaves[p.get()])) {
+        hook(p.get());
       }
     }
-    topo.push_back(n);
-  };
 
-  dfs(loss->grad_node);
+    // Drop the closure and its captures now, returning activation memory.
+    n->backward = nullptr;
+    n->parents.clear();
 
-  for (auto it = topo.rbegin(); it != topo.rend(); ++it) {
-    (*it)->backward();
+    // Every consumer of this node's output has run, so its gradient is dead.
+    const auto o = outputs.find(n.get());
+    if (o != outputs.end()) {
+      for (const TensorPtr &t : o->second) {
+        t->grad = nullptr;
+        t->grad_node = nullptr;
+      }
+      outputs.erase(o);
+    }
   }
 }
 
@@ -404,9 +1089,9 @@ TensorPtr Tensor::softmax(const TensorPtr x, symint axis) {
   while (axis < 0) {
     axis += x->shape.size();
   }
-  const bool rg = x->requires_grad;
+  const bool rg = GradMode::is_enabled() && x->requires_grad;
   TensorPtr out = allocate_like(*x, x->storage->dtype, rg, IS_SPARSE(x));
-  Weed::softmax((tcapint)axis, *x, *out);
+  WEED_LAUNCH(Weed::softmax((tcapint)axis, *x, *out));
   if (rg) {
     make_softmax_node(x, out, axis);
   }
@@ -434,9 +1119,9 @@ TensorPtr Tensor::logsoftmax(const TensorPtr x, symint axis) {
   while (axis < 0) {
     axis += x->shape.size();
   }
-  const bool rg = x->requires_grad;
+  const bool rg = GradMode::is_enabled() && x->requires_grad;
   TensorPtr out = allocate_like(*x, x->storage->dtype, rg, IS_SPARSE(x));
-  Weed::logsoftmax((tcapint)axis, *x, *out);
+  WEED_LAUNCH(Weed::logsoftmax((tcapint)axis, *x, *out));
   if (rg) {
     make_logsoftmax_node(x, out, axis);
   }
@@ -461,7 +1146,7 @@ void Tensor::make_logsoftmax_node(TensorPtr x, TensorPtr out, symint axis) {
 }
 
 TensorPtr Tensor::slice(TensorPtr a, const int64_t &row) {
-  const bool rg = a->requires_grad;
+  const bool rg = GradMode::is_enabled() && a->requires_grad;
 
   TensorPtr out = std::make_shared<Tensor>(*(a.get()));
   out->offset += row * a->stride[0U];
@@ -512,7 +1197,7 @@ TensorPtr Tensor::slice(TensorPtr a, int64_t axis, const tcapint &start,
     throw std::invalid_argument("Tensor::slice: invalid range");
   }
 
-  const bool rg = a->requires_grad;
+  const bool rg = GradMode::is_enabled() && a->requires_grad;
   TensorPtr out = std::make_shared<Tensor>(*(a.get()));
 
   out->offset += start * a->stride[axis];
@@ -534,29 +1219,23 @@ void Tensor::make_slice_node(TensorPtr a, TensorPtr out, const int64_t &axis,
 
         TensorPtr a_grad = a->grad->cast(dtag);
         TensorPtr out_grad = out->grad->cast(dtag);
+        a_grad->upcast(out_grad->storage->dtype);
 
-        // Create zero tensor same shape as parent
-        TensorPtr tmp = allocate_like(*(a_grad.get()), a_grad->storage->dtype,
-                                      false, IS_SPARSE(out_grad));
-
-        // Create view into tmp matching slice region
-        TensorPtr tmp_slice =
-            slice(tmp, axis, start, out_grad->shape[axis])->cast(dtag);
-
-        // Copy gradient into correct region
-        Weed::add_in_place(*(tmp_slice.get()), *(out_grad.get()));
-
-        Weed::add_in_place(*(a_grad.get()), *(tmp.get()));
+        // Accumulate straight into the sliced region of the parent gradient
+        Tensor region(*(a_grad.get()));
+        region.offset += start * a_grad->stride[axis];
+        region.shape[axis] = out_grad->shape[axis];
+        Weed::add_in_place(region, *(out_grad.get()));
 
         a->grad = a_grad;
       });
 }
 
 TensorPtr Tensor::sum(TensorPtr a) {
-  const bool rg = a->requires_grad;
+  const bool rg = GradMode::is_enabled() && a->requires_grad;
   TensorPtr out = allocate_scalar_like(*(a.get()), rg);
 
-  Weed::sum(*(a.get()), *(out.get()));
+  WEED_LAUNCH(Weed::sum(*(a.get()), *(out.get())));
 
   if (rg) {
     make_sum_node(a, out);
@@ -581,10 +1260,10 @@ void Tensor::make_sum_node(TensorPtr a, TensorPtr out) {
 }
 
 TensorPtr Tensor::mean(TensorPtr a) {
-  const bool rg = a->requires_grad;
+  const bool rg = GradMode::is_enabled() && a->requires_grad;
   TensorPtr out = allocate_scalar_like(*(a.get()), rg);
 
-  Weed::mean(*(a.get()), *(out.get()));
+  WEED_LAUNCH(Weed::mean(*(a.get()), *(out.get())));
 
   if (rg) {
     make_mean_node(a, out);
@@ -625,7 +1304,7 @@ TensorPtr Tensor::sum(TensorPtr a, symint axis) {
 
   a = contiguous(a);
 
-  const bool rg = a->requires_grad;
+  const bool rg = GradMode::is_enabled() && a->requires_grad;
   std::vector<tcapint> shp = a->shape;
   std::vector<tcapint> str = a->stride;
   shp[axis] = 1U;
@@ -643,7 +1322,7 @@ TensorPtr Tensor::sum(TensorPtr a, symint axis) {
 
   TensorPtr out =
       allocate_like(shp, str, *(a.get()), a->storage->dtype, rg, IS_SPARSE(a));
-  Weed::reduce(axis, *(a.get()), *(out.get()));
+  WEED_LAUNCH(Weed::reduce(axis, *(a.get()), *(out.get())));
 
   if (rg) {
     make_sum_node(a, out, axis);
@@ -716,7 +1395,7 @@ TensorPtr Tensor::max(TensorPtr a, symint axis) {
 
   a = contiguous(a);
 
-  const bool rg = a->requires_grad;
+  const bool rg = GradMode::is_enabled() && a->requires_grad;
   std::vector<tcapint> shp = a->shape;
   std::vector<tcapint> str = a->stride;
   shp[axis] = 1U;
@@ -734,7 +1413,7 @@ TensorPtr Tensor::max(TensorPtr a, symint axis) {
 
   TensorPtr out =
       allocate_like(shp, str, *(a.get()), a->storage->dtype, rg, IS_SPARSE(a));
-  Weed::max(axis, *(a.get()), *(out.get()));
+  WEED_LAUNCH(Weed::max(axis, *(a.get()), *(out.get())));
 
   if (rg) {
     make_match_node(a, out, axis);
@@ -757,7 +1436,7 @@ TensorPtr Tensor::min(TensorPtr a, symint axis) {
 
   a = contiguous(a);
 
-  const bool rg = a->requires_grad;
+  const bool rg = GradMode::is_enabled() && a->requires_grad;
   std::vector<tcapint> shp = a->shape;
   std::vector<tcapint> str = a->stride;
   shp[axis] = 1U;
@@ -775,7 +1454,7 @@ TensorPtr Tensor::min(TensorPtr a, symint axis) {
 
   TensorPtr out =
       allocate_like(shp, str, *(a.get()), a->storage->dtype, rg, IS_SPARSE(a));
-  Weed::min(axis, *(a.get()), *(out.get()));
+  WEED_LAUNCH(Weed::min(axis, *(a.get()), *(out.get())));
 
   if (rg) {
     make_match_node(a, out, axis);
@@ -812,10 +1491,10 @@ void Tensor::make_match_node(TensorPtr a, TensorPtr out, const tcapint &axis) {
 }
 
 TensorPtr Tensor::abs(TensorPtr a) {
-  const bool rg = a->requires_grad;
+  const bool rg = GradMode::is_enabled() && a->requires_grad;
   TensorPtr out = allocate_like(*(a.get()), DType::REAL, rg, IS_SPARSE(a));
 
-  Weed::abs(*(a.get()), *(out.get()));
+  WEED_LAUNCH(Weed::abs(*(a.get()), *(out.get())));
 
   if (rg) {
     make_abs_node(a, out);
@@ -843,6 +1522,12 @@ TensorPtr Tensor::gelu(const TensorPtr x) {
   const real1 k1 = real1(0.044715);
   const real1 k2 = real1(0.7978845608028654); // sqrt(2/pi)
 
+  if (LazyMode::is_enabled()) {
+    const LazyExprPtr l = LazyExpr::leaf(x);
+    return (k0 * l * (ONE_R1 + LazyExpr::tanh(k2 * (l + k1 * l * l * l))))
+        ->materialize();
+  }
+
   TensorPtr x3 = x * x * x;
   TensorPtr inner = k2 * (x + k1 * x3);
   TensorPtr t = Tensor::tanh(inner);
@@ -851,11 +1536,11 @@ TensorPtr Tensor::gelu(const TensorPtr x) {
 }
 
 TensorPtr Tensor::relu(TensorPtr a) {
-  const bool rg = a->requires_grad;
+  const bool rg = GradMode::is_enabled() && a->requires_grad;
   TensorPtr out =
       allocate_like(*(a.get()), a->storage->dtype, rg, IS_SPARSE(a));
 
-  Weed::relu(*(a.get()), *(out.get()));
+  WEED_LAUNCH(Weed::relu(*(a.get()), *(out.get())));
 
   if (rg) {
     make_relu_node(a, out);
@@ -879,11 +1564,11 @@ void Tensor::make_relu_node(TensorPtr a, TensorPtr out) {
 }
 
 TensorPtr Tensor::sigmoid(TensorPtr a) {
-  const bool rg = a->requires_grad;
+  const bool rg = GradMode::is_enabled() && a->requires_grad;
   TensorPtr out =
       allocate_like(*(a.get()), a->storage->dtype, rg, IS_SPARSE(a));
 
-  Weed::sigmoid(*(a.get()), *(out.get()));
+  WEED_LAUNCH(Weed::sigmoid(*(a.get()), *(out.get())));
 
   if (rg) {
     make_sigmoid_node(a, out);
@@ -907,11 +1592,11 @@ void Tensor::make_sigmoid_node(TensorPtr a, TensorPtr out) {
 }
 
 TensorPtr Tensor::tanh(TensorPtr a) {
-  const bool rg = a->requires_grad;
+  const bool rg = GradMode::is_enabled() && a->requires_grad;
   TensorPtr out =
       allocate_like(*(a.get()), a->storage->dtype, rg, IS_SPARSE(a));
 
-  Weed::tanh(*(a.get()), *(out.get()));
+  WEED_LAUNCH(Weed::tanh(*(a.get()), *(out.get())));
 
   if (rg) {
     make_tanh_node(a, out);
@@ -935,11 +1620,11 @@ void Tensor::make_tanh_node(TensorPtr a, TensorPtr out) {
 }
 
 TensorPtr Tensor::sin(TensorPtr a) {
-  const bool rg = a->requires_grad;
+  const bool rg = GradMode::is_enabled() && a->requires_grad;
   TensorPtr out =
       allocate_like(*(a.get()), a->storage->dtype, rg, IS_SPARSE(a));
 
-  Weed::sin(*(a.get()), *(out.get()));
+  WEED_LAUNCH(Weed::sin(*(a.get()), *(out.get())));
 
   if (rg) {
     make_sin_node(a, out);
@@ -963,11 +1648,11 @@ void Tensor::make_sin_node(TensorPtr a, TensorPtr out) {
 }
 
 TensorPtr Tensor::cos(TensorPtr a) {
-  const bool rg = a->requires_grad;
+  const bool rg = GradMode::is_enabled() && a->requires_grad;
   TensorPtr out =
       allocate_like(*(a.get()), a->storage->dtype, rg, IS_SPARSE(a));
 
-  Weed::cos(*(a.get()), *(out.get()));
+  WEED_LAUNCH(Weed::cos(*(a.get()), *(out.get())));
 
   if (rg) {
     make_cos_node(a, out);
@@ -991,10 +1676,10 @@ void Tensor::make_cos_node(TensorPtr a, TensorPtr out) {
 }
 
 TensorPtr Tensor::max(TensorPtr a) {
-  const bool rg = a->requires_grad;
+  const bool rg = GradMode::is_enabled() && a->requires_grad;
   TensorPtr out = allocate_scalar_like(*(a.get()), rg);
 
-  Weed::max(*(a.get()), *(out.get()));
+  WEED_LAUNCH(Weed::max(*(a.get()), *(out.get())));
 
   if (rg) {
     make_max_node(a, out);
@@ -1022,10 +1707,10 @@ void Tensor::make_max_node(TensorPtr a, TensorPtr out) {
 }
 
 TensorPtr Tensor::min(TensorPtr a) {
-  const bool rg = a->requires_grad;
+  const bool rg = GradMode::is_enabled() && a->requires_grad;
   TensorPtr out = allocate_scalar_like(*(a.get()), rg);
 
-  Weed::min(*(a.get()), *(out.get()));
+  WEED_LAUNCH(Weed::min(*(a.get()), *(out.get())));
 
   if (rg) {
     make_min_node(a, out);
@@ -1053,11 +1738,11 @@ void Tensor::make_min_node(TensorPtr a, TensorPtr out) {
 }
 
 TensorPtr Tensor::clamp(TensorPtr a, real1 lo, real1 hi) {
-  const bool rg = a->requires_grad;
+  const bool rg = GradMode::is_enabled() && a->requires_grad;
   TensorPtr out =
       allocate_like(*(a.get()), a->storage->dtype, rg, IS_SPARSE(a));
 
-  Weed::clamp(*(a.get()), lo, hi, *(out.get()));
+  WEED_LAUNCH(Weed::clamp(*(a.get()), lo, hi, *(out.get())));
 
   if (rg) {
     make_clamp_node(a, lo, hi, out);
@@ -1085,7 +1770,8 @@ TensorPtr Tensor::add(TensorPtr a, TensorPtr b) {
   const DeviceTag dtag = get_dtag_by_presidence({a, b});
   a->cast_in_place(dtag);
   b->cast_in_place(dtag);
-  const bool rg = a->requires_grad || b->requires_grad;
+  const bool rg =
+      GradMode::is_enabled() && (a->requires_grad || b->requires_grad);
   const bool s = IS_SPARSE(a) && IS_SPARSE(b);
   const DType dt = get_dtype_by_presidence({a, b});
   if (!a->match_shape(b) && !b->match_shape(a)) {
@@ -1093,7 +1779,7 @@ TensorPtr Tensor::add(TensorPtr a, TensorPtr b) {
   }
   TensorPtr out = Tensor::allocate_like(a->shape, *(a.get()), dt, rg, s);
 
-  Weed::add(*(a.get()), *(b.get()), *(out.get()));
+  WEED_LAUNCH(Weed::add(*(a.get()), *(b.get()), *(out.get())));
 
   if (rg) {
     make_add_node(a, b, out);
@@ -1114,32 +1800,29 @@ void Tensor::make_add_node(TensorPtr a, TensorPtr b, TensorPtr out) {
     }
     const DeviceTag dtag = get_dtag_by_presidence(p);
     TensorPtr out_grad = out->grad->cast(dtag);
+    const DType &dt = out_grad->storage->dtype;
     if (a->requires_grad) {
-      TensorPtr a_grad = a->grad->cast(dtag);
-      a_grad->upcast(out_grad->storage->dtype);
-      a_grad->match_shape(out_grad);
-      a_grad->materialize_broadcast();
-      Weed::add_in_place(*(a_grad.get()), *(out_grad.get()));
+      TensorPtr a_grad = reduced_grad_target(a, dtag, dt, out_grad);
+      Weed::reduce_broadcast_acc(*(a_grad.get()), *(out_grad.get()));
       a->grad = a_grad;
       a->reduce_grad_broadcast();
     }
     if (b->requires_grad) {
-      TensorPtr b_grad = b->grad->cast(dtag);
-      b_grad->upcast(out_grad->storage->dtype);
-      b_grad->match_shape(out_grad);
-      b_grad->materialize_broadcast();
-      Weed::add_in_place(*(b_grad.get()), *(out_grad.get()));
+      TensorPtr b_grad = reduced_grad_target(b, dtag, dt, out_grad);
+      Weed::reduce_broadcast_acc(*(b_grad.get()), *(out_grad.get()));
       b->grad = b_grad;
       b->reduce_grad_broadcast();
     }
   });
+  out->grad_node->reduce_grad = true;
 }
 
 TensorPtr Tensor::mul(TensorPtr a, TensorPtr b) {
   const DeviceTag dtag = get_dtag_by_presidence({a, b});
   a->cast_in_place(dtag);
   b->cast_in_place(dtag);
-  const bool rg = a->requires_grad || b->requires_grad;
+  const bool rg =
+      GradMode::is_enabled() && (a->requires_grad || b->requires_grad);
   const bool s = IS_SPARSE(a) && IS_SPARSE(b);
   const DType dt = get_dtype_by_presidence({a, b});
   if (!a->match_shape(b) && !b->match_shape(a)) {
@@ -1147,7 +1830,7 @@ TensorPtr Tensor::mul(TensorPtr a, TensorPtr b) {
   }
   TensorPtr out = Tensor::allocate_like(a->shape, *(a.get()), dt, rg, s);
 
-  Weed::mul(*(a.get()), *(b.get()), *(out.get()));
+  WEED_LAUNCH(Weed::mul(*(a.get()), *(b.get()), *(out.get())));
 
   if (rg) {
     make_mul_node(a, b, out);
@@ -1172,33 +1855,22 @@ void Tensor::make_mul_node(TensorPtr a, TensorPtr b, TensorPtr out) {
     TensorPtr out_grad = out->grad->cast(dtag);
     if (a->requires_grad) {
       TensorPtr _b = b->cast(dtag);
-      TensorPtr a_grad = a->grad->cast(dtag);
       const DType &dt = get_dtype_by_presidence({_b, out_grad});
-      a_grad->upcast(dt);
-      a_grad->match_shape(out_grad);
-      a_grad->materialize_broadcast();
-      TensorPtr tmp =
-          Tensor::allocate_like(*(a_grad.get()), dt, false, IS_SPARSE(b));
-      Weed::mul(*(out_grad.get()), *(_b.get()), *(tmp.get()));
-      Weed::add_in_place(*(a_grad.get()), *(tmp.get()));
+      TensorPtr a_grad = reduced_grad_target(a, dtag, dt, out_grad);
+      Weed::mul_acc(*(a_grad.get()), *(out_grad.get()), *(_b.get()));
       a->grad = a_grad;
       a->reduce_grad_broadcast();
     }
     if (b->requires_grad) {
       TensorPtr _a = a->cast(dtag);
-      TensorPtr b_grad = b->grad->cast(dtag);
       const DType &dt = get_dtype_by_presidence({_a, out_grad});
-      b_grad->upcast(dt);
-      b_grad->match_shape(out_grad);
-      b_grad->materialize_broadcast();
-      TensorPtr tmp =
-          Tensor::allocate_like(*(b_grad.get()), dt, false, IS_SPARSE(a));
-      Weed::mul(*(out_grad.get()), *(_a.get()), *(tmp.get()));
-      Weed::add_in_place(*(b_grad.get()), *(tmp.get()));
+      TensorPtr b_grad = reduced_grad_target(b, dtag, dt, out_grad);
+      Weed::mul_acc(*(b_grad.get()), *(out_grad.get()), *(_a.get()));
       b->grad = b_grad;
       b->reduce_grad_broadcast();
     }
   });
+  out->grad_node->reduce_grad = true;
 }
 
 TensorPtr Tensor::matmul(TensorPtr a, TensorPtr b) {
@@ -1206,7 +1878,8 @@ TensorPtr Tensor::matmul(TensorPtr a, TensorPtr b) {
     throw std::invalid_argument("Tensor::matmul requires a to have rank >= 2");
   }
 
-  const bool rg = a->requires_grad || b->requires_grad;
+  const bool rg =
+      GradMode::is_enabled() && (a->requires_grad || b->requires_grad);
   const bool s = IS_SPARSE(a) && IS_SPARSE(b);
   const DType dt = get_dtype_by_presidence({a, b});
 
@@ -1261,7 +1934,7 @@ TensorPtr Tensor::matmul(TensorPtr a, TensorPtr b) {
       TensorPtr bi = slice(b3, i);
       TensorPtr oi = slice(out3, i);
 
-      Weed::matmul(*(ai.get()), *(bi.get()), *(oi.get()));
+      WEED_LAUNCH(Weed::matmul(*(ai.get()), *(bi.get()), *(oi.get())));
 
       if (rg) {
         make_matmul_node(ai, bi, oi);
@@ -1305,7 +1978,7 @@ TensorPtr Tensor::matmul(TensorPtr a, TensorPtr b) {
   const std::vector<tcapint> str = {1U, as0};
   TensorPtr out = allocate_like(shp, str, *(a2.get()), dt, rg, s);
 
-  Weed::matmul(*(a2.get()), *(b.get()), *(out.get()));
+  WEED_LAUNCH(Weed::matmul(*(a2.get()), *(b.get()), *(out.get())));
 
   if (needs_flatten) {
     std::vector<symint> final_shape;
@@ -1363,24 +2036,32 @@ void Tensor::make_matmul_node(TensorPtr a, TensorPtr b, TensorPtr out) {
       TensorPtr bt = transpose(b)->cast(dtag);
 
       const DType &dt = get_dtype_by_presidence({b, out_grad});
-      TensorPtr tmp = Tensor::allocate_like(
-          std::vector<tcapint>{(tcapint)(batch * M),
-                               (tcapint)K}, // 2D flattened shape
-          std::vector<tcapint>{1U, (tcapint)(batch * M)}, *(a2.get()), dt,
-          false, IS_SPARSE(out_grad));
+      a_grad->upcast(dt);
 
-      Weed::matmul(*(out_grad2.get()), *(bt.get()), *(tmp.get()));
+      if (!needs_flatten) {
+        Weed::matmul_acc(*(out_grad2.get()), *(bt.get()), *(a_grad.get()));
+      } else if (is_contiguous(a_grad->shape, a_grad->stride)) {
+        // Accumulate through a flattened (batch * M, K) view of the gradient
+        TensorPtr a_grad2 = std::make_shared<Tensor>(*(a_grad.get()));
+        a_grad2->reshape({batch * M, K});
+        Weed::matmul_acc(*(out_grad2.get()), *(bt.get()), *(a_grad2.get()));
+      } else {
+        TensorPtr tmp = Tensor::allocate_like(
+            std::vector<tcapint>{(tcapint)(batch * M),
+                                 (tcapint)K}, // 2D flattened shape
+            std::vector<tcapint>{1U, (tcapint)(batch * M)}, *(a2.get()), dt,
+            false, IS_SPARSE(out_grad));
+
+        Weed::matmul(*(out_grad2.get()), *(bt.get()), *(tmp.get()));
 
-      if (needs_flatten) {
         std::vector<symint> a_shape(a->shape.size());
         for (size_t i = 0U; i < a_shape.size(); ++i) {
           a_shape[i] = (symint)(a->shape[i]);
         }
         tmp = reshape(tmp, a_shape); // restore (..., M, K)
-      }
 
-      a_grad->upcast(dt);
-      Weed::add_in_place(*(a_grad.get()), *(tmp.get()));
+        Weed::add_in_place(*(a_grad.get()), *(tmp.get()));
+      }
       a->grad = a_grad;
     }
 
@@ -1389,13 +2070,8 @@ void Tensor::make_matmul_node(TensorPtr a, TensorPtr b, TensorPtr out) {
       TensorPtr at = transpose(a2)->cast(dtag);
 
       const DType &dt = get_dtype_by_presidence({a, out_grad});
-      TensorPtr tmp = Tensor::allocate_like(*(b_grad.get()), dt, false,
-                                            IS_SPARSE(out_grad));
-
-      Weed::matmul(*(at.get()), *(out_grad2.get()), *(tmp.get()));
-
       b_grad->upcast(dt);
-      Weed::add_in_place(*(b_grad.get()), *(tmp.get()));
+      Weed::matmul_acc(*(at.get()), *(out_grad2.get()), *(b_grad.get()));
       b->grad = b_grad;
     }
   });
@@ -1405,7 +2081,8 @@ TensorPtr Tensor::sub(TensorPtr a, TensorPtr b) {
   const DeviceTag dtag = get_dtag_by_presidence({a, b});
   a->cast_in_place(dtag);
   b->cast_in_place(dtag);
-  const bool rg = a->requires_grad || b->requires_grad;
+  const bool rg =
+      GradMode::is_enabled() && (a->requires_grad || b->requires_grad);
   const bool s = IS_SPARSE(a) && IS_SPARSE(b);
   const DType dt = get_dtype_by_presidence({a, b});
   if (!a->match_shape(b) && !b->match_shape(a)) {
@@ -1413,7 +2090,7 @@ TensorPtr Tensor::sub(TensorPtr a, TensorPtr b) {
   }
   TensorPtr out = Tensor::allocate_like(a->shape, *(a.get()), dt, rg, s);
 
-  Weed::sub(*(a.get()), *(b.get()), *(out.get()));
+  WEED_LAUNCH(Weed::sub(*(a.get()), *(b.get()), *(out.get())));
 
   if (rg) {
     make_sub_node(a, b, out);
@@ -1434,32 +2111,29 @@ void Tensor::make_sub_node(TensorPtr a, TensorPtr b, TensorPtr out) {
     }
     const DeviceTag dtag = get_dtag_by_presidence(p);
     TensorPtr out_grad = out->grad->cast(dtag);
+    const DType &dt = out_grad->storage->dtype;
     if (a->requires_grad) {
-      TensorPtr a_grad = a->grad->cast(dtag);
-      a_grad->upcast(out_grad->storage->dtype);
-      a_grad->match_shape(out_grad);
-      a_grad->materialize_broadcast();
-      Weed::add_in_place(*(a_grad.get()), *(out_grad.get()));
+      TensorPtr a_grad = reduced_grad_target(a, dtag, dt, out_grad);
+      Weed::reduce_broadcast_acc(*(a_grad.get()), *(out_grad.get()));
       a->grad = a_grad;
       a->reduce_grad_broadcast();
     }
     if (b->requires_grad) {
-      TensorPtr b_grad = b->grad->cast(dtag);
-      b_grad->upcast(out_grad->storage->dtype);
-      b_grad->match_shape(out_grad);
-      b_grad->materialize_broadcast();
-      Weed::sub_in_place(*(b_grad.get()), *(out_grad.get()));
+      TensorPtr b_grad = reduced_grad_target(b, dtag, dt, out_grad);
+      Weed::reduce_broadcast_acc(*(b_grad.get()), *(out_grad.get()), -ONE_R1);
       b->grad = b_grad;
       b->reduce_grad_broadcast();
     }
   });
+  out->grad_node->reduce_grad = true;
 }
 
 TensorPtr Tensor::div(TensorPtr a, TensorPtr b) {
   const DeviceTag dtag = get_dtag_by_presidence({a, b});
   a->cast_in_place(dtag);
   b->cast_in_place(dtag);
-  const bool rg = a->requires_grad || b->requires_grad;
+  const bool rg =
+      GradMode::is_enabled() && (a->requires_grad || b->requires_grad);
   const bool s = IS_SPARSE(a) && IS_SPARSE(b);
   const DType dt = get_dtype_by_presidence({a, b});
   if (!a->match_shape(b) && !b->match_shape(a)) {
@@ -1467,7 +2141,7 @@ TensorPtr Tensor::div(TensorPtr a, TensorPtr b) {
   }
   TensorPtr out = Tensor::allocate_like(a->shape, *(a.get()), dt, rg, s);
 
-  Weed::div(*(a.get()), *(b.get()), *(out.get()));
+  WEED_LAUNCH(Weed::div(*(a.get()), *(b.get()), *(out.get())));
 
   if (rg) {
     make_div_node(a, b, out);
@@ -1491,44 +2165,31 @@ void Tensor::make_div_node(TensorPtr a, TensorPtr b, TensorPtr out) {
     TensorPtr _b = b->cast(dtag);
     TensorPtr out_grad = out->grad->cast(dtag);
     if (a->requires_grad) {
-      TensorPtr a_grad = a->grad->cast(dtag);
       const DType &dt = get_dtype_by_presidence({_b, out_grad});
-      a_grad->upcast(dt);
-      a_grad->match_shape(out_grad);
-      a_grad->materialize_broadcast();
-      TensorPtr tmp =
-          Tensor::allocate_like(*(a_grad.get()), dt, false, IS_SPARSE(b));
-      Weed::div(*(out_grad.get()), *(_b.get()), *(tmp.get()));
-      Weed::add_in_place(*(a_grad.get()), *(tmp.get()));
+      TensorPtr a_grad = reduced_grad_target(a, dtag, dt, out_grad);
+      Weed::div_acc(*(a_grad.get()), *(out_grad.get()), *(_b.get()));
       a->grad = a_grad;
       a->reduce_grad_broadcast();
     }
     if (b->requires_grad) {
       TensorPtr _a = a->cast(dtag);
-      TensorPtr b_grad = b->grad->cast(dtag);
-      const DType &dt = get_dtype_by_presidence({_b, _a});
-      b_grad->upcast(dt);
-      b_grad->match_shape(_a);
-      b_grad->materialize_broadcast();
-      TensorPtr b_sqr = Tensor::allocate_like(*(_b.get()), _b->storage->dtype,
-                                              false, IS_SPARSE(b));
-      Weed::mul(*(_b.get()), *(_b.get()), *(b_sqr.get()));
-      TensorPtr tmp =
-          Tensor::allocate_like(*(b_grad.get()), dt, false, IS_SPARSE(a));
-      Weed::div(*(_a.get()), *(b_sqr.get()), *(tmp.get()));
-      Weed::sub_in_place(*(b_grad.get()), *(tmp.get()));
+      const DType &dt = get_dtype_by_presidence({_b, _a, out_grad});
+      TensorPtr b_grad = reduced_grad_target(b, dtag, dt, out_grad);
+      Weed::div_grad_acc(*(b_grad.get()), *(_a.get()), *(_b.get()),
+                         *(out_grad.get()));
       b->grad = b_grad;
       b->reduce_grad_broadcast();
     }
   });
+  out->grad_node->reduce_grad = true;
 }
 
 TensorPtr Tensor::pow(TensorPtr a, real1 p) {
-  const bool rg = a->requires_grad;
+  const bool rg = GradMode::is_enabled() && a->requires_grad;
   TensorPtr out =
       allocate_like(*(a.get()), a->storage->dtype, rg, IS_SPARSE(a));
 
-  Weed::pow(*(a.get()), p, *(out.get()));
+  WEED_LAUNCH(Weed::pow(*(a.get()), p, *(out.get())));
 
   if (rg) {
     make_pow_node(a, p, out);
@@ -1542,7 +2203,6 @@ void Tensor::make_pow_node(TensorPtr x, real1 p, TensorPtr y) {
   y->grad_node = std::make_shared<Node>(std::vector<TensorPtr>{x}, [x, p, y]() {
     const DeviceTag dtag = get_dtag_by_presidence({x, y, x->grad, y->grad});
 
-    TensorPtr dx = x->grad->cast(dtag);
     TensorPtr dy = std::make_shared<Tensor>(*(y->grad.get()))->cast(dtag);
 
     TensorPtr _x = x->cast(dtag);
@@ -1551,33 +2211,23 @@ void Tensor::make_pow_node(TensorPtr x, real1 p, TensorPtr y) {
     _y->match_shape(_x);
     _x->match_shape(_y);
     dy->match_shape(_y);
-    dx->match_shape(_y);
-    dx->materialize_broadcast();
-
-    TensorPtr dy_y = Tensor::allocate_like(*(dy.get()), dy->storage->dtype,
-                                           false, IS_SPARSE(dy));
-    Weed::mul(*(dy.get()), *(_y.get()), *(dy_y.get()));
-
-    TensorPtr s = SCALAR(p, dy_y);
-    TensorPtr dy_y_p = s * dy_y;
 
-    TensorPtr r = Tensor::allocate_like(*(dx.get()), dy_y_p->storage->dtype,
-                                        false, IS_SPARSE(dy_y_p));
-    Weed::div(*(dy_y_p.get()), *(_x.get()), *(r.get()));
-
-    dx->upcast(r->storage->dtype);
-    Weed::add_in_place(*(dx.get()), *(r.get()));
+    // dx += p * dy * y / x
+    const DType &dt = get_dtype_by_presidence({dy, _y, _x});
+    TensorPtr dx = reduced_grad_target(x, dtag, dt, _y);
+    Weed::mul_div_acc(*(dx.get()), *(dy.get()), *(_y.get()), *(_x.get()), p);
     x->grad = dx;
     x->reduce_grad_broadcast();
   });
+  y->grad_node->reduce_grad = true;
 }
 
 TensorPtr Tensor::exp(TensorPtr a, real1 b) {
-  const bool rg = a->requires_grad;
+  const bool rg = GradMode::is_enabled() && a->requires_grad;
   TensorPtr out =
       allocate_like(*(a.get()), a->storage->dtype, rg, IS_SPARSE(a));
 
-  Weed::exp(*(a.get()), b, *(out.get()));
+  WEED_LAUNCH(Weed::exp(*(a.get()), b, *(out.get())));
 
   if (rg) {
     make_exp_node(a, (real1)std::log((real1_s)b), out);
@@ -1592,35 +2242,28 @@ void Tensor::make_exp_node(TensorPtr x, real1 log_b, TensorPtr y) {
       std::make_shared<Node>(std::vector<TensorPtr>{x}, [x, log_b, y]() {
         const DeviceTag dtag = get_dtag_by_presidence({y, x->grad, y->grad});
 
-        TensorPtr dx = x->grad->cast(dtag);
         TensorPtr dy = std::make_shared<Tensor>(*(y->grad.get()))->cast(dtag);
 
         TensorPtr _y = y->cast(dtag);
 
         dy->match_shape(_y);
-        dx->match_shape(_y);
-        dx->materialize_broadcast();
-
-        TensorPtr s = SCALAR(log_b, dy);
-        TensorPtr dy_v = s * dy;
-
-        TensorPtr r = Tensor::allocate_like(*(dx.get()), dy_v->storage->dtype,
-                                            false, IS_SPARSE(dy_v));
-        Weed::mul(*(dy_v.get()), *(_y.get()), *(r.get()));
 
-        dx->upcast(r->storage->dtype);
-        Weed::add_in_place(*(dx.get()), *(r.get()));
+        // dx += log(b) * dy * y
+        const DType &dt = get_dtype_by_presidence({dy, _y});
+        TensorPtr dx = reduced_grad_target(x, dtag, dt, _y);
+        Weed::mul_acc(*(dx.get()), *(dy.get()), *(_y.get()), log_b);
         x->grad = dx;
         x->reduce_grad_broadcast();
       });
+  y->grad_node->reduce_grad = true;
 }
 
 TensorPtr Tensor::log(TensorPtr a, real1 b) {
-  const bool rg = a->requires_grad;
+  const bool rg = GradMode::is_enabled() && a->requires_grad;
   TensorPtr out =
       allocate_like(*(a.get()), a->storage->dtype, rg, IS_SPARSE(a));
 
-  Weed::log(*(a.get()), b, *(out.get()));
+  WEED_LAUNCH(Weed::log(*(a.get()), b, *(out.get())));
 
   if (rg) {
     make_log_node(a, (real1)(ONE_R1 / std::log((real1_s)b)), out);
@@ -1635,26 +2278,19 @@ void Tensor::make_log_node(TensorPtr x, real1 inv_log_b, TensorPtr y) {
       std::make_shared<Node>(std::vector<TensorPtr>{x}, [x, inv_log_b, y]() {
         const DeviceTag dtag = get_dtag_by_presidence({x, x->grad, y->grad});
 
-        TensorPtr dx = x->grad->cast(dtag);
         TensorPtr dy = std::make_shared<Tensor>(*(y->grad.get()))->cast(dtag);
 
         TensorPtr _x = x->cast(dtag);
 
         dy->match_shape(_x);
-        dx->match_shape(_x);
-        dx->materialize_broadcast();
-
-        TensorPtr s = SCALAR(inv_log_b, dy);
-        TensorPtr dy_v = s * dy;
-
-        TensorPtr r = Tensor::allocate_like(*(dx.get()), dy_v->storage->dtype,
-                                            false, IS_SPARSE(dy_v));
-        Weed::div(*(dy_v.get()), *(_x.get()), *(r.get()));
 
-        dx->upcast(r->storage->dtype);
-        Weed::add_in_place(*(dx.get()), *(r.get()));
+        // dx += dy / (x * log(b))
+        const DType &dt = get_dtype_by_presidence({dy, _x});
+        TensorPtr dx = reduced_grad_target(x, dtag, dt, _x);
+        Weed::div_acc(*(dx.get()), *(dy.get()), *(_x.get()), inv_log_b);
         x->grad = dx;
         x->reduce_grad_broadcast();
       });
+  y->grad_node->reduce_grad = true;
 }
 } // namespace Weed
@@ -10,16 +10,49 @@
 // See LICENSE.md in the project root or
 // https://www.gnu.org/licenses/lgpl-3.en.html for details.
 
+#include <atomic>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
 
 #include "catch.hpp"
 
 #include "tests.hpp"
 
+#include "autograd/adam.hpp"
+#include "autograd/cross_entropy_loss.hpp"
+#include "autograd/grad_accumulator.hpp"
+#include "autograd/grad_hook.hpp"
+#include "autograd/grad_mode.hpp"
+#include "autograd/node.hpp"
 #include "autograd/sgd.hpp"
 #include "autograd/zero_grad.hpp"
+#include "common/philox.hpp"
+#include "modules/checkpoint.hpp"
+#include "modules/data_parallel.hpp"
+#include "modules/distributed_data_parallel.hpp"
+#include "modules/dropout.hpp"
+#include "modules/embedding.hpp"
+#include "modules/gru.hpp"
+#include "modules/layernorm.hpp"
+#include "modules/linear.hpp"
+#include "modules/lstm.hpp"
+#include "modules/quantized_linear.hpp"
+#include "modules/relu.hpp"
+#include "modules/rms_norm.hpp"
+#include "modules/rope.hpp"
+#include "modules/sequential.hpp"
+#include "modules/swiglu.hpp"
 #include "storage/all_storage.hpp"
+#include "storage/cpu_int_storage.hpp"
+#include "storage/mapped_cpu_real_storage.hpp"
 #include "tensors/complex_scalar.hpp"
+#include "tensors/lazy_expr.hpp"
 #include "tensors/real_scalar.hpp"
 
 using namespace Weed;
@@ -1358,3 +1391,1470 @@ TEST_CASE("test_matmul_gradient_sum_loss") {
   REQUIRE((*Bg)[4] == R(7));
   REQUIRE((*Bg)[5] == R(11));
 }
+
+TEST_CASE("test_arena_sequential_forward") {
+  using namespace Weed;
+
+  SequentialPtr model = std::make_shared<Sequential>(std::vector<ModulePtr>{
+      std::make_shared<Linear>(4, 8, true, true, DType::REAL, DeviceTag::CPU),
+      std::make_shared<ReLU>(),
+      std::make_shared<Linear>(8, 3, true, true, DType::REAL,
+                               DeviceTag::CPU)});
+  model->eval();
+
+  TensorPtr x = std::make_shared<Tensor>(
+      std::vector<real1>{R(1), R(-2), R(3), R(-4), R(5), R(-6), R(7), R(-8)},
+      std::vector<tcapint>{2, 4}, false, DeviceTag::CPU);
+
+  const TensorPtr expected = model->forward(x);
+
+  CpuArena arena(256U);
+  for (int pass = 0; pass < 2; ++pass) {
+    TensorPtr y;
+    SymbolTensorPtr idx;
+    {
+      ArenaGuard guard(arena);
+      y = model->forward(x);
+      REQUIRE(arena.get_used() > 0U);
+      REQUIRE(arena.owns(static_cast<CpuRealStorage *>(y->storage.get())
+                             ->data.get()));
+      y = CpuArena::persist(y);
+
+      // Index tensors are arena storage, too.
+      idx = std::make_shared<SymbolTensor>(std::vector<symint>{2, 0, 1},
+                                           std::vector<tcapint>{3U}, false,
+                                           DeviceTag::CPU);
+      REQUIRE(arena.owns(
+          static_cast<CpuIntStorage *>(idx->storage.get())->data.get()));
+      idx = CpuArena::persist(idx);
+    }
+    REQUIRE(arena.get_used() == 0U);
+    REQUIRE(!arena.owns(
+        static_cast<CpuIntStorage *>(idx->storage.get())->data.get()));
+    for (tcapint i = 0U; i < 3U; ++i) {
+      REQUIRE((*static_cast<IntStorage *>(idx->storage.get()))[i] ==
+              (symint)((i + 2U) % 3U));
+    }
+    REQUIRE(!arena.owns(
+        static_cast<CpuRealStorage *>(y->storage.get())->data.get()));
+    REQUIRE(y->shape == expected->shape);
+    for (tcapint i = 0U; i < 6U; ++i) {
+      REQUIRE_FLOAT((*static_cast<RealStorage *>(y->storage.get()))[i],
+                    (*static_cast<RealStorage *>(expected->storage.get()))[i]);
+    }
+  }
+
+  // After the first pass, the region is coalesced to a single block.
+  REQUIRE(arena.get_capacity() >= arena.get_peak());
+  REQUIRE(CpuArena::current() == nullptr);
+}
+
+TEST_CASE("test_half_storage_linear") {
+  using namespace Weed;
+
+  REQUIRE(Fp16Codec::decode(Fp16Codec::encode(1.5f)) == 1.5f);
+  REQUIRE(Fp16Codec::decode(Fp16Codec::encode(-0.25f)) == -0.25f);
+  REQUIRE(Fp16Codec::decode(Fp16Codec::encode(65504.0f)) == 65504.0f);
+  REQUIRE(Bf16Codec::decode(Bf16Codec::encode(1.5f)) == 1.5f);
+  REQUIRE(Bf16Codec::decode(Bf16Codec::encode(-3.0f)) == -3.0f);
+
+  LinearPtr l =
+      std::make_shared<Linear>(4, 3, true, true, DType::REAL, DeviceTag::CPU);
+  l->eval();
+
+  TensorPtr x = std::make_shared<Tensor>(
+      std::vector<real1>{R(1), R(-2), R(3), R(-4), R(5), R(-6), R(7), R(-8)},
+      std::vector<tcapint>{2, 4}, false, DeviceTag::CPU);
+
+  const StorageType types[2U]{StorageType::REAL_CPU_FP16,
+                              StorageType::REAL_CPU_BF16};
+  for (const StorageType &st : types) {
+    l->cast_parameters(st);
+    REQUIRE(l->weight->storage->stype == st);
+    REQUIRE(l->weight->storage->dtype == DType::REAL);
+
+    // Half-precision weights, fp32 compute
+    const TensorPtr y = l->forward(x);
+
+    std::stringstream ss;
+    l->weight->storage->save(ss);
+    StoragePtr s = Storage::load(ss);
+    REQUIRE(s->stype == st);
+    for (tcapint i = 0U; i < s->size; ++i) {
+      REQUIRE((*static_cast<RealStorage *>(s.get()))[i] ==
+              (*static_cast<RealStorage *>(l->weight->storage.get()))[i]);
+    }
+
+    // Same (rounded) weights, decoded up front
+    l->cast_parameters(StorageType::REAL_CPU_DENSE);
+    REQUIRE(l->weight->storage->stype == StorageType::REAL_CPU_DENSE);
+    const TensorPtr z = l->forward(x);
+    for (tcapint i = 0U; i < 6U; ++i) {
+      REQUIRE_FLOAT((*static_cast<RealStorage *>(y->storage.get()))[i],
+                    (*static_cast<RealStorage *>(z->storage.get()))[i]);
+    }
+  }
+}
+
+TEST_CASE("test_quantized_linear") {
+  using namespace Weed;
+
+  LinearPtr l =
+      std::make_shared<Linear>(6, 3, true, true, DType::REAL, DeviceTag::CPU);
+  for (tcapint j = 0U; j < 3U; ++j) {
+    static_cast<RealStorage *>(l->bias->storage.get())->write(j, R(0.5));
+  }
+
+  TensorPtr x = std::make_shared<Tensor>(
+      std::vector<real1>{R(1), R(-2), R(3), R(-4), R(5), R(-6), R(0.5),
+                         R(-0.5), R(1), R(2), R(-1), R(0)},
+      std::vector<tcapint>{2, 6}, true, DeviceTag::CPU);
+
+  l->eval();
+  const TensorPtr expected = l->forward(x);
+
+  const tcapint configs[3U][2U]{{8U, 0U}, {4U, 0U}, {4U, 4U}};
+  for (const auto &cfg : configs) {
+    QuantizedLinearPtr ql =
+        std::make_shared<QuantizedLinear>(*(l.get()), cfg[0U], cfg[1U]);
+    ql->eval();
+
+    // Reference: the same dequantized weights through a dense matmul
+    const TensorPtr wd = ql->weight->dequantize();
+    const TensorPtr ref = (x >> wd) + l->bias;
+
+    x->grad = nullptr;
+    const TensorPtr y = ql->forward(x);
+    REQUIRE(y->shape == expected->shape);
+    for (tcapint i = 0U; i < 6U; ++i) {
+      REQUIRE_FLOAT((*static_cast<RealStorage *>(y->storage.get()))[i],
+                    (*static_cast<RealStorage *>(ref->storage.get()))[i]);
+      // Rounding error is at most half a quantization step per weight.
+      const tcapint r = i % 2U;
+      const tcapint j = i / 2U;
+      const QuantizedWeight &qw = *(ql->weight.get());
+      real1_f bound = EPSILON;
+      for (tcapint k = 0U; k < 6U; ++k) {
+        bound += std::abs((real1_f)(*static_cast<RealStorage *>(
+                     x->storage.get()))[r + k * 2U]) *
+                 (real1_f)qw.scales[j * qw.get_groups() + k / qw.group_size] /
+                 2;
+      }
+      REQUIRE(std::abs(
+                  (real1_f)(*static_cast<RealStorage *>(y->storage.get()))[i] -
+                  (real1_f)(*static_cast<RealStorage *>(
+                      expected->storage.get()))[i]) <= bound);
+    }
+
+    // The gradient flows to the input through the quantized weights.
+    Tensor::backward(Tensor::sum(y));
+    for (tcapint k = 0U; k < 6U; ++k) {
+      real1_f row_sum = 0.0f;
+      for (tcapint j = 0U; j < 3U; ++j) {
+        row_sum += (real1_f)(*static_cast<RealStorage *>(
+            wd->storage.get()))[k + j * 6U];
+      }
+      REQUIRE_FLOAT(
+          (*static_cast<RealStorage *>(x->grad->storage.get()))[k * 2U],
+          row_sum);
+    }
+
+    std::stringstream ss;
+    ql->save(ss);
+    const ModulePtr loaded = Module::load(ss);
+    REQUIRE(loaded->mtype == QUANTIZED_LINEAR_T);
+    const TensorPtr z = loaded->forward(x);
+    for (tcapint i = 0U; i < 6U; ++i) {
+      REQUIRE((*static_cast<RealStorage *>(z->storage.get()))[i] ==
+              (*static_cast<RealStorage *>(y->storage.get()))[i]);
+    }
+  }
+}
+
+TEST_CASE("test_mapped_module_load") {
+  using namespace Weed;
+
+  LinearPtr l =
+      std::make_shared<Linear>(5, 7, false, true, DType::REAL, DeviceTag::CPU);
+  RealStorage *w = static_cast<RealStorage *>(l->weight->storage.get());
+
+  // Aligned blobs still load through a plain stream (by copying)
+  std::stringstream ss;
+  l->save_aligned(ss);
+  LinearPtr s = std::dynamic_pointer_cast<Linear>(Module::load(ss));
+  REQUIRE(s->weight->storage->stype == StorageType::REAL_CPU_DENSE);
+  for (tcapint i = 0U; i < 35U; ++i) {
+    REQUIRE((*static_cast<RealStorage *>(s->weight->storage.get()))[i] ==
+            (*w)[i]);
+  }
+
+  const std::string path = "weed_test_mapped.wml";
+  {
+    std::ofstream o(path, std::ios::binary);
+    l->save_aligned(o);
+  }
+
+  for (int pass = 0; pass < 2; ++pass) {
+    LinearPtr m = std::dynamic_pointer_cast<Linear>(Module::load_mapped(path));
+    MappedCpuRealStorage *ms =
+        dynamic_cast<MappedCpuRealStorage *>(m->weight->storage.get());
+    REQUIRE(ms != nullptr);
+    REQUIRE(!((uintptr_t)ms->data.get() % WEED_ALIGN_SIZE));
+    for (tcapint i = 0U; i < 35U; ++i) {
+      REQUIRE((*ms)[i] == (*w)[i]);
+    }
+
+    // Writes are copy-on-write, and never reach the file.
+    ms->FillValue(R(3));
+    REQUIRE((*ms)[0U] == R(3));
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("test_bulk_storage_serialization") {
+  using namespace Weed;
+
+  CpuRealStorage r(std::vector<real1>{R(1), R(-2), R(3.5)});
+  CpuComplexStorage c(
+      std::vector<complex>{complex(R(1), R(2)), complex(R(-3), R(0.5))});
+  SparseCpuRealStorage sp(5U);
+  sp.FillValue(R(0.25));
+  sp.write(3U, R(7));
+  sp.write(1U, R(-1));
+
+  for (int headers = 0; headers < 2; ++headers) {
+    Storage::set_blob_headers(headers);
+    std::stringstream ss;
+    r.save(ss);
+    c.save(ss);
+    sp.save(ss);
+    Storage::set_blob_headers(false);
+
+    StoragePtr lr = Storage::load(ss);
+    StoragePtr lc = Storage::load(ss);
+    StoragePtr ls = Storage::load(ss);
+    REQUIRE(lr->stype == StorageType::REAL_CPU_DENSE);
+    REQUIRE(ls->stype == StorageType::REAL_CPU_SPARSE);
+    for (tcapint i = 0U; i < 3U; ++i) {
+      REQUIRE((*static_cast<RealStorage *>(lr.get()))[i] == r[i]);
+    }
+    for (tcapint i = 0U; i < 2U; ++i) {
+      REQUIRE((*static_cast<ComplexStorage *>(lc.get()))[i] == c[i]);
+    }
+    // The fill value survives the round trip.
+    for (tcapint i = 0U; i < 5U; ++i) {
+      REQUIRE((*static_cast<RealStorage *>(ls.get()))[i] == sp[i]);
+    }
+  }
+
+  // A corrupted payload fails its checksum.
+  Storage::set_blob_headers(true);
+  std::stringstream ss;
+  r.save(ss);
+  Storage::set_blob_headers(false);
+  std::string b = ss.str();
+  b[b.size() - 1U] ^= 0x40;
+  std::stringstream bad(b);
+  REQUIRE_THROWS_AS(Storage::load(bad), std::domain_error);
+
+  // So does a truncated one, checksum or not.
+  std::stringstream full;
+  r.save(full);
+  const std::string t = full.str();
+  std::stringstream cut(t.substr(0U, t.size() - 2U));
+  REQUIRE_THROWS_AS(Storage::load(cut), std::domain_error);
+}
+
+TEST_CASE("test_no_grad_guard") {
+  using namespace Weed;
+
+  LinearPtr l =
+      std::make_shared<Linear>(4, 3, true, true, DType::REAL, DeviceTag::CPU);
+  TensorPtr x = Tensor::ones_like({2U, 4U}, true, false, DType::REAL,
+                                  DeviceTag::CPU);
+
+  {
+    NoGradGuard no_grad;
+    REQUIRE(!GradMode::is_enabled());
+    TensorPtr y = Tensor::sum(Tensor::relu(l->forward(x)));
+    REQUIRE(!y->requires_grad);
+    REQUIRE(!y->grad_node);
+    REQUIRE(!y->grad);
+    REQUIRE(!x->grad);
+    REQUIRE(!l->weight->grad);
+  }
+  REQUIRE(GradMode::is_enabled());
+
+  set_inference_mode(true);
+  REQUIRE(get_inference_mode());
+  REQUIRE(!Tensor::mul(x, x)->grad_node);
+  set_inference_mode(false);
+
+  TensorPtr y = Tensor::sum(l->forward(x));
+  REQUIRE(y->grad_node);
+  Tensor::backward(y);
+  REQUIRE(x->grad);
+  REQUIRE(l->weight->grad);
+}
+
+TEST_CASE("test_lazy_gradient_allocation") {
+  using namespace Weed;
+
+  TensorPtr x = Tensor::ones_like({3U, 4U}, true, false, DType::REAL,
+                                  DeviceTag::CPU);
+  TensorPtr h = Tensor::mul(x, x);
+  TensorPtr y = Tensor::sum(h);
+
+  // Before backward, dense gradients are only empty placeholders.
+  REQUIRE(h->grad);
+  REQUIRE(!h->grad->storage->get_sparse_size());
+  REQUIRE(!x->grad->storage->get_sparse_size());
+
+  Tensor::backward(y);
+
+  // Intermediate gradients are released once consumed; leaves keep theirs.
+  REQUIRE(!h->grad);
+  REQUIRE(x->grad->storage->stype == StorageType::REAL_CPU_DENSE);
+  for (tcapint i = 0U; i < 12U; ++i) {
+    REQUIRE((*static_cast<RealStorage *>(x->grad->storage.get()))[i] ==
+            R(2));
+  }
+}
+
+TEST_CASE("test_backward_deep_graph") {
+  using namespace Weed;
+
+  // Deep enough to overflow a recursive traversal
+  const tcapint depth = 100000U;
+  TensorPtr x = std::make_shared<RealScalar>(R(1), true, DeviceTag::CPU);
+  TensorPtr h = x;
+  for (tcapint i = 0U; i < depth; ++i) {
+    h = Tensor::add(h, x);
+  }
+  TensorPtr mid = h;
+  TensorPtr y = Tensor::add(h, x);
+  Tensor::backward(y);
+
+  REQUIRE(GET_REAL(x->grad) == R(depth + 2U));
+  // The graph is released as backward runs.
+  REQUIRE(!mid->grad_node);
+  REQUIRE(!y->grad_node->backward);
+  REQUIRE(y->grad_node->parents.empty());
+
+  // A node may list an absent (null) parent.
+  TensorPtr z = std::make_shared<RealScalar>(R(2), true, DeviceTag::CPU);
+  TensorPtr w = std::make_shared<RealScalar>(R(0), true, DeviceTag::CPU);
+  w->make_gradient();
+  w->grad_node = std::make_shared<Node>(
+      std::vector<TensorPtr>{nullptr, z}, [z, w]() {
+        Weed::add_in_place(*(z->grad.get()), *(w->grad.get()));
+      });
+  Tensor::backward(w);
+  REQUIRE(GET_REAL(z->grad) == R(1));
+}
+
+TEST_CASE("test_checkpoint_module") {
+  using namespace Weed;
+
+  SequentialPtr m = std::make_shared<Sequential>(std::vector<ModulePtr>{
+      std::make_shared<Linear>(4, 6, true, true, DType::REAL, DeviceTag::CPU),
+      std::make_shared<ReLU>(),
+      std::make_shared<Linear>(6, 3, true, true, DType::REAL,
+                               DeviceTag::CPU)});
+  CheckpointPtr ck = std::make_shared<Checkpoint>(m);
+  const std::vector<ParameterPtr> params = ck->parameters();
+  TensorPtr x = std::make_shared<Tensor>(
+      std::vector<real1>{R(0.5), R(-1), R(2), R(0.25), R(1), R(-0.5), R(0.75),
+                         R(-2)},
+      std::vector<tcapint>{2U, 4U}, true, DeviceTag::CPU);
+
+  Tensor::backward(Tensor::sum(m->forward(x)));
+  std::vector<std::vector<real1>> expected;
+  for (const ParameterPtr &p : params) {
+    std::vector<real1> g(p->grad->storage->size);
+    for (size_t i = 0U; i < g.size(); ++i) {
+      g[i] = (*static_cast<RealStorage *>(p->grad->storage.get()))[i];
+    }
+    expected.push_back(g);
+  }
+  std::vector<real1> x_expected(8U);
+  for (size_t i = 0U; i < 8U; ++i) {
+    x_expected[i] = (*static_cast<RealStorage *>(x->grad->storage.get()))[i];
+  }
+  zero_grad(params);
+  x->grad->storage->FillZeros();
+
+  TensorPtr y = ck->forward(x);
+  // Only the checkpoint's own node is recorded.
+  REQUIRE(y->grad_node->parents.size() == (params.size() + 1U));
+  Tensor::backward(Tensor::sum(y));
+
+  for (size_t j = 0U; j < params.size(); ++j) {
+    RealStorage *g = static_cast<RealStorage *>(params[j]->grad->storage.get());
+    for (size_t i = 0U; i < expected[j].size(); ++i) {
+      REQUIRE((*g)[i] == Approx(expected[j][i]));
+    }
+  }
+  for (size_t i = 0U; i < 8U; ++i) {
+    REQUIRE((*static_cast<RealStorage *>(x->grad->storage.get()))[i] ==
+            Approx(x_expected[i]));
+  }
+}
+
+TEST_CASE("test_graph_capture_replay") {
+  using namespace Weed;
+
+  SequentialPtr m = std::make_shared<Sequential>(std::vector<ModulePtr>{
+      std::make_shared<Linear>(4, 6, true, true, DType::REAL, DeviceTag::CPU),
+      std::make_shared<ReLU>(),
+      std::make_shared<Linear>(6, 3, true, true, DType::REAL,
+                               DeviceTag::CPU)});
+  m->eval();
+
+  TensorPtr x0 = Tensor::zeros({2U, 4U}, false, false, DType::REAL,
+                               DeviceTag::CPU);
+  CapturedGraphPtr g = m->capture(x0);
+  REQUIRE(g->launches.size() >= 4U);
+
+  for (int trial = 0; trial < 3; ++trial) {
+    std::vector<real1> v(8U);
+    for (size_t i = 0U; i < v.size(); ++i) {
+      v[i] = R((int)((i * 7U + trial * 3U) % 5U) - 2);
+    }
+    TensorPtr x = std::make_shared<Tensor>(v, std::vector<tcapint>{2U, 4U},
+                                           false, DeviceTag::CPU);
+    TensorPtr expected = Tensor::contiguous(m->forward(x));
+    TensorPtr y = Tensor::contiguous(g->replay(x));
+    REQUIRE(y->shape == expected->shape);
+    RealStorage *ys = static_cast<RealStorage *>(y->storage.get());
+    RealStorage *es = static_cast<RealStorage *>(expected->storage.get());
+    for (tcapint i = 0U; i < 6U; ++i) {
+      REQUIRE((*ys)[i] == Approx((*es)[i]));
+    }
+  }
+
+  REQUIRE_THROWS_AS(g->replay(Tensor::zeros({3U, 4U}, false, false,
+                                            DType::REAL, DeviceTag::CPU)),
+                    std::invalid_argument);
+
+  // Fused kernels are recorded, too.
+  const std::vector<ModulePtr> fused{
+      std::make_shared<RMSNorm>(4U),
+      std::make_shared<LayerNorm>(4U, DeviceTag::CPU),
+      std::make_shared<SwiGLU>(4U, 6U)};
+  const std::vector<tcapint> shp{2U, 1U, 4U};
+  TensorPtr f0 = Tensor::zeros(shp, false, false, DType::REAL, DeviceTag::CPU);
+  for (const ModulePtr &f : fused) {
+    f->eval();
+    REQUIRE(f->is_capturable());
+    CapturedGraphPtr fg = f->capture(f0);
+    REQUIRE(fg->launches.size() >= 1U);
+    for (int trial = 0; trial < 3; ++trial) {
+      std::vector<real1> v(8U);
+      for (size_t i = 0U; i < v.size(); ++i) {
+        v[i] = R((int)((i * 5U + trial * 3U) % 7U) - 3) / 2;
+      }
+      TensorPtr x = std::make_shared<Tensor>(v, shp, false, DeviceTag::CPU);
+      TensorPtr expected = Tensor::contiguous(f->forward(x));
+      TensorPtr y = Tensor::contiguous(fg->replay(x));
+      REQUIRE(y->shape == expected->shape);
+      RealStorage *ys = static_cast<RealStorage *>(y->storage.get());
+      RealStorage *es = static_cast<RealStorage *>(expected->storage.get());
+      for (tcapint i = 0U; i < v.size(); ++i) {
+        REQUIRE((*ys)[i] == Approx((*es)[i]));
+      }
+    }
+  }
+}
+
+static void require_same_values(Weed::TensorPtr a, Weed::TensorPtr b) {
+  using namespace Weed;
+  a = Tensor::contiguous(a);
+  b = Tensor::contiguous(b);
+  REQUIRE(a->shape == b->shape);
+  RealStorage *as = static_cast<RealStorage *>(a->storage.get());
+  RealStorage *bs = static_cast<RealStorage *>(b->storage.get());
+  for (tcapint i = 0U; i < a->get_broadcast_size(); ++i) {
+    REQUIRE((*as)[i] == Approx((*bs)[i]).margin(1e-5));
+  }
+}
+
+TEST_CASE("test_lazy_elementwise_fusion") {
+  using namespace Weed;
+
+  std::vector<real1> v(48U);
+  for (size_t i = 0U; i < v.size(); ++i) {
+    v[i] = R((int)((i * 7U) % 11U) - 5) / 4;
+  }
+  TensorPtr x = std::make_shared<Tensor>(v, std::vector<tcapint>{3U, 2U, 8U},
+                                         false, DeviceTag::CPU);
+  RMSNormPtr rms = std::make_shared<RMSNorm>(8U);
+  LayerNormPtr ln = std::make_shared<LayerNorm>(8U, DeviceTag::CPU);
+
+  NoGradGuard ng;
+  TensorPtr gelu = Tensor::gelu(x);
+  TensorPtr rms_y = rms->forward(x);
+  TensorPtr ln_y = ln->forward(x);
+  {
+    LazyModeGuard lazy;
+    require_same_values(Tensor::gelu(x), gelu);
+    require_same_values(rms->forward(x), rms_y);
+    require_same_values(ln->forward(x), ln_y);
+  }
+
+  // Broadcast operands and folded constants
+  TensorPtr b = std::make_shared<Tensor>(std::vector<real1>{R(1), R(2), R(3)},
+                                         std::vector<tcapint>{3U, 1U, 1U},
+                                         false, DeviceTag::CPU);
+  const LazyExprPtr lx = LazyExpr::leaf(x);
+  const LazyExprPtr e =
+      LazyExpr::exp(lx - LazyExpr::leaf(b)) * (R(2) * R(3)) + (lx ^ R(2));
+  require_same_values(e->materialize(), e->eager());
+}
+
+TEST_CASE("test_static_memory_plan") {
+  using namespace Weed;
+
+  SequentialPtr m = std::make_shared<Sequential>(std::vector<ModulePtr>{
+      std::make_shared<Linear>(4, 16, true, true, DType::REAL,
+                               DeviceTag::CPU),
+      std::make_shared<ReLU>(),
+      std::make_shared<RMSNorm>(16),
+      std::make_shared<Linear>(16, 16, true, true, DType::REAL,
+                               DeviceTag::CPU),
+      std::make_shared<ReLU>(),
+      std::make_shared<Linear>(16, 3, true, true, DType::REAL,
+                               DeviceTag::CPU)});
+  m->eval();
+
+  MemoryPlanPtr plan = m->plan_memory({8U, 4U});
+  REQUIRE(plan->intervals.size() > 0U);
+  REQUIRE(plan->get_peak() >= plan->get_live_peak());
+  REQUIRE(plan->get_peak() < plan->get_unplanned_bytes());
+
+  for (int trial = 0; trial < 2; ++trial) {
+    std::vector<real1> v(32U);
+    for (size_t i = 0U; i < v.size(); ++i) {
+      v[i] = R((int)((i * 5U + trial) % 7U) - 3) / 2;
+    }
+    TensorPtr x = std::make_shared<Tensor>(v, std::vector<tcapint>{8U, 4U},
+                                           false, DeviceTag::CPU);
+    TensorPtr expected;
+    {
+      NoGradGuard ng;
+      expected = m->forward(x);
+    }
+    TensorPtr y = m->forward_planned(*(plan.get()), x);
+    REQUIRE(!plan->owns(y->storage.get()));
+    require_same_values(y, expected);
+  }
+  REQUIRE(plan->get_misses() == 0U);
+
+  REQUIRE_THROWS_AS(
+      m->forward_planned(*(plan.get()), Tensor::zeros({3U, 4U}, false, false,
+                                                      DType::REAL,
+                                                      DeviceTag::CPU)),
+      std::invalid_argument);
+
+  // Index tensors placed in the slab can be persisted, too.
+  const std::vector<symint> iv{2, 0, 1};
+  const auto make_idx = [&iv]() {
+    return std::make_shared<SymbolTensor>(iv, std::vector<tcapint>{3U}, false,
+                                          DeviceTag::CPU);
+  };
+  MemoryPlan ip(std::vector<tcapint>{3U});
+  {
+    MemoryPlanGuard guard(ip);
+    make_idx();
+  }
+  ip.finalize();
+  SymbolTensorPtr idx;
+  {
+    MemoryPlanGuard guard(ip);
+    idx = make_idx();
+    REQUIRE(ip.owns(
+        static_cast<CpuIntStorage *>(idx->storage.get())->data.get()));
+    idx = MemoryPlan::persist(idx);
+  }
+  REQUIRE(!ip.owns(
+      static_cast<CpuIntStorage *>(idx->storage.get())->data.get()));
+  for (tcapint i = 0U; i < 3U; ++i) {
+    REQUIRE((*static_cast<IntStorage *>(idx->storage.get()))[i] == iv[i]);
+  }
+}
+
+static Weed::real1 flat_real(Weed::TensorPtr t, const tcapint &i) {
+  using namespace Weed;
+  t = Tensor::contiguous(t);
+
+  return (*static_cast<RealStorage *>(t->storage.get()))[i];
+}
+
+TEST_CASE("test_fused_grad_accumulation") {
+  using namespace Weed;
+
+  const std::vector<real1> av{R(1), R(2), R(3), R(4), R(5), R(6)};
+  const std::vector<real1> bv{R(2), R(4), R(5)};
+  const std::vector<real1> cv{R(3), R(-1), R(2), R(1), R(-2), R(4)};
+
+  // Quotient by a broadcast divisor, under a non-unit upstream gradient
+  TensorPtr a = std::make_shared<Tensor>(av, std::vector<tcapint>{2U, 3U},
+                                         true, DeviceTag::CPU);
+  TensorPtr b = std::make_shared<Tensor>(bv, std::vector<tcapint>{3U}, true,
+                                         DeviceTag::CPU);
+  TensorPtr c = std::make_shared<Tensor>(cv, std::vector<tcapint>{2U, 3U},
+                                         false, DeviceTag::CPU);
+  Tensor::backward(Tensor::sum((a / b) * c));
+
+  std::vector<real1> db(3U, ZERO_R1);
+  for (tcapint j = 0U; j < 3U; ++j) {
+    for (tcapint i = 0U; i < 2U; ++i) {
+      const tcapint k = i + 2U * j;
+      REQUIRE(flat_real(a->grad, k) == Approx(cv[k] / bv[j]));
+      db[j] -= cv[k] * av[k] / (bv[j] * bv[j]);
+    }
+    REQUIRE(flat_real(b->grad, j) == Approx(db[j]));
+  }
+
+  // The broadcast divisor's gradient lives at its reduced shape, and the next
+  // pass accumulates straight into that same buffer.
+  REQUIRE(b->grad->storage->size == 3U);
+  const StoragePtr b_storage = b->grad->storage;
+  Tensor::backward(Tensor::sum((a / b) * c));
+  REQUIRE(b->grad->storage == b_storage);
+  for (tcapint j = 0U; j < 3U; ++j) {
+    REQUIRE(flat_real(b->grad, j) == Approx(2 * db[j]));
+  }
+
+  // pow, exp and log of a broadcast operand reduce into its gradient, too
+  TensorPtr q = std::make_shared<Tensor>(bv, std::vector<tcapint>{3U}, true,
+                                         DeviceTag::CPU);
+  TensorPtr z = q + c;
+  Tensor::backward(Tensor::sum(z) + Tensor::sum(Tensor::pow(q, R(2))) +
+                   Tensor::sum(Tensor::exp(q)) + Tensor::sum(Tensor::log(q)));
+  REQUIRE(q->grad->storage->size == 3U);
+  for (tcapint j = 0U; j < 3U; ++j) {
+    const real1 v = bv[j];
+    REQUIRE(flat_real(q->grad, j) ==
+            Approx(2 * (1 + 2 * v + (real1)std::exp(v) + 1 / v)));
+  }
+
+  // A slice's gradient adds into its region of the parent gradient
+  TensorPtr t = std::make_shared<Tensor>(av, std::vector<tcapint>{2U, 3U},
+                                         true, DeviceTag::CPU);
+  Tensor::backward(Tensor::sum(Tensor::slice(t, 1, 1U, 2U) * R(2)));
+  for (tcapint k = 0U; k < 6U; ++k) {
+    REQUIRE(flat_real(t->grad, k) == Approx((k < 2U) ? 0 : 2));
+  }
+
+  // Two uses of one matmul operand accumulate into the same gradients
+  TensorPtr x = std::make_shared<Tensor>(av, std::vector<tcapint>{2U, 3U},
+                                         true, DeviceTag::CPU);
+  TensorPtr w = std::make_shared<Tensor>(cv, std::vector<tcapint>{3U, 2U},
+                                         true, DeviceTag::CPU);
+  Tensor::backward(Tensor::sum(Tensor::matmul(x, w)) +
+                   Tensor::sum(Tensor::matmul(x, w)));
+
+  for (tcapint i = 0U; i < 2U; ++i) {
+    for (tcapint k = 0U; k < 3U; ++k) {
+      // d/dx[i, k] = 2 * sum_n w[k, n]
+      REQUIRE(flat_real(x->grad, i + 2U * k) ==
+              Approx(2 * (cv[k] + cv[k + 3U])));
+      // d/dw[k, i] = 2 * sum_m x[m, k]
+      REQUIRE(flat_real(w->grad, k + 3U * i) ==
+              Approx(2 * (av[2U * k] + av[2U * k + 1U])));
+    }
+  }
+}
+
+TEST_CASE("test_fused_adam_step") {
+  using namespace Weed;
+
+  const std::vector<real1> pv{R(1), R(-2), R(3)};
+  const std::vector<real1> gv{R(0.5), R(-1), R(2)};
+
+  for (int decoupled = 0; decoupled < 2; ++decoupled) {
+    const real1 lr = R(0.1);
+    const real1 wd = R(0.2);
+    ParameterPtr p = std::make_shared<Parameter>(
+        pv, std::vector<tcapint>{3U}, DeviceTag::CPU);
+    Adam opt(lr, ADAM_BETA1_DEFAULT, ADAM_BETA2_DEFAULT, ADAM_EPSILON_DEFAULT,
+             wd, decoupled);
+    opt.register_parameter(p);
+    const StoragePtr m_storage = opt.state[p].m->storage;
+
+    std::vector<real1> ep(pv), em(3U, ZERO_R1), ev(3U, ZERO_R1);
+    for (int t = 1; t <= 3; ++t) {
+      p->grad = std::make_shared<Tensor>(gv, std::vector<tcapint>{3U}, false,
+                                         DeviceTag::CPU);
+      adam_step(opt, {p});
+
+      const real1 bc1 = ONE_R1 - std::pow(ADAM_BETA1_DEFAULT, (real1)t);
+      const real1 bc2 = ONE_R1 - std::pow(ADAM_BETA2_DEFAULT, (real1)t);
+      for (size_t i = 0U; i < 3U; ++i) {
+        const real1 g = gv[i] + (decoupled ? ZERO_R1 : wd * ep[i]);
+        em[i] = ADAM_BETA1_DEFAULT * em[i] + (ONE_R1 - ADAM_BETA1_DEFAULT) * g;
+        ev[i] =
+            ADAM_BETA2_DEFAULT * ev[i] + (ONE_R1 - ADAM_BETA2_DEFAULT) * g * g;
+        ep[i] -= lr * (em[i] / bc1) /
+                     (std::sqrt(ev[i] / bc2) + ADAM_EPSILON_DEFAULT) +
+                 (decoupled ? lr * wd * ep[i] : ZERO_R1);
+        REQUIRE(flat_real(p, i) == Approx(ep[i]));
+      }
+    }
+
+    // Moments are updated in place, not reallocated
+    REQUIRE(opt.state[p].m->storage == m_storage);
+  }
+
+  // A gradient broadcast from one element isn't fused, but steps the same as
+  // its dense equivalent.
+  ParameterPtr q =
+      std::make_shared<Parameter>(pv, std::vector<tcapint>{3U}, DeviceTag::CPU);
+  ParameterPtr r =
+      std::make_shared<Parameter>(pv, std::vector<tcapint>{3U}, DeviceTag::CPU);
+  Adam opt(R(0.1));
+  opt.register_parameters({q, r});
+  q->grad = std::make_shared<Tensor>(std::vector<real1>{R(0.5)},
+                                     std::vector<tcapint>{1U}, false,
+                                     DeviceTag::CPU);
+  q->grad->shape[0U] = 3U;
+  q->grad->stride[0U] = 0U;
+  r->grad = std::make_shared<Tensor>(std::vector<real1>(3U, R(0.5)),
+                                     std::vector<tcapint>{3U}, false,
+                                     DeviceTag::CPU);
+  REQUIRE(!can_adam_update(*q, *(opt.state[q].m), *(opt.state[q].v),
+                           *(q->grad)));
+  adam_step(opt, {q, r});
+  for (tcapint i = 0U; i < 3U; ++i) {
+    REQUIRE(flat_real(q, i) == Approx(flat_real(r, i)));
+  }
+}
+
+TEST_CASE("test_lazy_sparse_adam") {
+  using namespace Weed;
+
+  const tcapint vocab = 5U;
+  const tcapint dim = 2U;
+  Embedding emb(vocab, dim, DType::REAL, DeviceTag::CPU, -1, true);
+  std::vector<real1> before(vocab * dim);
+  for (tcapint i = 0U; i < before.size(); ++i) {
+    before[i] = R(i + 1U);
+  }
+  emb.weight = std::make_shared<Parameter>(
+      before, std::vector<tcapint>{vocab, dim}, DeviceTag::CPU);
+  ParameterPtr w = emb.weight;
+  AdamW opt(R(0.1), R(0.5));
+  opt.register_parameter(w);
+
+  SymbolTensorPtr x = std::make_shared<SymbolTensor>(
+      std::vector<symint>{1, 3, 1}, std::vector<tcapint>{3U}, false,
+      DeviceTag::CPU);
+  TensorPtr y = Tensor::sum(emb.forward(x));
+  Tensor::backward(y);
+
+  REQUIRE(w->grad->storage->is_sparse());
+  REQUIRE(can_adam_update(*w, *(opt.state[w].m), *(opt.state[w].v), *w->grad));
+
+  adam_step(opt, {w});
+
+  // Decoupled decay and moments only touch the rows of seen tokens
+  for (tcapint r = 0U; r < vocab; ++r) {
+    const bool seen = (r == 1U) || (r == 3U);
+    for (tcapint c = 0U; c < dim; ++c) {
+      const tcapint i = r + c * vocab;
+      if (seen) {
+        REQUIRE(flat_real(w, i) != Approx(before[i]));
+        REQUIRE(flat_real(opt.state[w].m, i) != Approx(ZERO_R1));
+      } else {
+        REQUIRE(flat_real(w, i) == before[i]);
+        REQUIRE(flat_real(opt.state[w].m, i) == ZERO_R1);
+      }
+    }
+  }
+}
+
+TEST_CASE("test_grad_accumulation") {
+  using namespace Weed;
+
+  const std::vector<real1> wv{R(1), R(2), R(3)};
+  const std::vector<std::vector<real1>> xs{{R(1), R(0), R(-1)},
+                                           {R(3), R(2), R(1)}};
+  ParameterPtr w =
+      std::make_shared<Parameter>(wv, std::vector<tcapint>{3U}, DeviceTag::CPU);
+  GradAccumulator acc({w});
+
+  StoragePtr grad_storage = nullptr;
+  for (const std::vector<real1> &xv : xs) {
+    TensorPtr x = std::make_shared<Tensor>(xv, std::vector<tcapint>{3U}, false,
+                                           DeviceTag::CPU);
+    acc.accumulate(Tensor::sum(w * x));
+    if (grad_storage) {
+      // Micro-batches accumulate into the same gradient buffer
+      REQUIRE(w->grad->storage == grad_storage);
+    }
+    grad_storage = w->grad->storage;
+  }
+
+  REQUIRE(acc.micro_batches == 2U);
+  for (tcapint i = 0U; i < 3U; ++i) {
+    REQUIRE(flat_real(w->grad, i) == Approx(xs[0U][i] + xs[1U][i]));
+  }
+
+  const real1 lr = R(0.5);
+  acc.sgd_step(lr);
+
+  REQUIRE(acc.micro_batches == 0U);
+  REQUIRE(w->grad->storage == grad_storage);
+  for (tcapint i = 0U; i < 3U; ++i) {
+    const real1 mean_grad = (xs[0U][i] + xs[1U][i]) / 2;
+    REQUIRE(flat_real(w, i) == Approx(wv[i] - lr * mean_grad));
+    REQUIRE(flat_real(w->grad, i) == ZERO_R1);
+  }
+
+  // Broadcast (bias) gradients accumulate across backward passes, too.
+  LinearPtr l = std::make_shared<Linear>(3U, 2U, true, true, DType::REAL,
+                                         DeviceTag::CPU);
+  std::vector<real1> bias_sum(2U, ZERO_R1);
+  for (int pass = 0; pass < 2; ++pass) {
+    for (const std::vector<real1> &xv : xs) {
+      std::vector<real1> batch(xv);
+      batch.insert(batch.end(), xv.rbegin(), xv.rend());
+      TensorPtr x = std::make_shared<Tensor>(
+          batch, std::vector<tcapint>{2U, 3U}, false, DeviceTag::CPU);
+      TensorPtr y = l->forward(x);
+      if (pass) {
+        Tensor::backward(Tensor::sum(y * y));
+      } else {
+        zero_grad({l->bias});
+        Tensor::backward(Tensor::sum(y * y));
+        for (tcapint i = 0U; i < 2U; ++i) {
+          bias_sum[i] += flat_real(l->bias->grad, i);
+        }
+      }
+    }
+    if (!pass) {
+      zero_grad({l->bias});
+    }
+  }
+  for (tcapint i = 0U; i < 2U; ++i) {
+    REQUIRE(flat_real(l->bias->grad, i) == Approx(bias_sum[i]));
+  }
+}
+
+TEST_CASE("test_data_parallel") {
+  using namespace Weed;
+
+  LinearPtr master = std::make_shared<Linear>(3U, 2U, true, true, DType::REAL,
+                                              DeviceTag::CPU);
+  const std::vector<std::vector<real1>> shards{
+      {R(1), R(0), R(-1), R(2), R(1), R(0)},
+      {R(-2), R(1), R(3), R(0), R(1), R(1)},
+      {R(1), R(1), R(1), R(-1), R(0), R(2)}};
+  const auto loss = [&](const ModulePtr &m, const tcapint &i) {
+    TensorPtr x = std::make_shared<Tensor>(
+        shards[i], std::vector<tcapint>{2U, 3U}, false, DeviceTag::CPU);
+    TensorPtr y = m->forward(x);
+    return Tensor::mean(y * y);
+  };
+
+  DataParallel dp(master, shards.size());
+  for (const ModulePtr &r : dp.replicas) {
+    REQUIRE(r->parameters()[0U]->storage == master->weight->storage);
+  }
+  dp.backward(loss);
+
+  const std::vector<ParameterPtr> params = master->parameters();
+  std::vector<std::vector<real1>> parallel_grads;
+  for (const ParameterPtr &p : params) {
+    std::vector<real1> g(p->get_size());
+    for (tcapint k = 0U; k < g.size(); ++k) {
+      g[k] = flat_real(p->grad, k);
+    }
+    parallel_grads.push_back(g);
+  }
+
+  // Reference: the same shards, serially, on the master
+  zero_grad(params);
+  for (tcapint i = 0U; i < shards.size(); ++i) {
+    Tensor::backward((ONE_R1 / shards.size()) * loss(master, i));
+  }
+  for (size_t j = 0U; j < params.size(); ++j) {
+    for (tcapint k = 0U; k < parallel_grads[j].size(); ++k) {
+      REQUIRE(parallel_grads[j][k] == Approx(flat_real(params[j]->grad, k)));
+    }
+  }
+
+  // Every shard sees the caller's gradient-ready hook and autograd mode.
+  std::atomic<int> ready(0);
+  {
+    GradReadyHookGuard hook_guard([&](Tensor *t) { ++ready; });
+    dp.backward(loss);
+  }
+  REQUIRE(ready == (int)(shards.size() * params.size()));
+  {
+    NoGradGuard no_grad;
+    dp.backward(loss);
+  }
+  for (const ParameterPtr &p : params) {
+    for (tcapint k = 0U; k < p->get_size(); ++k) {
+      REQUIRE(flat_real(p->grad, k) == ZERO_R1);
+    }
+  }
+}
+
+#if !defined(_WIN32)
+TEST_CASE("test_distributed_data_parallel") {
+  using namespace Weed;
+
+  const tcapint world = 3U;
+  const std::string prefix = "/tmp/weed_ring_" + std::to_string(getpid());
+  LinearPtr master = std::make_shared<Linear>(3U, 2U, true, true, DType::REAL,
+                                              DeviceTag::CPU);
+  const std::vector<std::vector<real1>> shards{
+      {R(1), R(0), R(-1), R(2), R(1), R(0)},
+      {R(-2), R(1), R(3), R(0), R(1), R(1)},
+      {R(1), R(1), R(1), R(-1), R(0), R(2)}};
+  const auto loss = [&](const ModulePtr &m, const tcapint &i) {
+    TensorPtr x = std::make_shared<Tensor>(
+        shards[i], std::vector<tcapint>{2U, 3U}, false, DeviceTag::CPU);
+    TensorPtr y = m->forward(x);
+    return Tensor::mean(y * y);
+  };
+  // The same Linear under two checkpoints, each re-entering backward
+  const CheckpointPtr ck = std::make_shared<Checkpoint>(master);
+  const auto ck_loss = [&](const ModulePtr &m, const tcapint &i) {
+    TensorPtr x = std::make_shared<Tensor>(
+        shards[i], std::vector<tcapint>{2U, 3U}, false, DeviceTag::CPU);
+    TensorPtr y = m->forward(x) + ck->forward(x);
+    return Tensor::mean(y * y);
+  };
+
+  // The hook sees each parameter once, as soon as its gradient is final.
+  std::vector<Tensor *> ready;
+  {
+    GradReadyHookGuard guard([&](Tensor *t) { ready.push_back(t); });
+    Tensor::backward(loss(master, 0U));
+  }
+  REQUIRE(ready.size() == 2U);
+  REQUIRE(std::count(ready.begin(), ready.end(), master->weight.get()) == 1);
+  REQUIRE(std::count(ready.begin(), ready.end(), master->bias.get()) == 1);
+  zero_grad(master->parameters());
+
+  // Backward inside a checkpoint is not the end of the outer graph: the
+  // gradient seen by the hook is already the final one.
+  ready.clear();
+  std::vector<real1> seen;
+  {
+    GradReadyHookGuard guard([&](Tensor *t) {
+      ready.push_back(t);
+      seen.push_back(flat_real(Tensor::sum(t->grad), 0U));
+    });
+    Tensor::backward(ck_loss(ck, 0U));
+  }
+  REQUIRE(ready.size() == 2U);
+  for (size_t j = 0U; j < ready.size(); ++j) {
+    REQUIRE(seen[j] == Approx(flat_real(Tensor::sum(ready[j]->grad), 0U)));
+  }
+  zero_grad(master->parameters());
+
+  // Every worker (process) checks its reduced gradients against all shards,
+  // back-propagated serially. Tiny buckets exercise the overlapped path.
+  const std::vector<int> codes =
+      RingAllReduce::spawn(world, [&](const tcapint &rank) {
+        const std::vector<ParameterPtr> params = master->parameters();
+        for (const bool is_ck : {false, true}) {
+          const auto f = [&](const tcapint &i) {
+            return is_ck ? ck_loss(ck, i) : loss(master, i);
+          };
+          zero_grad(params);
+          DistributedDataParallel ddp(
+              master,
+              std::make_shared<RingAllReduce>(prefix + (is_ck ? "_ck" : ""),
+                                              rank, world),
+              2U);
+          ddp.backward(f(rank));
+
+          std::vector<std::vector<real1>> reduced;
+          for (const ParameterPtr &p : params) {
+            std::vector<real1> g(p->get_size());
+            for (tcapint k = 0U; k < g.size(); ++k) {
+              g[k] = flat_real(p->grad, k);
+            }
+            reduced.push_back(g);
+          }
+
+          zero_grad(params);
+          for (tcapint i = 0U; i < world; ++i) {
+            Tensor::backward((ONE_R1 / world) * f(i));
+          }
+          for (size_t j = 0U; j < params.size(); ++j) {
+            for (tcapint k = 0U; k < reduced[j].size(); ++k) {
+              const real1 e = flat_real(params[j]->grad, k);
+              if (std::abs(reduced[j][k] - e) > R(1e-4)) {
+                throw std::domain_error("Reduced gradient mismatch!");
+              }
+            }
+          }
+        }
+      });
+  REQUIRE(codes == std::vector<int>(world, 0));
+
+  // A crashed worker makes its peers fail (after the timeout), not hang, and
+  // the launching process survives.
+  const std::vector<int> crashed =
+      RingAllReduce::spawn(world, [&](const tcapint &rank) {
+        if (rank == 1U) {
+          _exit(7);
+        }
+        RingAllReduce ring(prefix + "_crash", rank, world, 500);
+        real1 v = ONE_R1;
+        ring.allreduce(&v, 1U);
+      });
+  REQUIRE(crashed == std::vector<int>{1, 7, 1});
+}
+#endif
+
+TEST_CASE("test_fused_cross_entropy") {
+  using namespace Weed;
+
+  const tcapint T = 3U;
+  const tcapint V = 5U;
+  std::vector<real1> lv(T * V);
+  for (tcapint i = 0U; i < lv.size(); ++i) {
+    lv[i] = R(0.25) * (real1)((i * 7U) % 11U) - R(1);
+  }
+  const std::vector<symint> tv{4, 0, 2};
+
+  TensorPtr a = std::make_shared<Tensor>(lv, std::vector<tcapint>{1U, T, V},
+                                         true, DeviceTag::CPU);
+  SymbolTensorPtr targets = std::make_shared<SymbolTensor>(
+      tv, std::vector<tcapint>{T}, false, DeviceTag::CPU);
+  REQUIRE(can_cross_entropy(*a, *targets));
+  TensorPtr loss = cross_entropy_loss(a, targets);
+  Tensor::backward(loss);
+
+  // Reference: loss = mean(lse - x[target]), dx = (softmax - onehot) / T
+  real1 expected = ZERO_R1;
+  for (tcapint t = 0U; t < T; ++t) {
+    real1 s = ZERO_R1;
+    for (tcapint v = 0U; v < V; ++v) {
+      s += std::exp(lv[t + v * T]);
+    }
+    const real1 lse = std::log(s);
+    expected += (lse - lv[t + tv[t] * T]) / T;
+    for (tcapint v = 0U; v < V; ++v) {
+      const real1 onehot = (v == (tcapint)tv[t]) ? ONE_R1 : ZERO_R1;
+      REQUIRE(flat_real(a->grad, t + v * T) ==
+              Approx((std::exp(lv[t + v * T] - lse) - onehot) / T));
+    }
+  }
+  REQUIRE(flat_real(loss, 0U) == Approx(expected));
+
+  SymbolTensorPtr bad = std::make_shared<SymbolTensor>(
+      std::vector<symint>{4, 5, 2}, std::vector<tcapint>{T}, false,
+      DeviceTag::CPU);
+  REQUIRE_THROWS_AS(cross_entropy_loss(a, bad), std::invalid_argument);
+}
+
+TEST_CASE("test_linear_cross_entropy") {
+  using namespace Weed;
+
+  const tcapint T = 4U;
+  const tcapint I = 3U;
+  const tcapint V = 7U;
+  std::vector<real1> xv(T * I), wv(I * V), bv(V);
+  for (tcapint i = 0U; i < xv.size(); ++i) {
+    xv[i] = R(0.3) * (real1)((i * 5U) % 7U) - R(0.8);
+  }
+  for (tcapint i = 0U; i < wv.size(); ++i) {
+    wv[i] = R(0.2) * (real1)((i * 3U) % 11U) - R(1);
+  }
+  for (tcapint i = 0U; i < bv.size(); ++i) {
+    bv[i] = R(0.1) * (real1)i - R(0.3);
+  }
+  SymbolTensorPtr targets = std::make_shared<SymbolTensor>(
+      std::vector<symint>{6, 0, 3, 4}, std::vector<tcapint>{T}, false,
+      DeviceTag::CPU);
+
+  std::vector<LinearPtr> heads;
+  std::vector<TensorPtr> xs, losses;
+  for (size_t i = 0U; i < 2U; ++i) {
+    LinearPtr h = std::make_shared<Linear>(I, V, true, false, DType::REAL,
+                                           DeviceTag::CPU);
+    h->weight = std::make_shared<Parameter>(wv, std::vector<tcapint>{I, V},
+                                            DeviceTag::CPU);
+    h->bias = std::make_shared<Parameter>(bv, std::vector<tcapint>{V},
+                                          DeviceTag::CPU);
+    heads.push_back(h);
+    xs.push_back(std::make_shared<Tensor>(
+        xv, std::vector<tcapint>{1U, T, I}, true, DeviceTag::CPU));
+  }
+
+  // Chunks of 3 over a vocabulary of 7, against full logits
+  REQUIRE(can_linear_cross_entropy(*xs[0U], *heads[0U]->weight, *targets));
+  losses.push_back(linear_cross_entropy_loss(heads[0U], xs[0U], targets, 3U));
+  losses.push_back(cross_entropy_loss(heads[1U]->forward(xs[1U]), targets));
+  for (const TensorPtr &l : losses) {
+    Tensor::backward(l);
+  }
+
+  REQUIRE(flat_real(losses[0U], 0U) == Approx(flat_real(losses[1U], 0U)));
+  for (tcapint i = 0U; i < T * I; ++i) {
+    REQUIRE(flat_real(xs[0U]->grad, i) == Approx(flat_real(xs[1U]->grad, i)));
+  }
+  for (tcapint i = 0U; i < I * V; ++i) {
+    REQUIRE(flat_real(heads[0U]->weight->grad, i) ==
+            Approx(flat_real(heads[1U]->weight->grad, i)));
+  }
+  TensorPtr db = Tensor::sum(heads[1U]->bias->grad, 0);
+  for (tcapint v = 0U; v < V; ++v) {
+    REQUIRE(flat_real(heads[0U]->bias->grad, v) == Approx(flat_real(db, v)));
+  }
+}
+
+TEST_CASE("test_fused_norm") {
+  using namespace Weed;
+
+  const tcapint T = 3U;
+  const tcapint H = 5U;
+  const real1 eps = R(1e-5);
+  std::vector<real1> xv(T * H), wv(H), bv(H), dv(T * H);
+  for (tcapint i = 0U; i < xv.size(); ++i) {
+    xv[i] = R(0.3) * (real1)((i * 7U) % 11U) - R(1.2);
+    dv[i] = R(0.1) * (real1)((i * 5U) % 7U) - R(0.2);
+  }
+  for (tcapint h = 0U; h < H; ++h) {
+    wv[h] = R(0.5) + R(0.25) * (real1)h;
+    bv[h] = R(0.1) * (real1)h - R(0.2);
+  }
+  const std::vector<tcapint> shp{1U, T, H};
+  const std::vector<tcapint> fshp{1U, 1U, H};
+  TensorPtr dy = std::make_shared<Tensor>(dv, shp, false, DeviceTag::CPU);
+
+  // Fused kernels, against the composite graphs they replace
+  for (size_t layer = 0U; layer < 2U; ++layer) {
+    std::vector<TensorPtr> xs, ws, bs, ys;
+    for (size_t i = 0U; i < 2U; ++i) {
+      xs.push_back(std::make_shared<Tensor>(xv, shp, true, DeviceTag::CPU));
+      ws.push_back(std::make_shared<Tensor>(wv, fshp, true, DeviceTag::CPU));
+      bs.push_back(std::make_shared<Tensor>(bv, fshp, true, DeviceTag::CPU));
+    }
+    REQUIRE(can_fused_norm(*xs[0U], *ws[0U]));
+    if (layer) {
+      ys.push_back(Tensor::layer_norm(xs[0U], ws[0U], bs[0U], eps));
+      TensorPtr xc = xs[1U] - Tensor::mean(xs[1U], -1);
+      ys.push_back(xc / ((Tensor::mean(xc * xc, -1) + eps) ^ R(0.5)) *
+                       ws[1U] +
+                   bs[1U]);
+    } else {
+      ys.push_back(Tensor::rms_norm(xs[0U], ws[0U], eps));
+      ys.push_back((xs[1U] / ((Tensor::mean(xs[1U] * xs[1U], -1) + eps) ^
+                              R(0.5))) *
+                   ws[1U]);
+    }
+    for (const TensorPtr &y : ys) {
+      Tensor::backward(Tensor::sum(y * dy));
+    }
+
+    for (tcapint i = 0U; i < T * H; ++i) {
+      REQUIRE(flat_real(ys[0U], i) == Approx(flat_real(ys[1U], i)));
+      REQUIRE(flat_real(xs[0U]->grad, i) ==
+              Approx(flat_real(xs[1U]->grad, i)).margin(1e-5));
+    }
+    for (tcapint h = 0U; h < H; ++h) {
+      REQUIRE(flat_real(ws[0U]->grad, h) == Approx(flat_real(ws[1U]->grad, h)));
+      if (layer) {
+        REQUIRE(flat_real(bs[0U]->grad, h) ==
+                Approx(flat_real(bs[1U]->grad, h)));
+      }
+    }
+  }
+
+  // A row broadcast over T isn't fused, but normalizes like its dense copy.
+  RMSNorm norm(H);
+  TensorPtr xb = std::make_shared<Tensor>(
+      std::vector<real1>(xv.begin(), xv.begin() + H), fshp, false,
+      DeviceTag::CPU);
+  xb->shape[1U] = T;
+  xb->stride[1U] = 0U;
+  std::vector<real1> xd(T * H);
+  for (tcapint i = 0U; i < xd.size(); ++i) {
+    xd[i] = xv[i / T];
+  }
+  REQUIRE(!can_fused_norm(*xb, *(norm.weight)));
+  TensorPtr yb = norm.forward(xb);
+  TensorPtr yd =
+      norm.forward(std::make_shared<Tensor>(xd, shp, false, DeviceTag::CPU));
+  for (tcapint i = 0U; i < T * H; ++i) {
+    REQUIRE(flat_real(yb, i) == Approx(flat_real(yd, i)));
+  }
+}
+
+TEST_CASE("test_fused_swiglu") {
+  using namespace Weed;
+
+  const tcapint T = 3U;
+  const tcapint I = 4U;
+  const tcapint H = 5U;
+  std::vector<real1> xv(T * H), gv(H * I), uv(H * I), dv(T * I);
+  for (tcapint i = 0U; i < xv.size(); ++i) {
+    xv[i] = R(0.3) * (real1)((i * 7U) % 11U) - R(1.2);
+  }
+  for (tcapint i = 0U; i < gv.size(); ++i) {
+    gv[i] = R(0.2) * (real1)((i * 3U) % 7U) - R(0.6);
+    uv[i] = R(0.1) * (real1)((i * 5U) % 9U) - R(0.4);
+  }
+  for (tcapint i = 0U; i < dv.size(); ++i) {
+    dv[i] = R(0.1) * (real1)((i * 5U) % 7U) - R(0.2);
+  }
+  TensorPtr dy = std::make_shared<Tensor>(dv, std::vector<tcapint>{1U, T, I},
+                                          false, DeviceTag::CPU);
+
+  // Fused op, against the composite graph it replaces
+  std::vector<TensorPtr> xs, wgs, wus, ys;
+  for (size_t i = 0U; i < 2U; ++i) {
+    xs.push_back(std::make_shared<Tensor>(
+        xv, std::vector<tcapint>{1U, T, H}, true, DeviceTag::CPU));
+    wgs.push_back(std::make_shared<Tensor>(gv, std::vector<tcapint>{H, I},
+                                           true, DeviceTag::CPU));
+    wus.push_back(std::make_shared<Tensor>(uv, std::vector<tcapint>{H, I},
+                                           true, DeviceTag::CPU));
+  }
+  REQUIRE(can_swiglu(*xs[0U], *wgs[0U], *wus[0U]));
+  ys.push_back(Tensor::swiglu(xs[0U], wgs[0U], wus[0U]));
+  TensorPtr gate = xs[1U] >> wgs[1U];
+  ys.push_back(gate * Tensor::sigmoid(gate) * (xs[1U] >> wus[1U]));
+  for (const TensorPtr &y : ys) {
+    Tensor::backward(Tensor::sum(y * dy));
+  }
+
+  REQUIRE(ys[0U]->shape == ys[1U]->shape);
+  for (tcapint i = 0U; i < T * I; ++i) {
+    REQUIRE(flat_real(ys[0U], i) == Approx(flat_real(ys[1U], i)));
+  }
+  for (tcapint i = 0U; i < T * H; ++i) {
+    REQUIRE(flat_real(xs[0U]->grad, i) ==
+            Approx(flat_real(xs[1U]->grad, i)).margin(1e-5));
+  }
+  for (tcapint i = 0U; i < H * I; ++i) {
+    REQUIRE(flat_real(wgs[0U]->grad, i) ==
+            Approx(flat_real(wgs[1U]->grad, i)).margin(1e-5));
+    REQUIRE(flat_real(wus[0U]->grad, i) ==
+            Approx(flat_real(wus[1U]->grad, i)).margin(1e-5));
+  }
+}
+
+TEST_CASE("test_fused_rope") {
+  using namespace Weed;
+
+  const tcapint H = 2U;
+  const tcapint T = 3U;
+  const tcapint D = 4U;
+  const tcapint pos = 2U;
+  RoPE rope(D, 8U);
+  std::vector<real1> xv(H * T * D), dv(H * T * D);
+  for (tcapint i = 0U; i < xv.size(); ++i) {
+    xv[i] = R(0.3) * (real1)((i * 7U) % 11U) - R(1.2);
+    dv[i] = R(0.1) * (real1)((i * 5U) % 7U) - R(0.2);
+  }
+  const std::vector<tcapint> shp{1U, H, T, D};
+  TensorPtr dy = std::make_shared<Tensor>(dv, shp, false, DeviceTag::CPU);
+
+  // Fused op at an offset, against the composite graph from the same tables
+  TensorPtr x = std::make_shared<Tensor>(xv, shp, true, DeviceTag::CPU);
+  REQUIRE(can_rope(*x, *rope.cos_table, *rope.sin_table, pos));
+  TensorPtr y = rope.forward(x, pos);
+  TensorPtr c = Tensor::reshape(Tensor::slice(rope.cos_table, 0, pos, T),
+                                {1, 1, (symint)T, (symint)D});
+  TensorPtr s = Tensor::reshape(Tensor::slice(rope.sin_table, 0, pos, T),
+                                {1, 1, (symint)T, (symint)D});
+  TensorPtr ref = x * c + rope._rotate_half(x) * s;
+  for (tcapint i = 0U; i < xv.size(); ++i) {
+    REQUIRE(flat_real(y, i) == Approx(flat_real(ref, i)));
+  }
+
+  // The rotation is linear, so dx = R^T * dy is exact by unit perturbation.
+  Tensor::backward(Tensor::sum(y * dy));
+  const auto dot = [&](const std::vector<real1> &v) {
+    TensorPtr ry = rope.forward(
+        std::make_shared<Tensor>(v, shp, false, DeviceTag::CPU), pos);
+    real1 sum = ZERO_R1;
+    for (tcapint i = 0U; i < v.size(); ++i) {
+      sum += flat_real(ry, i) * dv[i];
+    }
+    return sum;
+  };
+  for (tcapint i = 0U; i < xv.size(); ++i) {
+    std::vector<real1> e(xv.size(), ZERO_R1);
+    e[i] = ONE_R1;
+    REQUIRE(flat_real(x->grad, i) == Approx(dot(e)));
+  }
+
+  // Decoding the last token alone must match its row in the full sequence.
+  TensorPtr full = rope.forward(
+      std::make_shared<Tensor>(xv, shp, false, DeviceTag::CPU), 0U);
+  TensorPtr last = Tensor::slice(
+      std::make_shared<Tensor>(xv, shp, false, DeviceTag::CPU), 2, T - 1U, 1U);
+  TensorPtr step = rope.forward(Tensor::contiguous(last), T - 1U);
+  TensorPtr want = Tensor::slice(full, 2, T - 1U, 1U);
+  for (tcapint i = 0U; i < (H * D); ++i) {
+    REQUIRE(flat_real(step, i) == Approx(flat_real(want, i)));
+  }
+
+  REQUIRE_THROWS_AS(rope.forward(x, 6U), std::invalid_argument);
+}
+
+TEST_CASE("test_rnn_sequence") {
+  using namespace Weed;
+
+  const tcapint B = 2U;
+  const tcapint T = 3U;
+  const tcapint I = 3U;
+  const tcapint H = 2U;
+  const std::vector<tcapint> xshp{B, T, I};
+  const std::vector<tcapint> yshp{B, T, H};
+  std::vector<real1> xv(B * T * I), dv(B * T * H);
+  for (tcapint i = 0U; i < xv.size(); ++i) {
+    xv[i] = R(0.3) * (real1)((i * 7U) % 11U) - R(1.2);
+  }
+  for (tcapint i = 0U; i < dv.size(); ++i) {
+    dv[i] = R(0.1) * (real1)((i * 5U) % 7U) - R(0.2);
+  }
+  const TensorPtr dy =
+      std::make_shared<Tensor>(dv, yshp, false, DeviceTag::CPU);
+
+  for (size_t gru = 0U; gru < 2U; ++gru) {
+    ModulePtr m;
+    if (gru) {
+      m = std::make_shared<GRU>(I, H, DeviceTag::CPU);
+    } else {
+      m = std::make_shared<LSTM>(I, H, DeviceTag::CPU);
+    }
+    std::stringstream ss;
+    m->save(ss);
+    const std::string blob = ss.str();
+
+    TensorPtr x = std::make_shared<Tensor>(xv, xshp, true, DeviceTag::CPU);
+    TensorPtr y = m->forward(x);
+    REQUIRE(y->shape == yshp);
+    Tensor::backward(Tensor::sum(y * dy));
+
+    // Forward: one step at a time through a copy of the module
+    std::istringstream is(blob);
+    ModulePtr ms = Module::load(is);
+    for (tcapint t = 0U; t < T; ++t) {
+      std::vector<real1> xt(B * I);
+      for (tcapint i = 0U; i < (B * I); ++i) {
+        xt[i] = xv[(i % B) + t * B + (i / B) * B * T];
+      }
+      TensorPtr h = ms->forward(std::make_shared<Tensor>(
+          xt, std::vector<tcapint>{B, I}, false, DeviceTag::CPU));
+      for (tcapint i = 0U; i < (B * H); ++i) {
+        REQUIRE(flat_real(y, (i % B) + t * B + (i / B) * B * T) ==
+                Approx(flat_real(h, i)));
+      }
+    }
+
+    // Backward through time: central differences of sum(y * dy), on a fresh
+    // copy of the module per evaluation (x, or parameter p at i, moved by d)
+    const auto loss = [&](std::vector<real1> in, const size_t &p,
+                          const tcapint &i, const real1 &d) {
+      std::istringstream cs(blob);
+      ModulePtr c = Module::load(cs);
+      if (p < c->parameters().size()) {
+        RealStorage &st = *static_cast<RealStorage *>(
+            c->parameters()[p]->storage.get());
+        st.write(i, st[i] + d);
+      } else {
+        in[i] += d;
+      }
+      TensorPtr o = c->forward(
+          std::make_shared<Tensor>(in, xshp, false, DeviceTag::CPU));
+      return flat_real(Tensor::sum(o * dy), 0U);
+    };
+    const real1 eps = R(0.01);
+    const std::vector<ParameterPtr> params = m->parameters();
+    for (tcapint i = 0U; i < xv.size(); ++i) {
+      const real1 fd = (loss(xv, params.size(), i, eps) -
+                        loss(xv, params.size(), i, -eps)) /
+                       (2 * eps);
+      REQUIRE(flat_real(x->grad, i) == Approx(fd).margin(2e-3));
+    }
+    for (size_t p = 0U; p < params.size(); ++p) {
+      for (tcapint i = 0U; i < params[p]->get_size(); ++i) {
+        const real1 fd =
+            (loss(xv, p, i, eps) - loss(xv, p, i, -eps)) / (2 * eps);
+        REQUIRE(flat_real(params[p]->grad, i) == Approx(fd).margin(2e-3));
+      }
+    }
+  }
+}
+
+TEST_CASE("test_philox_dropout") {
+  using namespace Weed;
+
+  // Philox4x32-10 known answer (Random123, zero counter and key)
+  const Philox4x32::Block z =
+      Philox4x32::generate(Philox4x32::Block{{0U, 0U, 0U, 0U}}, 0U, 0U);
+  REQUIRE(z[0U] == 0x6627e8d5U);
+  REQUIRE(z[1U] == 0xe169c58dU);
+  REQUIRE(z[2U] == 0xbc57ac4cU);
+  REQUIRE(z[3U] == 0x9b00dbd8U);
+
+  const tcapint N = 1000U;
+  const real1 p = R(0.25);
+  const std::vector<tcapint> shp{10U, 100U};
+  std::vector<real1> xv(N);
+  for (tcapint i = 0U; i < N; ++i) {
+    xv[i] = R(0.01) * (real1)i + ONE_R1;
+  }
+
+  Dropout d(p, 1234U);
+  TensorPtr x = std::make_shared<Tensor>(xv, shp, true, DeviceTag::CPU);
+  TensorPtr y = d.forward(x);
+  Tensor::backward(Tensor::sum(y));
+
+  // The mask is the bitmask of stream 0, scaled by 1 / (1 - p), forward and
+  // backward alike
+  const std::vector<uint64_t> bits = dropout_mask(N, p, 1234U, 0U);
+  tcapint kept = 0U;
+  for (tcapint i = 0U; i < N; ++i) {
+    const bool k = (bits[i >> 6U] >> (i & 63U)) & 1U;
+    kept += k ? 1U : 0U;
+    const real1 m = k ? (ONE_R1 / (ONE_R1 - p)) : ZERO_R1;
+    REQUIRE(flat_real(y, i) == Approx(xv[i] * m));
+    REQUIRE(flat_real(x->grad, i) == Approx(m));
+  }
+  REQUIRE(kept > 700U);
+  REQUIRE(kept < 800U);
+
+  // The next call draws a fresh mask; reseeding replays the sequence.
+  TensorPtr y1 = d.forward(x);
+  d.set_seed(1234U);
+  TensorPtr y0 = d.forward(x);
+  TensorPtr y2 = d.forward(x);
+  bool same = true;
+  for (tcapint i = 0U; i < N; ++i) {
+    REQUIRE(flat_real(y0, i) == flat_real(y, i));
+    REQUIRE(flat_real(y2, i) == flat_real(y1, i));
+    same = same && (flat_real(y1, i) == flat_real(y, i));
+  }
+  REQUIRE(!same);
+
+  // A row broadcast over the batch isn't fused, but draws the same mask.
+  TensorPtr xb = std::make_shared<Tensor>(
+      std::vector<real1>(xv.begin(), xv.begin() + 100U),
+      std::vector<tcapint>{1U, 100U}, false, DeviceTag::CPU);
+  xb->shape[0U] = 10U;
+  REQUIRE(xb->is_broadcast());
+  REQUIRE(!can_dropout(*xb));
+  d.set_seed(1234U);
+  TensorPtr yb = d.forward(xb);
+  for (tcapint i = 0U; i < N; ++i) {
+    const bool k = (bits[i >> 6U] >> (i & 63U)) & 1U;
+    const real1 m = k ? (ONE_R1 / (ONE_R1 - p)) : ZERO_R1;
+    REQUIRE(flat_real(yb, i) == Approx(xv[i / 10U] * m));
+  }
+}